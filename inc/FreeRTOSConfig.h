@@ -45,6 +45,11 @@
 #include <stdint.h>
 extern uint32_t SystemCoreClock;
 
+/* Run time stats are counted by run_time_stats.c. */
+extern void rtStatsStartCounter( void );
+extern uint64_t rtStatsGetCounter( void );
+extern uint32_t rtStatsReadCounter( void );
+
 /* The following definition allows the startup files that ship with the IDE
 to be used without modification when the chip used includes the PMU CM001
 errata. */
@@ -58,7 +63,6 @@ errata. */
 #define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES					( 5 )
 #define configMINIMAL_STACK_SIZE				( ( unsigned short ) 130 )
-#define configTOTAL_HEAP_SIZE					( ( size_t ) ( 22800 ) )
 #define configMAX_TASK_NAME_LEN					( 10 )
 #define configUSE_TRACE_FACILITY				1
 #define configUSE_16_BIT_TICKS					0
@@ -66,11 +70,32 @@ errata. */
 #define configUSE_MUTEXES						1
 #define configQUEUE_REGISTRY_SIZE				8
 #define configCHECK_FOR_STACK_OVERFLOW			2
+#define configRECORD_STACK_HIGH_ADDRESS			1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	4
 #define configUSE_RECURSIVE_MUTEXES				1
-#define configUSE_MALLOC_FAILED_HOOK			1
+#define configUSE_MALLOC_FAILED_HOOK			0
 #define configUSE_APPLICATION_TASK_TAG			0
 #define configUSE_COUNTING_SEMAPHORES			1
-#define configGENERATE_RUN_TIME_STATS			0
+#define configGENERATE_RUN_TIME_STATS			1
+#define configRUN_TIME_COUNTER_TYPE				uint64_t
+#define configUSE_QUEUE_ZERO_COPY				1
+#define configUSE_QUEUE_STATS					1
+#define configUSE_STREAM_BUFFER_MULTI_PRODUCER	0
+#define configUSE_BUCKETED_EVENT_LISTS			1
+#define configUSE_EVENT_GROUP_DIRECT_ISR		1
+
+/* The delayed task wheel only pays off with hundreds of tasks blocked with a
+timeout, this application has five tasks.  See
+tools/bench/delayed_wheel_bench.c. */
+#define configUSE_DELAYED_TASK_WHEEL			0
+
+/* Every task, queue and timer is created in static storage sized at build
+time, there is no heap.  The application's queues share an arena owned by
+queue_tuner.c, the idle and timer tasks' memory is given by main.c.  A build
+that turns dynamic allocation back on links portable/MemMang/heap_pool.c and
+sets configTOTAL_HEAP_SIZE to hold its pools. */
+#define configSUPPORT_STATIC_ALLOCATION			1
+#define configSUPPORT_DYNAMIC_ALLOCATION		0
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		0
@@ -82,6 +107,10 @@ errata. */
 #define configTIMER_QUEUE_LENGTH		5
 #define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE * 2 )
 
+/* The timer wheel only pays off with hundreds of active timers, this
+application has two.  See tools/bench/timer_wheel_bench.c. */
+#define configUSE_TIMER_WHEEL			0
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 #define INCLUDE_vTaskPrioritySet		1
@@ -91,6 +120,18 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetSchedulerState	1
+#define INCLUDE_xTimerPendFunctionCall	1
+
+/* Run time stats counter, CPU cycles extended to 64 bits. */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()	rtStatsStartCounter()
+#define portGET_RUN_TIME_COUNTER_VALUE()			rtStatsGetCounter()
+
+/* Queue statistics are timed on the cycle counter.  The first latency bucket
+is under 1024 cycles, around 8us, and the last starts at around 35ms. */
+#define configQUEUE_STATS_TIMESTAMP()				rtStatsReadCounter()
+#define configQUEUE_STATS_HISTOGRAM_BUCKETS		14
+#define configQUEUE_STATS_HISTOGRAM_SHIFT		10
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -163,6 +204,8 @@ standard names. */
 	#error Part number not specified in project options
 #endif
 
+/* The kernel trace macros are implemented by the application's trace recorder. */
+#include "trace_recorder.h"
 
 #endif /* FREERTOS_CONFIG_H */
 
@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  coroutine.h
+//
+//  Stackless Coroutines
+//
+//  Runs protocol flows, such as an EEPROM stream session or an AT command sequence, as sequential
+//  code that waits on events, queues and timeouts, without giving each flow its own task and
+//  stack. Every coroutine runs on the one coroutine task's stack. A coroutine is a function that
+//  returns whenever it waits and is called again to resume, CORO_BEGIN() jumps back to the line it
+//  was waiting at. All a coroutine keeps between calls is its coroutine_t, a few tens of bytes.
+//
+//  The EEPROM stream sessions are the only flows run this way so far. The modem's AT command
+//  sequences and the message handler's serial sessions still run on their own tasks.
+//
+//  Local variables don't keep their values across a wait, anything needed after one lives in the
+//  context or at file scope. A coroutine can't wait inside a switch statement or in a function it
+//  calls, only in its own body. Nor should it call anything that blocks, that stalls every other
+//  coroutine with it. A slow device is stepped and waited on with CORO_DELAY() instead, as the
+//  EEPROM stream does with eepromWriteStep().
+//
+//  A waiting coroutine is only run again when it is signalled or its timeout ends. Events are set
+//  with coroSignal(), from a task or an interrupt. A coroutine waiting on a queue or anything else
+//  of its own is retried whenever it is signalled, so whatever fills the queue signals it, the same
+//  way a task is notified.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Resume point of a coroutine that has not started, and of one that has finished
+#define CORO_RESUME_START               0
+#define CORO_RESUME_DONE                UINT16_MAX
+
+// Starts the body of a coroutine, resuming it where it last waited
+#define CORO_BEGIN(p_co)                switch((p_co)->resume) { case CORO_RESUME_START:
+
+// Ends the body of a coroutine, it is removed from the coroutine task once it gets here
+#define CORO_END(p_co)                  } (p_co)->resume = CORO_RESUME_DONE; return
+
+// Waits until cond is true, checking it every time the coroutine is signalled, or until timeout
+// ticks have passed, portMAX_DELAY to wait forever. cond is checked straight away, the coroutine
+// doesn't give way at all if it is already true. Check CORO_TIMED_OUT() afterwards.
+#define CORO_WAIT_UNTIL(p_co, cond, timeout)                                    \
+    coroPrepareWait((p_co), (timeout));                                         \
+    (p_co)->resume = __LINE__; __attribute__((fallthrough)); case __LINE__:     \
+    if(!(cond))                                                                 \
+    {                                                                           \
+        if(!coroWaitExpired(p_co))                                              \
+        {                                                                       \
+            return;                                                             \
+        }                                                                       \
+        (p_co)->timed_out = true;                                               \
+    }
+
+// Waits for any of the events, the ones that were signalled are cleared and written to *p_taken
+#define CORO_WAIT_EVENTS(p_co, events, p_taken, timeout)                        \
+    CORO_WAIT_UNTIL((p_co), (*(p_taken) = coroTakeEvents((p_co), (events))) != 0, (timeout))
+
+// Waits for an item from a queue, whoever sends to the queue must signal the coroutine
+#define CORO_WAIT_RECEIVE(p_co, queue, p_item, timeout)                         \
+    CORO_WAIT_UNTIL((p_co), xQueueReceive((queue), (p_item), 0) == pdTRUE, (timeout))
+
+#define CORO_DELAY(p_co, ticks)         CORO_WAIT_UNTIL((p_co), false, (ticks))
+
+// Gives way to the other coroutines and carries on once they have each had a turn
+#define CORO_YIELD(p_co)                                                        \
+    (p_co)->run = true;                                                         \
+    (p_co)->resume = __LINE__; return; case __LINE__:
+
+#define CORO_TIMED_OUT(p_co)            ((p_co)->timed_out)
+
+/* ****************************   Structures   **************************** */
+
+typedef struct coroutine coroutine_t;
+
+typedef void (*coroFn_t)(coroutine_t *p_co);
+
+struct coroutine
+{
+    coroutine_t *p_next;            // Next coroutine in the coroutine task's list
+    coroFn_t fn;
+    void *p_context;
+    volatile uint32_t events;       // Signalled and not yet taken
+    TickType_t wait_start;          // Tick count when the current wait started
+    TickType_t wait_ticks;          // Length of the current wait, portMAX_DELAY for no timeout
+    uint16_t resume;                // Line to resume at
+    volatile bool run;              // Run on the coroutine task's next pass
+    bool timed_out;                 // The last wait ended without its condition becoming true
+};
+
+/* ***********************   Function Prototypes   ************************ */
+
+void coroInit(const int task_priority);
+bool coroStart(coroutine_t *p_co, coroFn_t fn, void *p_context);
+bool coroIsRunning(const coroutine_t *p_co);
+void coroSignal(coroutine_t *p_co, const uint32_t events);
+void coroSignalFromISR(coroutine_t *p_co, const uint32_t events, BaseType_t *pxHigherPriorityTaskWoken);
+
+// Used by the wait macros
+void coroPrepareWait(coroutine_t *p_co, const TickType_t timeout);
+bool coroWaitExpired(coroutine_t *p_co);
+uint32_t coroTakeEvents(coroutine_t *p_co, const uint32_t events);
+
+#endif /* COROUTINE_H */
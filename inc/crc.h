@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  crc.h
+//
+//  CRC Engine
+//
+//  Table driven CRC-16/CCITT-FALSE and CRC-32 (IEEE 802.3) shared by every module that needs an
+//  integrity check. Buffers are processed CRC_SLICE_BY bytes per table lookup round. A CRC can be
+//  calculated in one call or built up incrementally, a byte at a time from a receive interrupt if
+//  needed, with the Start/Update/Finish functions.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRC_H
+#define CRC_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Bytes consumed per lookup round, 4 or 8. Tables take (CRC_SLICE_BY * 1536) bytes of flash.
+#ifndef CRC_SLICE_BY
+#define CRC_SLICE_BY                    4
+#endif
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+uint16_t crc16Start(void);
+uint16_t crc16Update(uint16_t crc, const uint8_t *p_bytes, unsigned int num_bytes);
+uint16_t crc16UpdateByte(const uint16_t crc, const uint8_t byte);
+uint16_t crc16Finish(const uint16_t crc);
+uint16_t crc16Calc(const uint8_t *p_bytes, const unsigned int num_bytes);
+
+uint32_t crc32Start(void);
+uint32_t crc32Update(uint32_t crc, const uint8_t *p_bytes, unsigned int num_bytes);
+uint32_t crc32UpdateByte(const uint32_t crc, const uint8_t byte);
+uint32_t crc32Finish(const uint32_t crc);
+uint32_t crc32Calc(const uint8_t *p_bytes, const unsigned int num_bytes);
+
+#endif /* CRC_H */
@@ -37,13 +37,53 @@
 
 /* ***************************   Definitions   **************************** */
 
+// Total size of the EEPROM part (25xx512 class device)
+#define EEPROM_SIZE_BYTES           (64 * 1024)
+
+// Size of a single write page, writes must not cross a page boundary
+#define EEPROM_PAGE_SIZE            128
+
 /* ****************************   Structures   **************************** */
 
+typedef enum
+{
+    // Every page in the range is programmed
+    E_EEPROM_WRITE_ALWAYS = 0,
+
+    // Each page is read back first and only programmed if its contents differ
+    E_EEPROM_WRITE_SKIP_UNCHANGED
+}eepromWriteMode_t;
+
+typedef enum
+{
+    E_EEPROM_WRITE_BUSY = 0,            // Waiting for the part or for a write cycle, step again later
+    E_EEPROM_WRITE_DONE,
+    E_EEPROM_WRITE_FAILED
+}eepromWriteResult_t;
+
+// A write run a step at a time by eepromWriteStep(), for callers that must not block while the
+// part is busy. The bytes must stay valid until the write is done or has failed.
+typedef struct
+{
+    uint32_t addr;
+    const uint8_t *bytes;
+    unsigned int num_bytes;
+    unsigned int offset;                // Bytes programmed so far, including the page in its write cycle
+    uint32_t cycle_start;               // Cycle counter when the current write cycle started
+    bool locked;                        // Holds the EEPROM lock, from the first page to the last write cycle
+    bool in_cycle;                      // A write cycle is running
+}eepromWriteJob_t;
+
 /* ***********************   Function Prototypes   ************************ */
 
 void eepromInit(void);
+void eepromSetWriteMode(const eepromWriteMode_t mode);
 
 bool eepromReadBytes(const uint32_t addr, uint8_t *bytes, const unsigned int num_bytes);
 bool eepromWriteBytes(const uint32_t addr, uint8_t *bytes, const unsigned int num_bytes);
 
+void eepromWriteStart(eepromWriteJob_t *p_job, const uint32_t addr, const uint8_t *bytes,
+                      const unsigned int num_bytes);
+eepromWriteResult_t eepromWriteStep(eepromWriteJob_t *p_job);
+
 #endif /* EEPROM_H */
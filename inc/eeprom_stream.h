@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  eeprom_stream.h
+//
+//  EEPROM Stream
+//
+//  Dumps the EEPROM contents over a serial port, or restores them, as a stream of CRC protected
+//  frames. Two frame buffers are used so the EEPROM read for the next frame overlaps with the UART
+//  transmission of the current one. Every frame carries its EEPROM offset so an interrupted
+//  transfer can be restarted from the last good offset. Dumps and restores run as coroutines on the
+//  coroutine task rather than on a task of their own.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef EEPROM_STREAM_H
+#define EEPROM_STREAM_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Payload carried by a single frame, two EEPROM pages
+#define EEPROM_STREAM_CHUNK_SIZE        256
+
+// First two bytes of every frame
+#define EEPROM_STREAM_SYNC              0x5AA5
+
+/* ****************************   Structures   **************************** */
+
+// Frame layout on the wire, the header is followed by num_bytes of payload. A frame with no
+// payload marks the end of the stream.
+typedef struct
+{
+    uint16_t sync;
+    uint16_t num_bytes;
+    uint32_t offset;        // EEPROM address of the first payload byte
+    uint16_t crc;           // CRC-16 of the header, with this field zero, and the payload
+    uint16_t reserved;
+}eepromStreamHeader_t;
+
+typedef struct
+{
+    eepromStreamHeader_t header;
+    uint8_t data[EEPROM_STREAM_CHUNK_SIZE];
+}eepromStreamFrame_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void eepromStreamInit(void);
+
+bool eepromStreamStartExport(const int uart, const uint32_t start_offset);
+bool eepromStreamStartImport(const int uart, const uint32_t start_offset);
+bool eepromStreamIsActive(const int uart);
+
+bool eepromStreamRxByteFromISR(const int uart, const uint8_t byte, BaseType_t *pxHigherPriorityTaskWoken);
+
+#endif /* EEPROM_STREAM_H */
@@ -5,7 +5,8 @@
 //  Message Handler
 //
 //  Receives data from the modem and routes the messages to external data interfaces or saves data
-//  to an EEPROM.
+//  to an EEPROM. Messages from the serial interfaces and the modem are handled one at a time, in
+//  the order they arrived.
 //
 // The MIT License (MIT)
 //
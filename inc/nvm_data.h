@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  nvm_data.h
+//
+//  NVM Data Manager
+//
+//  Stores data records in the EEPROM as an append-only log of fixed size slots. A RAM index maps
+//  each record ID to the slot holding its newest copy. The index is periodically checkpointed to a
+//  reserved region at the start of the EEPROM, so at boot only the log written since the last
+//  checkpoint has to be replayed instead of scanning the whole part.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef NVM_DATA_H
+#define NVM_DATA_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Number of distinct record IDs tracked by the index
+#define NVM_DATA_MAX_RECORD_IDS         32
+
+// Record IDs kept for the device's own settings rather than message data
+#define NVM_DATA_RECORD_ID_QUEUE_TUNER  (NVM_DATA_MAX_RECORD_IDS - 1)
+
+// Max payload size of a single record
+#define NVM_DATA_RECORD_MAX_SIZE        24
+
+// Number of record writes between index checkpoints, bounds the log replayed at boot
+#define NVM_DATA_CHECKPOINT_INTERVAL    16
+
+/* ****************************   Structures   **************************** */
+
+// Describes the work done by nvmDataInit() to rebuild the index
+typedef struct
+{
+    bool checkpoint_used;       // False if no valid checkpoint was found and the full log was scanned
+    uint32_t slots_scanned;     // Number of log slots read back from the EEPROM
+}nvmDataBootStats_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void nvmDataInit(void);
+
+bool nvmDataWriteRecord(const uint8_t record_id, const uint8_t *p_data, const unsigned int num_bytes);
+bool nvmDataReadRecord(const uint8_t record_id, uint8_t *p_data, const unsigned int max_bytes,
+                       unsigned int *p_num_bytes);
+
+void nvmDataGetBootStats(nvmDataBootStats_t *p_stats);
+
+#endif /* NVM_DATA_H */
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  queue_tuner.h
+//
+//  Queue Depth Tuner
+//
+//  Sizes the application's message queues from a shared memory budget instead of fixed
+//  constants. Each queue is registered as it is created and is given the number of items it
+//  learned it needed on previous runs, or its default the first time. While running, the tuner
+//  samples each queue's high-water mark and the number of times a producer found it full. A queue
+//  that filled up is given another item, a queue that never came close to full gives one back, as
+//  long as the total fits the budget. The new sizing is saved to the EEPROM and used from the next
+//  boot, queues are never resized while interrupts are writing into them.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef QUEUE_TUNER_H
+#define QUEUE_TUNER_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Set to 0 to always create the queues with their default sizes
+#define QUEUE_TUNER_LEARN               1
+
+// Max number of queues sharing the budget
+#define QUEUE_TUNER_MAX_QUEUES          6
+
+// Bytes of item storage shared by all the queues
+#define QUEUE_TUNER_BUDGET_BYTES        1024
+
+// The queues' storage is taken from a static arena holding the budget, plus what the queues need
+// beyond their items: the spare slot of each channel, timestamps for queue statistics and padding
+#define QUEUE_TUNER_ARENA_SPARE_BYTES   256
+
+// How often the queues are sampled
+#define QUEUE_TUNER_PERIOD_MS           10000
+
+// Samples taken before a queue that never filled up can give an item back
+#define QUEUE_TUNER_SETTLE_SAMPLES      30
+
+// Items a queue keeps free above its high-water mark
+#define QUEUE_TUNER_SPARE_ITEMS         1
+
+/* ****************************   Structures   **************************** */
+
+// How a queue has been used, since it was created or since some earlier point. Either value may
+// restart from zero, whatever resets a kernel queue's statistics should pass them to
+// queueTunerQueueStatsReset() first.
+typedef struct
+{
+    uint32_t peak_items;        // Most items the queue has held at once
+    uint32_t num_full;          // Times a producer found the queue full and dropped or blocked
+}queueTunerUsage_t;
+
+typedef void (*queueTunerUsageFn_t)(void *p_context, queueTunerUsage_t *p_usage);
+
+/* ***********************   Function Prototypes   ************************ */
+
+void queueTunerInit(void);
+uint32_t queueTunerRegister(const char *p_name, const uint32_t item_bytes, const uint32_t min_items,
+                            const uint32_t default_items, queueTunerUsageFn_t usage_fn, void *p_context);
+void *queueTunerAlloc(const uint32_t num_bytes);
+void queueTunerStart(TaskHandle_t update_task, const UBaseType_t notify_index);
+void queueTunerUpdate(void);
+
+// Usage functions for the common kinds of queue, the context is the spscChannel_t or a pointer to
+// the QueueHandle_t. Kernel queues need configUSE_QUEUE_STATS.
+void queueTunerChannelUsage(void *p_context, queueTunerUsage_t *p_usage);
+#if (configUSE_QUEUE_STATS == 1)
+void queueTunerQueueUsage(void *p_context, queueTunerUsage_t *p_usage);
+void queueTunerQueueStatsReset(QueueHandle_t queue, const QueueStats_t *p_stats);
+#endif
+
+#endif /* QUEUE_TUNER_H */
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  run_time_stats.h
+//
+//  Run Time Stats
+//
+//  CPU accounting for tasks and interrupts. The kernel's run time stats are counted in CPU cycles
+//  from the core's cycle counter, extended to 64 bits so the totals never overflow, or in
+//  nanoseconds from the monotonic clock when built for a host. Each task's share of the CPU and
+//  the number of times it was switched in are reported with the time spent in every registered
+//  interrupt. A report covers the time since the previous one and is made while the scheduler
+//  keeps running.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef RUN_TIME_STATS_H
+#define RUN_TIME_STATS_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Max number of tasks in the system that can be reported on
+#define RT_STATS_MAX_TASKS              8
+
+// Max number of interrupts that can be timed
+#define RT_STATS_MAX_ISRS               6
+
+// Returned by rtStatsRegisterIsr() when no more interrupts can be added
+#define RT_STATS_ISR_INVALID            (-1)
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    const char *p_name;
+    uint32_t num_calls;         // Number of times the interrupt ran
+    uint64_t total_time;        // Total time spent in the interrupt, in run time counter counts
+    uint32_t max_time;          // Longest single run of the interrupt
+}rtStatsIsrStats_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void rtStatsInit(void);
+void rtStatsStartCounter(void);
+uint64_t rtStatsGetCounter(void);
+uint32_t rtStatsReadCounter(void);
+uint32_t rtStatsCounterHz(void);
+
+int rtStatsRegisterIsr(const char *p_name);
+uint32_t rtStatsIsrEnter(const int isr);
+void rtStatsIsrExit(const int isr, const uint32_t start);
+bool rtStatsGetIsrStats(const int isr, rtStatsIsrStats_t *p_stats);
+
+void rtStatsReport(const int uart);
+void rtStatsQueueReport(const int uart);
+void rtStatsStackReport(const int uart);
+
+#endif /* RUN_TIME_STATS_H */
@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  spi_bus.h
+//
+//  SPI Bus Arbiter
+//
+//  Shares the SPI bus between several peripheral drivers. A client acquires the bus, runs any
+//  number of transfers to its chip select, then releases it. The transfers between the two are a
+//  batch no other client can get in between, grouping them is up to the client, the bus doesn't
+//  queue or merge transfers itself. Clients waiting for the bus are queued in priority order on a
+//  mutex. The peripheral is only reconfigured when the bus passes to a different client, so back
+//  to back batches from one client skip it. Large transfers are done by DMA with the calling task
+//  blocked, smaller ones are polled. Bus time and wait time are tracked for every client.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+/* ***************************    Includes     **************************** */
+
+/* ***************************   Definitions   **************************** */
+
+// Max number of drivers sharing the bus
+#define SPI_BUS_MAX_CLIENTS             4
+
+// Transfers of at least this many bytes are done by DMA
+#define SPI_BUS_DMA_THRESHOLD           32
+
+// Returned by spiBusRegisterClient() when no more clients can be added
+#define SPI_BUS_CLIENT_INVALID          (-1)
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    const char *p_name;
+    uint32_t num_batches;       // Number of times the bus was acquired
+    uint32_t num_bytes;         // Bytes transferred in either direction
+    // Times are in run time counter cycles, see rtStatsGetCounter(), as most batches take well
+    // under a tick. A wait can outlast the 32 bit counter's wrap, so they are all 64 bit.
+    uint64_t bus_time;          // Total time the bus was held
+    uint64_t wait_time;         // Total time spent waiting for another client to release the bus
+    uint64_t max_wait_time;     // Longest single wait for the bus
+}spiBusClientStats_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void spiBusInit(void);
+int spiBusRegisterClient(const char *p_name, const int chip_select);
+
+bool spiBusAcquire(const int client, const TickType_t timeout);
+void spiBusRelease(const int client);
+
+void spiBusSelect(const int client, const bool selected);
+void spiBusWrite(const int client, const uint8_t *p_bytes, const unsigned int num_bytes);
+void spiBusRead(const int client, uint8_t *p_bytes, const unsigned int num_bytes);
+
+int spiBusGetNumClients(void);
+bool spiBusGetClientStats(const int client, spiBusClientStats_t *p_stats);
+
+#endif /* SPI_BUS_H */
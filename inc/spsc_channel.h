@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  spsc_channel.h
+//
+//  SPSC Channel
+//
+//  Fixed size ring of items passed from exactly one producer, typically an interrupt, to exactly
+//  one consumer task. Each index is only ever written by one side, so neither side needs a
+//  critical section. The producer writes an item straight into the next free slot and publishes
+//  it, the consumer reads it in place and then frees the slot. The consumer task is only notified
+//  when it has said it is about to block on an empty channel, by giving one of its indexed
+//  notifications.
+//
+//  The indices and the waiting flag are C11 atomics. Publishing an index is a release and reading
+//  the other side's index an acquire, so an item's contents are seen before the index that hands it
+//  over. Setting the waiting flag and checking the index, and publishing the index and checking the
+//  flag, are each separated by a full fence (a DMB on Cortex-M) so a wakeup can't be lost. The
+//  compiler must support <stdatomic.h> with lock free 32-bit atomics.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SPSC_CHANNEL_H
+#define SPSC_CHANNEL_H
+
+/* ***************************    Includes     **************************** */
+
+#include <stdatomic.h>
+
+/* ***************************   Definitions   **************************** */
+
+// One slot is always left empty to tell a full channel from an empty one, storage for a channel
+// holding num_items must have this many slots
+#define SPSC_CHANNEL_NUM_SLOTS(num_items)   ((num_items) + 1)
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    uint8_t *p_storage;
+    uint32_t item_size;
+    uint32_t num_slots;
+    _Atomic uint32_t write_idx;         // Next slot the producer fills, only written by the producer
+    _Atomic uint32_t read_idx;          // Next slot the consumer reads, only written by the consumer
+    atomic_bool consumer_waiting;       // Consumer is about to block and needs a notification
+    TaskHandle_t consumer_task;
+    UBaseType_t notify_index;           // Consumer task's notification given when it is waiting
+    uint32_t num_dropped;               // Items the producer dropped, only written by the producer
+    uint32_t peak_items;                // Most items the channel has held, only written by the producer
+}spscChannel_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void spscChannelInit(spscChannel_t *p_chan, void *p_storage, const uint32_t item_size,
+                     const uint32_t num_slots, TaskHandle_t consumer_task, const UBaseType_t notify_index);
+
+// Producer side
+void *spscChannelWriteSlot(spscChannel_t *p_chan);
+void spscChannelPublishFromISR(spscChannel_t *p_chan, BaseType_t *pxHigherPriorityTaskWoken);
+bool spscChannelSendFromISR(spscChannel_t *p_chan, const void *p_item, BaseType_t *pxHigherPriorityTaskWoken);
+void spscChannelDropFromISR(spscChannel_t *p_chan);
+
+// Consumer side
+void *spscChannelReadSlot(spscChannel_t *p_chan);
+void spscChannelConsume(spscChannel_t *p_chan);
+bool spscChannelPrepareToWait(spscChannel_t *p_chan);
+
+#endif /* SPSC_CHANNEL_H */
@@ -0,0 +1,217 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  trace_recorder.h
+//
+//  Binary Trace Recorder
+//
+//  Records kernel and application events into a ring of compact, timestamped binary records.
+//  Events come from the kernel trace macros, which are defined at the bottom of this file and
+//  pulled in by FreeRTOSConfig.h, from the timed interrupts through run_time_stats and from
+//  application stages. Recording is lock free, any task or interrupt can add an event with a
+//  single atomic increment and no critical section. Once full the oldest events are overwritten,
+//  so the ring always holds the latest TRACE_REC_NUM_EVENTS.
+//
+//  Each record is a 32 bit timestamp from the cycle counter, which wraps, and a header word holding
+//  the event type, the object it applies to and a 16 bit value. Tasks, queues, stream buffers,
+//  interrupts and stages are identified by small numbers, their names are kept in a separate
+//  symbol table so they only appear once in a dump. traceRecDump() writes the symbols and the
+//  events out of a serial port as text, tools/trace_decode.py turns a captured dump back into a
+//  timeline and per-queue wait times.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+/* ***************************    Includes     **************************** */
+
+// Included from FreeRTOSConfig.h, so this can't rely on the includer having these
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ***************************   Definitions   **************************** */
+
+// Events held in the ring, a power of 2. Each takes 8 bytes of RAM.
+#define TRACE_REC_NUM_EVENTS            512
+
+// Names of tasks, queues, stream buffers, interrupts and stages
+#define TRACE_REC_MAX_SYMBOLS           24
+
+// Task names are copied since a deleted task's name goes with it
+#define TRACE_REC_NAME_LEN              10
+
+// Max number of application stages
+#define TRACE_REC_MAX_STAGES            8
+
+// Returned by traceRecRegisterStage() when no more stages can be added
+#define TRACE_REC_STAGE_INVALID         (-1)
+
+// Objects created before the recorder numbered them, or past the last number, are object 0
+#define TRACE_REC_OBJECT_UNKNOWN        0
+
+/* ****************************   Structures   **************************** */
+
+// Event types, the numbers are part of the dump format shared with tools/trace_decode.py
+typedef enum
+{
+    E_TRACE_EVT_NONE = 0,               // Slot never written, or being written when dumped
+
+    // Object is a task
+    E_TRACE_EVT_TASK_CREATE,            // Value is the task's priority
+    E_TRACE_EVT_TASK_SWITCHED_IN,
+    E_TRACE_EVT_TASK_READY,             // Value is the task's priority
+    E_TRACE_EVT_TASK_NOTIFY,
+    E_TRACE_EVT_TASK_NOTIFY_FROM_ISR,
+    E_TRACE_EVT_TASK_NOTIFY_BLOCK,      // The task waits for a notification
+
+    // Object is a queue, value is the number of items in it before the operation
+    E_TRACE_EVT_QUEUE_SEND,
+    E_TRACE_EVT_QUEUE_SEND_FAILED,
+    E_TRACE_EVT_QUEUE_SEND_FROM_ISR,
+    E_TRACE_EVT_QUEUE_SEND_FROM_ISR_FAILED,
+    E_TRACE_EVT_QUEUE_RECEIVE,
+    E_TRACE_EVT_QUEUE_RECEIVE_FAILED,
+    E_TRACE_EVT_QUEUE_RECEIVE_FROM_ISR,
+    E_TRACE_EVT_QUEUE_RECEIVE_FROM_ISR_FAILED,
+    E_TRACE_EVT_QUEUE_BLOCK_SEND,       // The running task waits for space
+    E_TRACE_EVT_QUEUE_BLOCK_RECEIVE,    // The running task waits for an item
+
+    // Object is a stream or message buffer, value is the number of bytes moved, 0 if none could be
+    // sent or received
+    E_TRACE_EVT_STREAM_SEND,
+    E_TRACE_EVT_STREAM_SEND_FROM_ISR,
+    E_TRACE_EVT_STREAM_RECEIVE,
+    E_TRACE_EVT_STREAM_RECEIVE_FROM_ISR,
+    E_TRACE_EVT_STREAM_BLOCK_SEND,
+    E_TRACE_EVT_STREAM_BLOCK_RECEIVE,
+
+    // Object is an interrupt registered with run_time_stats
+    E_TRACE_EVT_ISR_ENTER,
+    E_TRACE_EVT_ISR_EXIT,
+
+    // Object is an application stage, value is up to the stage
+    E_TRACE_EVT_STAGE
+}traceRecEventType_t;
+
+// What a symbol names, the same number can be used by objects of different classes
+typedef enum
+{
+    E_TRACE_CLASS_TASK = 0,
+    E_TRACE_CLASS_QUEUE,
+    E_TRACE_CLASS_STREAM,
+    E_TRACE_CLASS_ISR,
+    E_TRACE_CLASS_STAGE
+}traceRecClass_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+void traceRecEvent(const traceRecEventType_t type, const uint8_t object, const uint16_t value);
+uint8_t traceRecNewObject(void);
+void traceRecAddSymbol(const traceRecClass_t obj_class, const uint8_t object, const char *p_name);
+
+int traceRecRegisterStage(const char *p_name);
+void traceRecStage(const int stage, const uint16_t value);
+
+void traceRecDump(const int uart);
+
+/* ***************************   Kernel Hooks   *************************** */
+
+// Expanded inside the kernel sources, where the TCB, queue and stream buffer structures and
+// pxCurrentTCB are visible. Needs configUSE_TRACE_FACILITY for the object numbers.
+
+#define traceTASK_CREATE(pxNewTCB)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        traceRecAddSymbol(E_TRACE_CLASS_TASK, (uint8_t)(pxNewTCB)->uxTCBNumber,                     \
+                          (pxNewTCB)->pcTaskName);                                                  \
+        traceRecEvent(E_TRACE_EVT_TASK_CREATE, (uint8_t)(pxNewTCB)->uxTCBNumber,                    \
+                      (uint16_t)(pxNewTCB)->uxPriority);                                            \
+    } while(0)
+
+#define traceTASK_SWITCHED_IN()                                                                     \
+    traceRecEvent(E_TRACE_EVT_TASK_SWITCHED_IN, (uint8_t)pxCurrentTCB->uxTCBNumber, 0)
+
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB)                                                       \
+    traceRecEvent(E_TRACE_EVT_TASK_READY, (uint8_t)(pxTCB)->uxTCBNumber, (uint16_t)(pxTCB)->uxPriority)
+
+#define traceTASK_NOTIFY()                                                                          \
+    traceRecEvent(E_TRACE_EVT_TASK_NOTIFY, (uint8_t)pxTCB->uxTCBNumber, 0)
+#define traceTASK_NOTIFY_FROM_ISR()                                                                 \
+    traceRecEvent(E_TRACE_EVT_TASK_NOTIFY_FROM_ISR, (uint8_t)pxTCB->uxTCBNumber, 0)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR()                                                            \
+    traceRecEvent(E_TRACE_EVT_TASK_NOTIFY_FROM_ISR, (uint8_t)pxTCB->uxTCBNumber, 0)
+#define traceTASK_NOTIFY_WAIT_BLOCK()                                                               \
+    traceRecEvent(E_TRACE_EVT_TASK_NOTIFY_BLOCK, (uint8_t)pxCurrentTCB->uxTCBNumber, 0)
+#define traceTASK_NOTIFY_TAKE_BLOCK()                                                               \
+    traceRecEvent(E_TRACE_EVT_TASK_NOTIFY_BLOCK, (uint8_t)pxCurrentTCB->uxTCBNumber, 0)
+
+// Queues, semaphores and mutexes are numbered as they are created and named when added to the
+// queue registry
+#define traceQUEUE_CREATE(pxNewQueue)                                                               \
+    ((pxNewQueue)->uxQueueNumber = traceRecNewObject())
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName)                                                \
+    traceRecAddSymbol(E_TRACE_CLASS_QUEUE, (uint8_t)(xQueue)->uxQueueNumber, (pcQueueName))
+
+#define traceRecQueueEvent(type, pxQueue)                                                           \
+    traceRecEvent((type), (uint8_t)(pxQueue)->uxQueueNumber, (uint16_t)(pxQueue)->uxMessagesWaiting)
+
+#define traceQUEUE_SEND(pxQueue)                    traceRecQueueEvent(E_TRACE_EVT_QUEUE_SEND, pxQueue)
+#define traceQUEUE_SEND_FAILED(pxQueue)             traceRecQueueEvent(E_TRACE_EVT_QUEUE_SEND_FAILED, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)           traceRecQueueEvent(E_TRACE_EVT_QUEUE_SEND_FROM_ISR, pxQueue)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(pxQueue)    traceRecQueueEvent(E_TRACE_EVT_QUEUE_SEND_FROM_ISR_FAILED, pxQueue)
+#define traceQUEUE_RECEIVE(pxQueue)                 traceRecQueueEvent(E_TRACE_EVT_QUEUE_RECEIVE, pxQueue)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)          traceRecQueueEvent(E_TRACE_EVT_QUEUE_RECEIVE_FAILED, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)        traceRecQueueEvent(E_TRACE_EVT_QUEUE_RECEIVE_FROM_ISR, pxQueue)
+#define traceQUEUE_RECEIVE_FROM_ISR_FAILED(pxQueue) traceRecQueueEvent(E_TRACE_EVT_QUEUE_RECEIVE_FROM_ISR_FAILED, pxQueue)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)        traceRecQueueEvent(E_TRACE_EVT_QUEUE_BLOCK_SEND, pxQueue)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)     traceRecQueueEvent(E_TRACE_EVT_QUEUE_BLOCK_RECEIVE, pxQueue)
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue)        traceRecQueueEvent(E_TRACE_EVT_QUEUE_BLOCK_RECEIVE, pxQueue)
+
+// Stream and message buffers share the queue numbering, they have no registry so are named with
+// traceRecAddSymbol() by whoever creates them
+#define traceSTREAM_BUFFER_CREATE(pxStreamBuffer, xIsMessageBuffer)                                 \
+    ((pxStreamBuffer)->uxStreamBufferNumber = traceRecNewObject())
+
+#define traceRecStreamEvent(type, xStreamBuffer, xBytes)                                            \
+    traceRecEvent((type), (uint8_t)(xStreamBuffer)->uxStreamBufferNumber, (uint16_t)(xBytes))
+
+#define traceSTREAM_BUFFER_SEND(xStreamBuffer, xBytesSent)                                          \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_SEND, xStreamBuffer, xBytesSent)
+#define traceSTREAM_BUFFER_SEND_FAILED(xStreamBuffer)                                               \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_SEND, xStreamBuffer, 0)
+#define traceSTREAM_BUFFER_SEND_FROM_ISR(xStreamBuffer, xBytesSent)                                 \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_SEND_FROM_ISR, xStreamBuffer, xBytesSent)
+#define traceSTREAM_BUFFER_RECEIVE(xStreamBuffer, xReceivedLength)                                  \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_RECEIVE, xStreamBuffer, xReceivedLength)
+#define traceSTREAM_BUFFER_RECEIVE_FAILED(xStreamBuffer)                                            \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_RECEIVE, xStreamBuffer, 0)
+#define traceSTREAM_BUFFER_RECEIVE_FROM_ISR(xStreamBuffer, xReceivedLength)                         \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_RECEIVE_FROM_ISR, xStreamBuffer, xReceivedLength)
+#define traceBLOCKING_ON_STREAM_BUFFER_SEND(xStreamBuffer)                                          \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_BLOCK_SEND, xStreamBuffer, 0)
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE(xStreamBuffer)                                       \
+    traceRecStreamEvent(E_TRACE_EVT_STREAM_BLOCK_RECEIVE, xStreamBuffer, 0)
+
+#endif /* TRACE_RECORDER_H */
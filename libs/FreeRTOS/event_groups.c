@@ -60,10 +60,26 @@ taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
 	#define eventEVENT_BITS_CONTROL_BYTES	0xff000000UL
 #endif
 
+/* The number of lists the tasks waiting on an event group are spread over. */
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+	#define eventNUM_WAIT_LISTS				( ( UBaseType_t ) configEVENT_GROUP_WAIT_LISTS )
+#else
+	#define eventNUM_WAIT_LISTS				( ( UBaseType_t ) 1 )
+#endif
+
 typedef struct EventGroupDef_t
 {
 	EventBits_t uxEventBits;
-	List_t xTasksWaitingForBits;		/*< List of tasks waiting for a bit to be set. */
+	List_t xTasksWaitingForBits[ eventNUM_WAIT_LISTS ];	/*< Lists of tasks waiting for a bit to be set.  A task is in the list of the lowest bit it waits for, modulo the number of lists. */
+
+	#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+		EventBits_t uxWaitFilter[ eventNUM_WAIT_LISTS ];	/*< OR of the bits the tasks in each list may be waiting for.  A set only walks the lists whose filter has a bit being set. */
+	#endif
+
+	#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+		volatile UBaseType_t uxLockCount;	/*< Non zero while a task is accessing the event bits or xTasksWaitingForBits with the scheduler suspended.  Interrupts then defer to the timer task. */
+		EventBits_t uxDeferredBitsToClear;	/*< Clear on exit bits of tasks unblocked directly from an interrupt, cleared once the deferred part of the set has run. */
+	#endif
 
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxEventGroupNumber;
@@ -86,6 +102,41 @@ typedef struct EventGroupDef_t
  */
 static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, const EventBits_t uxBitsToWaitFor, const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Place the calling task in the list of the lowest bit in uxBitsToWaitFor and
+ * block it until the bits are set or xTicksToWait expires.  The list's filter
+ * gains all of uxBitsToWaitFor, so a set of any of them walks the list.  Must
+ * be called with the scheduler suspended and the event group locked.
+ */
+static void prvPlaceOnWaitingList( EventGroup_t *pxEventBits, const EventBits_t uxBitsToWaitFor, const EventBits_t uxControlBits, const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Macros to mark an event group as locked.  The scheduler being suspended
+ * stops other tasks accessing the event group, but when
+ * configUSE_EVENT_GROUP_DIRECT_ISR is 1 interrupts also update the event bits
+ * and unblock waiting tasks.  An interrupt that finds the event group locked
+ * defers the whole operation to the timer task instead.  Locks nest, as
+ * xEventGroupSync() calls xEventGroupSetBits().
+ */
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+	#define prvLockEventGroup( pxEventBits )		\
+		taskENTER_CRITICAL();						\
+		{											\
+			( pxEventBits )->uxLockCount++;			\
+		}											\
+		taskEXIT_CRITICAL()
+
+	#define prvUnlockEventGroup( pxEventBits )		\
+		taskENTER_CRITICAL();						\
+		{											\
+			( pxEventBits )->uxLockCount--;			\
+		}											\
+		taskEXIT_CRITICAL()
+#else
+	#define prvLockEventGroup( pxEventBits )
+	#define prvUnlockEventGroup( pxEventBits )
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR */
+
 /*-----------------------------------------------------------*/
 
 #if( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -93,6 +144,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 	EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t *pxEventGroupBuffer )
 	{
 	EventGroup_t *pxEventBits;
+	UBaseType_t uxList;
 
 		/* A StaticEventGroup_t object must be provided. */
 		configASSERT( pxEventGroupBuffer );
@@ -113,7 +165,24 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
-			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+			for( uxList = 0; uxList < eventNUM_WAIT_LISTS; uxList++ )
+			{
+				vListInitialise( &( pxEventBits->xTasksWaitingForBits[ uxList ] ) );
+
+				#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+				{
+					pxEventBits->uxWaitFilter[ uxList ] = 0;
+				}
+				#endif
+			}
+
+			#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+			{
+				pxEventBits->uxLockCount = 0;
+				pxEventBits->uxDeferredBitsToClear = 0;
+			}
+			#endif
 
 			#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 			{
@@ -145,6 +214,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 	EventGroupHandle_t xEventGroupCreate( void )
 	{
 	EventGroup_t *pxEventBits;
+	UBaseType_t uxList;
 
 		/* Allocate the event group.  Justification for MISRA deviation as
 		follows:  pvPortMalloc() always ensures returned memory blocks are
@@ -164,7 +234,24 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits, co
 		if( pxEventBits != NULL )
 		{
 			pxEventBits->uxEventBits = 0;
-			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+			for( uxList = 0; uxList < eventNUM_WAIT_LISTS; uxList++ )
+			{
+				vListInitialise( &( pxEventBits->xTasksWaitingForBits[ uxList ] ) );
+
+				#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+				{
+					pxEventBits->uxWaitFilter[ uxList ] = 0;
+				}
+				#endif
+			}
+
+			#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+			{
+				pxEventBits->uxLockCount = 0;
+				pxEventBits->uxDeferredBitsToClear = 0;
+			}
+			#endif
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
@@ -204,6 +291,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	#endif
 
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		uxOriginalBitValue = pxEventBits->uxEventBits;
 
@@ -229,7 +317,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 				/* Store the bits that the calling task is waiting for in the
 				task's event list item so the kernel knows when a match is
 				found.  Then enter the blocked state. */
-				vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+				prvPlaceOnWaitingList( pxEventBits, uxBitsToWaitFor, ( eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
 				/* This assignment is obsolete as uxReturn will get set after
 				the task unblocks, but some compilers mistakenly generate a
@@ -246,6 +334,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			}
 		}
 	}
+	prvUnlockEventGroup( pxEventBits );
 	xAlreadyYielded = xTaskResumeAll();
 
 	if( xTicksToWait != ( TickType_t ) 0 )
@@ -327,6 +416,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 	#endif
 
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		const EventBits_t uxCurrentEventBits = pxEventBits->uxEventBits;
 
@@ -384,7 +474,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			/* Store the bits that the calling task is waiting for in the
 			task's event list item so the kernel knows when a match is
 			found.  Then enter the blocked state. */
-			vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+			prvPlaceOnWaitingList( pxEventBits, uxBitsToWaitFor, uxControlBits, xTicksToWait );
 
 			/* This is obsolete as it will get set after the task unblocks, but
 			some compilers mistakenly generate a warning about the variable
@@ -394,6 +484,7 @@ BaseType_t xTimeoutOccurred = pdFALSE;
 			traceEVENT_GROUP_WAIT_BITS_BLOCK( xEventGroup, uxBitsToWaitFor );
 		}
 	}
+	prvUnlockEventGroup( pxEventBits );
 	xAlreadyYielded = xTaskResumeAll();
 
 	if( xTicksToWait != ( TickType_t ) 0 )
@@ -524,86 +615,128 @@ List_t const * pxList;
 EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
 EventGroup_t *pxEventBits = xEventGroup;
 BaseType_t xMatchFound = pdFALSE;
+UBaseType_t uxList;
 
 	/* Check the user is not attempting to set the bits used by the kernel
 	itself. */
 	configASSERT( xEventGroup );
 	configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-	pxList = &( pxEventBits->xTasksWaitingForBits );
-	pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
-		pxListItem = listGET_HEAD_ENTRY( pxList );
-
 		/* Set the bits. */
 		pxEventBits->uxEventBits |= uxBitsToSet;
 
-		/* See if the new bit value should unblock any tasks. */
-		while( pxListItem != pxListEnd )
+		for( uxList = 0; uxList < eventNUM_WAIT_LISTS; uxList++ )
 		{
-			pxNext = listGET_NEXT( pxListItem );
-			uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-			xMatchFound = pdFALSE;
+			pxList = &( pxEventBits->xTasksWaitingForBits[ uxList ] );
+			pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+			pxListItem = listGET_HEAD_ENTRY( pxList );
 
-			/* Split the bits waited for from the control bits. */
-			uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-			uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-			if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+			#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
 			{
-				/* Just looking for single bit being set. */
-				if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+				/* A waiting task can only be unblocked by the setting of a bit
+				it is waiting for, so if no task in this list is waiting for
+				any of the bits being set there is no need to look at the list
+				at all.  Otherwise the list's filter is rebuilt from the tasks
+				that are still waiting after the walk below, which also drops
+				the bits of tasks that have since timed out. */
+				if( ( uxBitsToSet & pxEventBits->uxWaitFilter[ uxList ] ) == ( EventBits_t ) 0 )
 				{
-					xMatchFound = pdTRUE;
+					pxListItem = ( ListItem_t * ) pxListEnd; /*lint !e9005 The end marker is only compared against, not written through. */
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					pxEventBits->uxWaitFilter[ uxList ] = 0;
 				}
 			}
-			else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-			{
-				/* All bits are set. */
-				xMatchFound = pdTRUE;
-			}
-			else
-			{
-				/* Need all bits to be set, but not all the bits were set. */
-			}
+			#endif /* configUSE_BUCKETED_EVENT_LISTS */
 
-			if( xMatchFound != pdFALSE )
+			/* See if the new bit value should unblock any tasks. */
+			while( pxListItem != pxListEnd )
 			{
-				/* The bits match.  Should the bits be cleared on exit? */
-				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+				pxNext = listGET_NEXT( pxListItem );
+				uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+				xMatchFound = pdFALSE;
+
+				/* Split the bits waited for from the control bits. */
+				uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+				uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+				if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
 				{
-					uxBitsToClear |= uxBitsWaitedFor;
+					/* Just looking for single bit being set. */
+					if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+					{
+						xMatchFound = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+				{
+					/* All bits are set. */
+					xMatchFound = pdTRUE;
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					/* Need all bits to be set, but not all the bits were set. */
+				}
+
+				if( xMatchFound != pdFALSE )
+				{
+					/* The bits match.  Should the bits be cleared on exit? */
+					if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+					{
+						uxBitsToClear |= uxBitsWaitedFor;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					/* Store the actual event flag value in the task's event list
+					item before removing the task from the event list.  The
+					eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+					that is was unblocked due to its required bits matching, rather
+					than because it timed out. */
+					vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
 				}
+				#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+					else
+					{
+						/* The task is still waiting. */
+						pxEventBits->uxWaitFilter[ uxList ] |= uxBitsWaitedFor;
+					}
+				#endif
 
-				/* Store the actual event flag value in the task's event list
-				item before removing the task from the event list.  The
-				eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-				that is was unblocked due to its required bits matching, rather
-				than because it timed out. */
-				vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+				/* Move onto the next list item.  Note pxListItem->pxNext is not
+				used here as the list item may have been removed from the event list
+				and inserted into the ready/pending reading list. */
+				pxListItem = pxNext;
 			}
+		}
 
-			/* Move onto the next list item.  Note pxListItem->pxNext is not
-			used here as the list item may have been removed from the event list
-			and inserted into the ready/pending reading list. */
-			pxListItem = pxNext;
+		#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+		{
+			/* Tasks unblocked directly by xEventGroupSetBitsFromISR() left
+			their clear on exit bits set so the tasks unblocked here by the
+			deferred part of the same set saw them too. */
+			uxBitsToClear |= pxEventBits->uxDeferredBitsToClear;
+			pxEventBits->uxDeferredBitsToClear = 0;
 		}
+		#endif
 
 		/* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
 		bit was set in the control word. */
 		pxEventBits->uxEventBits &= ~uxBitsToClear;
 	}
+	prvUnlockEventGroup( pxEventBits );
 	( void ) xTaskResumeAll();
 
 	return pxEventBits->uxEventBits;
@@ -613,20 +746,30 @@ BaseType_t xMatchFound = pdFALSE;
 void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 {
 EventGroup_t *pxEventBits = xEventGroup;
-const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
+const List_t *pxTasksWaitingForBits;
+UBaseType_t uxList;
 
 	vTaskSuspendAll();
+	prvLockEventGroup( pxEventBits );
 	{
 		traceEVENT_GROUP_DELETE( xEventGroup );
 
-		while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+		for( uxList = 0; uxList < eventNUM_WAIT_LISTS; uxList++ )
 		{
-			/* Unblock the task, returning 0 as the event list is being deleted
-			and cannot therefore have any bits set. */
-			configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-			vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+			pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits[ uxList ] );
+
+			while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+			{
+				/* Unblock the task, returning 0 as the event list is being deleted
+				and cannot therefore have any bits set. */
+				configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
+				vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+			}
 		}
 
+		/* Unlocked before the memory is freed rather than after. */
+		prvUnlockEventGroup( pxEventBits );
+
 		#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
 		{
 			/* The event group can only have been allocated dynamically - free
@@ -703,7 +846,31 @@ BaseType_t xWaitConditionMet = pdFALSE;
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+static void prvPlaceOnWaitingList( EventGroup_t *pxEventBits, const EventBits_t uxBitsToWaitFor, const EventBits_t uxControlBits, const TickType_t xTicksToWait )
+{
+UBaseType_t uxList = 0;
+
+	#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+	{
+	EventBits_t uxBit = ( EventBits_t ) 1;
+
+		/* uxBitsToWaitFor is never 0, so a bit is always found. */
+		while( ( uxBitsToWaitFor & uxBit ) == ( EventBits_t ) 0 )
+		{
+			uxBit <<= 1;
+			uxList++;
+		}
+
+		uxList %= eventNUM_WAIT_LISTS;
+		pxEventBits->uxWaitFilter[ uxList ] |= uxBitsToWaitFor;
+	}
+	#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
+	vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits[ uxList ] ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) && ( configUSE_EVENT_GROUP_DIRECT_ISR == 0 ) )
 
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
 	{
@@ -718,6 +885,196 @@ BaseType_t xWaitConditionMet = pdFALSE;
 #endif
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+
+	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken )
+	{
+	EventGroup_t *pxEventBits = xEventGroup;
+	ListItem_t *pxListItem, *pxUnblock = NULL;
+	ListItem_t const *pxListEnd;
+	EventBits_t uxBitsWaitedFor, uxControlBits, uxOriginalBits;
+	UBaseType_t uxSavedInterruptStatus, uxList, uxInspected = 0, uxMatches = 0, uxPriority, uxUnblockPriority = 0;
+	BaseType_t xDefer = pdFALSE, xReturn = pdPASS;
+
+		configASSERT( xEventGroup );
+		configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+		traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			uxOriginalBits = pxEventBits->uxEventBits;
+
+			if( pxEventBits->uxLockCount != ( UBaseType_t ) 0 )
+			{
+				/* A task is part way through accessing the event group, so
+				leave the whole operation to the timer task. */
+				xDefer = pdTRUE;
+			}
+			else
+			{
+				pxEventBits->uxEventBits |= uxBitsToSet;
+
+				/* Inspect a bounded number of waiting tasks, remembering the
+				highest priority one whose wait condition is now met.  Once a
+				list can't be inspected to its end the rest of the set is left
+				to the timer task, so the remaining lists are not looked at. */
+				for( uxList = 0; ( uxList < eventNUM_WAIT_LISTS ) && ( xDefer == pdFALSE ); uxList++ )
+				{
+					pxListEnd = listGET_END_MARKER( &( pxEventBits->xTasksWaitingForBits[ uxList ] ) ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+					pxListItem = listGET_HEAD_ENTRY( &( pxEventBits->xTasksWaitingForBits[ uxList ] ) );
+
+					#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+					{
+						/* No task in this list is waiting for any of the bits
+						being set. */
+						if( ( uxBitsToSet & pxEventBits->uxWaitFilter[ uxList ] ) == ( EventBits_t ) 0 )
+						{
+							pxListItem = ( ListItem_t * ) pxListEnd; /*lint !e9005 The end marker is only compared against, not written through. */
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+					}
+					#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
+					while( ( pxListItem != pxListEnd ) && ( uxInspected < ( UBaseType_t ) configEVENT_GROUP_ISR_MAX_WAITERS ) )
+					{
+						uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
+						uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+						uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+						if( prvTestWaitCondition( pxEventBits->uxEventBits, uxBitsWaitedFor, ( BaseType_t ) ( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 ) ) != pdFALSE )
+						{
+							uxMatches++;
+							uxPriority = uxTaskPriorityGetFromISR( listGET_LIST_ITEM_OWNER( pxListItem ) );
+
+							if( ( pxUnblock == NULL ) || ( uxPriority > uxUnblockPriority ) )
+							{
+								pxUnblock = pxListItem;
+								uxUnblockPriority = uxPriority;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						uxInspected++;
+						pxListItem = listGET_NEXT( pxListItem );
+					}
+
+					/* Waiting tasks that were not inspected are left to the
+					timer task. */
+					if( pxListItem != pxListEnd )
+					{
+						xDefer = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+
+				/* As are other tasks that are also to be unblocked. */
+				if( uxMatches > ( UBaseType_t ) 1 )
+				{
+					xDefer = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( xDefer != pdFALSE )
+			{
+				/* The rest of the set goes to the timer task before any task
+				is unblocked here, so a full timer queue can still leave the
+				event group as it was.  The bits are set again by the timer
+				task, which is harmless, and it unblocks any other tasks
+				waiting for them. */
+				xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
+
+				if( xReturn == pdFAIL )
+				{
+					/* The set will never be completed, so none of it is done,
+					as when every set from an interrupt went through the timer
+					task.  Interrupts have been masked since the bits were
+					read, so no other change is undone with it. */
+					pxEventBits->uxEventBits = uxOriginalBits;
+					pxUnblock = NULL;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( pxUnblock != NULL )
+			{
+				uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxUnblock );
+				uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+				uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+				/* The task is passed the bits as they were before any are
+				cleared, as it would be by xEventGroupSetBits(). */
+				if( xTaskRemoveFromUnorderedEventListFromISR( pxUnblock, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET ) != pdFALSE )
+				{
+					if( pxHigherPriorityTaskWoken != NULL )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+				{
+					if( xDefer != pdFALSE )
+					{
+						/* Tasks unblocked by the timer task must still see
+						these bits. */
+						pxEventBits->uxDeferredBitsToClear |= uxBitsWaitedFor;
+					}
+					else
+					{
+						pxEventBits->uxEventBits &= ~uxBitsWaitedFor;
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR */
+/*-----------------------------------------------------------*/
+
 #if (configUSE_TRACE_FACILITY == 1)
 
 	UBaseType_t uxEventGroupGetNumber( void* xEventGroup )
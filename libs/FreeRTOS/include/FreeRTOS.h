@@ -716,6 +716,13 @@ hold explicit before calling the code. */
 	#define configGENERATE_RUN_TIME_STATS 0
 #endif
 
+#ifndef configRUN_TIME_COUNTER_TYPE
+	/* The type of the run time counter and of the per task run time totals.
+	Can be set to uint64_t so a fast counter, such as a CPU cycle counter,
+	does not overflow. */
+	#define configRUN_TIME_COUNTER_TYPE uint32_t
+#endif
+
 #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 	#ifndef portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
@@ -778,6 +785,92 @@ hold explicit before calling the code. */
 	#define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_QUEUE_ZERO_COPY
+	#define configUSE_QUEUE_ZERO_COPY 0
+#endif
+
+#ifndef configUSE_QUEUE_STATS
+	#define configUSE_QUEUE_STATS 0
+#endif
+
+#ifndef configQUEUE_STATS_TIMESTAMP
+	/* Must be safe to call from an interrupt.  A faster counter than the tick
+	gives latencies finer than a tick period. */
+	#define configQUEUE_STATS_TIMESTAMP() ( ( uint32_t ) xTaskGetTickCountFromISR() )
+#endif
+
+#ifndef configQUEUE_STATS_HISTOGRAM_BUCKETS
+	#define configQUEUE_STATS_HISTOGRAM_BUCKETS 8
+#endif
+
+#ifndef configQUEUE_STATS_HISTOGRAM_SHIFT
+	/* Bucket 0 counts latencies below ( 1 << configQUEUE_STATS_HISTOGRAM_SHIFT ),
+	each bucket after it twice the range of the one before, and the last bucket
+	everything longer. */
+	#define configQUEUE_STATS_HISTOGRAM_SHIFT 0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_MULTI_PRODUCER
+	#define configUSE_STREAM_BUFFER_MULTI_PRODUCER 0
+#endif
+
+#ifndef configUSE_TIMER_WHEEL
+	#define configUSE_TIMER_WHEEL 0
+#endif
+
+#ifndef configTIMER_WHEEL_SLOT_BITS
+	/* Each level of the timer wheel has 2^configTIMER_WHEEL_SLOT_BITS slots. */
+	#define configTIMER_WHEEL_SLOT_BITS 4
+#endif
+
+#ifndef configUSE_DELAYED_TASK_WHEEL
+	#define configUSE_DELAYED_TASK_WHEEL 0
+#endif
+
+#ifndef configDELAYED_TASK_WHEEL_SLOT_BITS
+	/* Each level of the delayed task wheel has
+	2^configDELAYED_TASK_WHEEL_SLOT_BITS slots. */
+	#define configDELAYED_TASK_WHEEL_SLOT_BITS 4
+#endif
+
+#ifndef configUSE_BUCKETED_EVENT_LISTS
+	#define configUSE_BUCKETED_EVENT_LISTS 0
+#endif
+
+#if( ( configUSE_BUCKETED_EVENT_LISTS == 1 ) && ( configUSE_CO_ROUTINES == 1 ) )
+	/* Co-routines place themselves in the event lists of queues with
+	vListInsert(), which does not maintain the per priority tails. */
+	#error configUSE_BUCKETED_EVENT_LISTS cannot be used with co-routines.
+#endif
+
+#ifndef configEVENT_GROUP_WAIT_LISTS
+	/* With configUSE_BUCKETED_EVENT_LISTS the tasks waiting on an event group
+	are indexed by the lowest bit they wait for, in this many lists.  Setting
+	bits only walks the lists of tasks that may be waiting for them. */
+	#define configEVENT_GROUP_WAIT_LISTS 1
+#endif
+
+#ifndef configUSE_EVENT_GROUP_DIRECT_ISR
+	#define configUSE_EVENT_GROUP_DIRECT_ISR 0
+#endif
+
+#ifndef configEVENT_GROUP_ISR_MAX_WAITERS
+	/* The most waiting tasks xEventGroupSetBitsFromISR() will inspect before
+	deferring the rest of the work to the timer task. */
+	#define configEVENT_GROUP_ISR_MAX_WAITERS 4
+#endif
+
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+	#if( ( configUSE_TIMERS != 1 ) || ( INCLUDE_xTimerPendFunctionCall != 1 ) )
+		/* Work that cannot be bounded is still deferred to the timer task. */
+		#error configUSE_EVENT_GROUP_DIRECT_ISR requires configUSE_TIMERS and INCLUDE_xTimerPendFunctionCall to be set to 1.
+	#endif
+
+	#if( INCLUDE_uxTaskPriorityGet != 1 )
+		#error configUSE_EVENT_GROUP_DIRECT_ISR requires INCLUDE_uxTaskPriorityGet to be set to 1.
+	#endif
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 	#define portTASK_USES_FLOATING_POINT()
 #endif
@@ -834,6 +927,15 @@ hold explicit before calling the code. */
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+	#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+
+#if ( ( configTASK_NOTIFICATION_ARRAY_ENTRIES < 1 ) || ( configTASK_NOTIFICATION_ARRAY_ENTRIES > 8 ) )
+	/* uxTaskNotifyWaitAny() takes the indexes as a bit mask. */
+	#error configTASK_NOTIFICATION_ARRAY_ENTRIES must be between 1 and 8
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
 	#define configUSE_POSIX_ERRNO 0
 #endif
@@ -1096,6 +1198,17 @@ typedef struct xSTATIC_LIST
 	#endif
 } StaticList_t;
 
+/* See the comments above the struct xSTATIC_LIST_ITEM definition. */
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+	typedef struct xSTATIC_EVENT_LIST
+	{
+		StaticList_t xDummy1;
+		void *pvDummy2[ configMAX_PRIORITIES ];
+	} StaticEventList_t;
+#else
+	typedef StaticList_t StaticEventList_t;
+#endif
+
 /*
  * In line with software engineering best practice, especially when supplying a
  * library that is likely to change in future versions, FreeRTOS implements a
@@ -1138,14 +1251,15 @@ typedef struct xSTATIC_TCB
 		void			*pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
 	#endif
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
-		uint32_t		ulDummy16;
+		configRUN_TIME_COUNTER_TYPE	ulDummy16;
+		uint32_t		ulDummy23;
 	#endif
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
 		struct	_reent	xDummy17;
 	#endif
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
-		uint32_t 		ulDummy18;
-		uint8_t 		ucDummy19;
+		uint32_t 		ulDummy18[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		uint8_t 		ucDummy19[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 	#if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
 		uint8_t			uxDummy20;
@@ -1183,7 +1297,7 @@ typedef struct xSTATIC_QUEUE
 		UBaseType_t uxDummy2;
 	} u;
 
-	StaticList_t xDummy3[ 2 ];
+	StaticEventList_t xDummy3[ 2 ];
 	UBaseType_t uxDummy4[ 3 ];
 	uint8_t ucDummy5[ 2 ];
 
@@ -1195,11 +1309,21 @@ typedef struct xSTATIC_QUEUE
 		void *pvDummy7;
 	#endif
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+		void *pvDummy10[ 2 ];
+	#endif
+
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy8;
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_STATS == 1 )
+		UBaseType_t uxDummy11[ 2 ];
+		uint32_t ulDummy12[ 7 + configQUEUE_STATS_HISTOGRAM_BUCKETS ];
+		void *pvDummy13;
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1220,7 +1344,18 @@ typedef StaticQueue_t StaticSemaphore_t;
 typedef struct xSTATIC_EVENT_GROUP
 {
 	TickType_t xDummy1;
-	StaticList_t xDummy2;
+
+	#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+		StaticList_t xDummy2[ configEVENT_GROUP_WAIT_LISTS ];
+		TickType_t xDummy5[ configEVENT_GROUP_WAIT_LISTS ];
+	#else
+		StaticList_t xDummy2;
+	#endif
+
+	#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+		UBaseType_t uxDummy6;
+		TickType_t xDummy7;
+	#endif
 
 	#if( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy3;
@@ -1282,6 +1417,9 @@ typedef struct xSTATIC_STREAM_BUFFER
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxDummy4;
 	#endif
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		uint32_t ulDummy5[ 2 ];
+	#endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
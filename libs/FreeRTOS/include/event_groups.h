@@ -500,6 +500,18 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configUSE_EVENT_GROUP_DIRECT_ISR is set to 1 in FreeRTOSConfig.h the bits
+ * are set in the interrupt itself, and up to
+ * configEVENT_GROUP_ISR_MAX_WAITERS waiting tasks are inspected.  The highest
+ * priority of those tasks whose wait condition is met is unblocked directly.
+ * Only if more tasks may need unblocking, or a task was accessing the event
+ * group when the interrupt occurred, is a message sent to the timer task.
+ * *pxHigherPriorityTaskWoken is also set if the task unblocked directly has a
+ * priority above the interrupted task, and pdPASS is returned when there was
+ * nothing to send.  The message is sent before any task is unblocked, so if
+ * the timer service queue is full the bits are left as they were, no task is
+ * unblocked and pdFAIL is returned, just as when every set is sent.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -556,7 +568,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup, const EventBits_
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if( configUSE_TRACE_FACILITY == 1 )
+#if( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR == 1 ) )
 	BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 #else
 	#define xEventGroupSetBitsFromISR( xEventGroup, uxBitsToSet, pxHigherPriorityTaskWoken ) xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken )
@@ -170,6 +170,28 @@ typedef struct xLIST
 	listSECOND_LIST_INTEGRITY_CHECK_VALUE				/*< Set to a known value if configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES is set to 1. */
 } List_t;
 
+/*
+ * Definition of the type of list used to hold the tasks waiting on a queue or
+ * semaphore.  The waiters are held in task priority order, highest first.
+ * When configUSE_BUCKETED_EVENT_LISTS is 1 the last waiter at each priority is
+ * also recorded, so a new waiter is placed by looking at the tail of its own
+ * and higher priorities rather than by walking the waiters.  Insertion then
+ * depends on configMAX_PRIORITIES only, not on the number of waiting tasks.
+ */
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+	typedef struct xEVENT_LIST
+	{
+		List_t xWaiters;										/*< Must be the first member, the list item container is used to find the event list. */
+		ListItem_t * pxPriorityTail[ configMAX_PRIORITIES ];	/*< Indexed by item value - 1, NULL if no task of that priority is waiting. */
+	} EventList_t;
+
+	#define listEVENT_LIST_WAITERS( pxEventList )	( &( ( pxEventList )->xWaiters ) )
+#else
+	typedef List_t EventList_t;
+
+	#define listEVENT_LIST_WAITERS( pxEventList )	( pxEventList )
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
 /*
  * Access macro to set the owner of a list item.  The owner of a list item
  * is the object (usually a TCB) that contains the list item.
@@ -404,6 +426,36 @@ void vListInsertEnd( List_t * const pxList, ListItem_t * const pxNewListItem ) P
  */
 UBaseType_t uxListRemove( ListItem_t * const pxItemToRemove ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+
+	/*
+	 * Must be called before an event list is used.  Initialises the list of
+	 * waiters and marks every priority as having no waiters.
+	 */
+	void vListInitialiseEventList( EventList_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Insert a list item into an event list, after any items of the same or
+	 * lower item value.  The item value must be between 1 and
+	 * configMAX_PRIORITIES, which is the case for a task's event list item
+	 * when it is waiting on a queue.
+	 */
+	void vListInsertInEventList( EventList_t * const pxEventList, ListItem_t * const pxNewListItem ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Remove an item from the event list it is in.  The same as uxListRemove()
+	 * except the tail of the item's priority is kept up to date.
+	 */
+	UBaseType_t uxListRemoveFromEventList( ListItem_t * const pxItemToRemove ) PRIVILEGED_FUNCTION;
+
+#else
+
+	#define vListInitialiseEventList( pxEventList )					vListInitialise( pxEventList )
+	#define vListInsertInEventList( pxEventList, pxNewListItem )	vListInsert( ( pxEventList ), ( pxNewListItem ) )
+	#define uxListRemoveFromEventList( pxItemToRemove )				uxListRemove( pxItemToRemove )
+
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
 #ifdef __cplusplus
 }
 #endif
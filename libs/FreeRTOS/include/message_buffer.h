@@ -81,6 +81,11 @@ extern "C" {
  */
 typedef void * MessageBufferHandle_t;
 
+/**
+ * One piece of a message passed to xMessageBufferSendV().
+ */
+typedef StreamBufferIOVec_t MessageBufferIOVec_t;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -207,6 +212,31 @@ MessageBufferHandle_t xMessageBuffer;
  */
 #define xMessageBufferCreateStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, pdTRUE, pucMessageBufferStorageArea, pxStaticMessageBuffer )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+MessageBufferHandle_t xMessageBufferCreateMultiProducer( size_t xBufferSizeBytes );
+
+MessageBufferHandle_t xMessageBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                               uint8_t *pucMessageBufferStorageArea,
+                                                               StaticMessageBuffer_t *pxStaticMessageBuffer );
+</pre>
+ *
+ * As xMessageBufferCreate() and xMessageBufferCreateStatic(), but the created
+ * message buffer can be written to by more than one task or interrupt at a
+ * time without the writes being placed in critical sections.  Each message is
+ * still written whole or not at all, and messages are received in the order
+ * their space was reserved.  configUSE_STREAM_BUFFER_MULTI_PRODUCER must be
+ * set to 1 in FreeRTOSConfig.h for these macros to be used.  See
+ * xStreamBufferCreateMultiProducer().
+ *
+ * \defgroup xMessageBufferCreateMultiProducer xMessageBufferCreateMultiProducer
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferCreateMultiProducer( xBufferSizeBytes ) ( MessageBufferHandle_t ) xStreamBufferGenericCreate( xBufferSizeBytes, ( size_t ) 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER )
+#define xMessageBufferCreateMultiProducerStatic( xBufferSizeBytes, pucMessageBufferStorageArea, pxStaticMessageBuffer ) ( MessageBufferHandle_t ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, 0, sbTYPE_MESSAGE_BUFFER | sbTYPE_MULTI_PRODUCER, pucMessageBufferStorageArea, pxStaticMessageBuffer )
+
 /**
  * message_buffer.h
  *
@@ -410,6 +440,89 @@ BaseType_t xHigherPriorityTaskWoken = pdFALSE; // Initialised to pdFALSE.
  */
 #define xMessageBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken ) xStreamBufferSendFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken )
 
+/**
+ * message_buffer.h
+ *
+<pre>
+size_t xMessageBufferSendV( MessageBufferHandle_t xMessageBuffer,
+                            const MessageBufferIOVec_t * const pxVecs,
+                            UBaseType_t uxVecCount,
+                            TickType_t xTicksToWait );
+
+size_t xMessageBufferSendVFromISR( MessageBufferHandle_t xMessageBuffer,
+                                   const MessageBufferIOVec_t * const pxVecs,
+                                   UBaseType_t uxVecCount,
+                                   BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sends one message made up of the uxVecCount pieces described by pxVecs,
+ * concatenated in order.  The pieces are copied straight into the message
+ * buffer, so a header such as a route, sequence number or timestamp can be
+ * prefixed to a payload without assembling the two in a temporary buffer
+ * first.  As with xMessageBufferSend(), the message is written whole or not at
+ * all, and its length is the sum of the lengths of the pieces.
+ *
+ * Use xMessageBufferSendVFromISR() from an interrupt service routine.
+ *
+ * @return The length of the message written, or 0 if it did not fit before
+ * the block time expired.
+ *
+ * Example use:
+<pre>
+void vAFunction( MessageBufferHandle_t xMessageBuffer, const uint8_t *pucPayload, size_t xPayloadLength )
+{
+static uint16_t usSequence = 0;
+MessageBufferIOVec_t xVecs[ 2 ];
+
+    usSequence++;
+    xVecs[ 0 ].pvData = &usSequence;
+    xVecs[ 0 ].xLength = sizeof( usSequence );
+    xVecs[ 1 ].pvData = pucPayload;
+    xVecs[ 1 ].xLength = xPayloadLength;
+
+    xMessageBufferSendV( xMessageBuffer, xVecs, 2, pdMS_TO_TICKS( 100 ) );
+}
+</pre>
+ * \defgroup xMessageBufferSendV xMessageBufferSendV
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendV( xMessageBuffer, pxVecs, uxVecCount, xTicksToWait ) xStreamBufferSendV( ( StreamBufferHandle_t ) xMessageBuffer, pxVecs, uxVecCount, xTicksToWait )
+#define xMessageBufferSendVFromISR( xMessageBuffer, pxVecs, uxVecCount, pxHigherPriorityTaskWoken ) xStreamBufferSendVFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxVecs, uxVecCount, pxHigherPriorityTaskWoken )
+
+/**
+ * message_buffer.h
+ *
+<pre>
+UBaseType_t xMessageBufferSendMultipleV( MessageBufferHandle_t xMessageBuffer,
+                                         const MessageBufferIOVec_t * const pxVecs,
+                                         const UBaseType_t * const puxVecCounts,
+                                         UBaseType_t uxNumMessages,
+                                         TickType_t xTicksToWait );
+
+UBaseType_t xMessageBufferSendMultipleVFromISR( MessageBufferHandle_t xMessageBuffer,
+                                                const MessageBufferIOVec_t * const pxVecs,
+                                                const UBaseType_t * const puxVecCounts,
+                                                UBaseType_t uxNumMessages,
+                                                BaseType_t *pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Sends up to uxNumMessages messages in one call.  Message n is made up of the
+ * next puxVecCounts[ n ] entries of pxVecs, so the pieces of all the messages
+ * are laid out one message after another in a single array.
+ *
+ * Messages are written in order until one doesn't fit, and the receiving task
+ * is notified once for the whole batch rather than once per message.  The
+ * calling task only blocks, for up to xTicksToWait, if there is not enough
+ * space for the first message.
+ *
+ * @return The number of messages written.
+ *
+ * \defgroup xMessageBufferSendMultipleV xMessageBufferSendMultipleV
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendMultipleV( xMessageBuffer, pxVecs, puxVecCounts, uxNumMessages, xTicksToWait ) xStreamBufferSendMultipleV( ( StreamBufferHandle_t ) xMessageBuffer, pxVecs, puxVecCounts, uxNumMessages, xTicksToWait )
+#define xMessageBufferSendMultipleVFromISR( xMessageBuffer, pxVecs, puxVecCounts, uxNumMessages, pxHigherPriorityTaskWoken ) xStreamBufferSendMultipleVFromISR( ( StreamBufferHandle_t ) xMessageBuffer, pxVecs, puxVecCounts, uxNumMessages, pxHigherPriorityTaskWoken )
+
 /**
  * message_buffer.h
  *
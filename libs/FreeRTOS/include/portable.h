@@ -138,6 +138,21 @@ typedef struct xHeapStats
 	size_t xNumberOfSuccessfulFrees;		/* The number of calls to vPortFree() that has successfully freed a block of memory. */
 } HeapStats_t;
 
+/* Used to pass information about one pool of heap_pool.c out of
+xPortGetHeapPoolStats().  Counts are since the scheduler started. */
+typedef struct xHeapPoolStats
+{
+	size_t xBlockSize;						/* The size of every block in the pool, in bytes. */
+	UBaseType_t uxNumBlocks;				/* The number of blocks in the pool. */
+	UBaseType_t uxBlocksFree;				/* The number of blocks not allocated at the time xPortGetHeapPoolStats() is called. */
+	UBaseType_t uxMinimumEverBlocksFree;	/* The fewest blocks there have been free at once. */
+	uint32_t ulAllocations;					/* The number of blocks allocated from the pool. */
+	uint32_t ulFrees;						/* The number of blocks freed back to the pool. */
+	uint32_t ulSpilled;						/* Allocations the pool served because the smaller pool the request fitted was empty. */
+	uint32_t ulFailed;						/* Requests that fitted this pool, as the smallest that could hold them, that no pool had a block for. */
+	uint32_t ulBytesRequested;				/* The bytes asked for by the allocations, against ulAllocations * xBlockSize this shows the space lost inside blocks. */
+} HeapPoolStats_t;
+
 /*
  * Used to define multiple heap regions for use by heap_5.c.  This function
  * must be called before any calls to pvPortMalloc() - not creating a task,
@@ -157,6 +172,13 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t *pxHeapStats );
 
+/*
+ * Used by heap_pool.c to return the number of pools, and the usage of each
+ * one.  xPortGetHeapPoolStats() returns pdFALSE if uxPool is not a pool.
+ */
+UBaseType_t uxPortGetHeapPoolCount( void );
+BaseType_t xPortGetHeapPoolStats( UBaseType_t uxPool, HeapPoolStats_t *pxPoolStats );
+
 /*
  * Map to the memory management routines required for the port.
  */
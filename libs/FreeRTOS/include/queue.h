@@ -1487,6 +1487,22 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
 	const char *pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
+/*
+ * Walks the queue registry.  Call with uxIndex from 0 up to
+ * configQUEUE_REGISTRY_SIZE - 1 to visit every registered queue, semaphore and
+ * mutex, e.g. to report statistics on each of them.
+ *
+ * @param uxIndex The position in the registry to read.
+ *
+ * @param ppcName Set to the name the handle was registered with, if not NULL.
+ *
+ * @return The handle at the position, or NULL if the position is vacant or
+ * past the end of the registry.
+ */
+#if( configQUEUE_REGISTRY_SIZE > 0 )
+	QueueHandle_t xQueueGetRegistryEntry( UBaseType_t uxIndex, const char **ppcName ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
 /*
  * Generic version of the function used to creaet a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -1639,6 +1655,104 @@ QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet, const Ti
  */
 QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
+/*
+ * xQueueReserve() and vQueueCommit() send an item to the back of a queue
+ * without copying it.  xQueueReserve() returns a pointer to the storage the
+ * next item will occupy so the caller can build the item in place, then
+ * vQueueCommit() makes it visible to receivers.  Only one slot can be
+ * reserved at a time, other sends to the queue block (or fail) until the
+ * reserved slot is committed.
+ *
+ * xQueueAcquire() and vQueueRelease() are the receive side equivalent.
+ * xQueueAcquire() removes the item at the front of the queue and returns a
+ * pointer to it in the queue storage, the storage is not reused until
+ * vQueueRelease() is called.  A queue that is used this way must have a single
+ * receiving task or interrupt, and only one item can be acquired at a time.
+ * While an item is held the receiver must not call xQueueReceive(),
+ * xQueuePeek() or their FromISR versions on the queue either, as a later send
+ * could then overwrite the held item.
+ *
+ * Neither pair can be used with semaphores, which have no item storage, and
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for the
+ * functions to be available.
+ *
+ * @param xQueue The handle of the queue.
+ *
+ * @param ppvSlot / ppvItem Set to point into the queue storage on success.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space (xQueueReserve()) or an item (xQueueAcquire()).
+ *
+ * @return pdPASS if a slot was reserved or an item acquired, otherwise
+ * errQUEUE_FULL (xQueueReserve()) or errQUEUE_EMPTY (xQueueAcquire()).
+ */
+BaseType_t xQueueReserve( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueCommit( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueAcquire( QueueHandle_t xQueue, void ** const ppvItem, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueRelease( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Versions of the above that can be used from an ISR.  A slot can be reserved
+ * and filled across several interrupts, e.g. one per received character, and
+ * committed once the item is complete.
+ */
+BaseType_t xQueueReserveFromISR( QueueHandle_t xQueue, void ** const ppvSlot ) PRIVILEGED_FUNCTION;
+void vQueueCommitFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueAcquireFromISR( QueueHandle_t xQueue, void ** const ppvItem ) PRIVILEGED_FUNCTION;
+void vQueueReleaseFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*
+ * Usage statistics kept for each queue when configUSE_QUEUE_STATS is set to 1
+ * in FreeRTOSConfig.h, for sizing queues from measurements rather than
+ * guesswork.  Times are in the units of configQUEUE_STATS_TIMESTAMP().
+ *
+ * Latency is the time from an item being sent to it being received, and is
+ * only measured for queues that have space for a timestamp per item.  Queues
+ * created with xQueueCreate() have it, statically created queues are given it
+ * with vQueueSetEnqueueTimes().  Peeking at an item does not count as receiving
+ * it.
+ */
+#if ( configUSE_QUEUE_STATS == 1 )
+	typedef struct xQUEUE_STATS
+	{
+		UBaseType_t uxLength;				/*< The number of items the queue can hold. */
+		UBaseType_t uxPeakMessagesWaiting;	/*< The most items the queue has held at once. */
+		uint32_t ulItemsSent;				/*< Items successfully sent to the queue. */
+		uint32_t ulSendFailed;				/*< Sends from tasks that returned without sending, after any block time. */
+		uint32_t ulSendFailedFromISR;		/*< Sends from interrupts that found the queue full. */
+		uint32_t ulSendWaits;				/*< Sends from tasks that blocked because the queue was full. */
+		uint32_t ulSendWaitTime;			/*< Total time senders spent blocked. */
+		uint32_t ulSendWaitTimeMax;			/*< Longest time a sender spent blocked. */
+		uint32_t ulLatencyMax;				/*< Longest time an item spent in the queue. */
+		uint32_t ulLatencyHistogram[ configQUEUE_STATS_HISTOGRAM_BUCKETS ]; /*< See configQUEUE_STATS_HISTOGRAM_SHIFT. */
+	} QueueStats_t;
+
+	/*
+	 * Copies out the statistics of a queue.
+	 *
+	 * @param xQueue The handle of the queue.
+	 *
+	 * @param pxStats The structure the statistics are copied to.
+	 *
+	 * @param xReset Set to pdTRUE to start a new measurement period once the
+	 * statistics have been copied.  The peak depth restarts from the current
+	 * depth, everything else from zero.
+	 */
+	void vQueueGetStats( QueueHandle_t xQueue, QueueStats_t * const pxStats, const BaseType_t xReset ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Gives a statically created queue somewhere to record when each item was
+	 * sent, so the latency of its items is measured.  Must be called before
+	 * anything is sent to the queue.
+	 *
+	 * @param xQueue The handle of the queue.
+	 *
+	 * @param pulEnqueueTimes An array with one entry per item the queue can
+	 * hold, which must exist for as long as the queue does.
+	 */
+	void vQueueSetEnqueueTimes( QueueHandle_t xQueue, uint32_t * const pulEnqueueTimes ) PRIVILEGED_FUNCTION;
+#endif
+
 /* Not public API functions. */
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue ) PRIVILEGED_FUNCTION;
@@ -46,6 +46,14 @@
  * (such as xStreamBufferReceive()) inside a critical section section and set the
  * receive block time to 0.
  *
+ * If configUSE_STREAM_BUFFER_MULTI_PRODUCER is set to 1 in FreeRTOSConfig.h
+ * then a buffer created with xStreamBufferCreateMultiProducer() or
+ * xMessageBufferCreateMultiProducer() can have any number of writers, which
+ * can be tasks or interrupts, without the critical sections.  Writers reserve
+ * space without disabling interrupts, copy their data in concurrently, and the
+ * data is made visible to the reader in the order the space was reserved.
+ * There must still be only one reader.
+ *
  */
 
 #ifndef STREAM_BUFFER_H
@@ -68,6 +76,37 @@ extern "C" {
 struct StreamBufferDef_t;
 typedef struct StreamBufferDef_t * StreamBufferHandle_t;
 
+/**
+ * Describes a region of a stream buffer's storage area as at most two
+ * contiguous spans.  The second span is only used, and pucSecond is only
+ * non-NULL, when the region wraps from the end of the storage area back to its
+ * start.  Filled in by xStreamBufferSendAcquire() and
+ * xStreamBufferReceiveAcquire().
+ */
+typedef struct xSTREAM_BUFFER_SPANS
+{
+	uint8_t *pucFirst;
+	size_t xFirstLength;
+	uint8_t *pucSecond;
+	size_t xSecondLength;
+} StreamBufferSpans_t;
+
+/**
+ * One piece of the data passed to xStreamBufferSendV() and
+ * xMessageBufferSendV().
+ */
+typedef struct xSTREAM_BUFFER_IOVEC
+{
+	const void *pvData;
+	size_t xLength;
+} StreamBufferIOVec_t;
+
+/* Values that can be combined in the xIsMessageBuffer parameter of
+xStreamBufferGenericCreate() and xStreamBufferGenericCreateStatic(). */
+#define sbTYPE_STREAM_BUFFER		( ( BaseType_t ) 0 )
+#define sbTYPE_MESSAGE_BUFFER		( ( BaseType_t ) 1 )
+#define sbTYPE_MULTI_PRODUCER		( ( BaseType_t ) 2 )
+
 
 /**
  * message_buffer.h
@@ -217,6 +256,37 @@ const size_t xTriggerLevel = 1;
  */
 #define xStreamBufferCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, pdFALSE, pucStreamBufferStorageArea, pxStaticStreamBuffer )
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+StreamBufferHandle_t xStreamBufferCreateMultiProducer( size_t xBufferSizeBytes, size_t xTriggerLevelBytes );
+
+StreamBufferHandle_t xStreamBufferCreateMultiProducerStatic( size_t xBufferSizeBytes,
+                                                             size_t xTriggerLevelBytes,
+                                                             uint8_t *pucStreamBufferStorageArea,
+                                                             StaticStreamBuffer_t *pxStaticStreamBuffer );
+</pre>
+ *
+ * As xStreamBufferCreate() and xStreamBufferCreateStatic(), but the created
+ * stream buffer can be written to by more than one task or interrupt at a
+ * time.  configUSE_STREAM_BUFFER_MULTI_PRODUCER must be set to 1 in
+ * FreeRTOSConfig.h for these macros to be used.
+ *
+ * Each producer reserves the space it needs by atomically moving a reservation
+ * index, copies its data in with interrupts enabled, then commits it.  Data is
+ * only made available to the reader once every producer that reserved space
+ * ahead of it has committed, so the reader always sees whole writes in the
+ * order the space was reserved.  As only one task can be notified when space
+ * becomes available, a second task blocked on a full buffer checks for space
+ * once per tick instead.
+ *
+ * \defgroup xStreamBufferCreateMultiProducer xStreamBufferCreateMultiProducer
+ * \ingroup StreamBufferManagement
+ */
+#define xStreamBufferCreateMultiProducer( xBufferSizeBytes, xTriggerLevelBytes ) xStreamBufferGenericCreate( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_MULTI_PRODUCER )
+#define xStreamBufferCreateMultiProducerStatic( xBufferSizeBytes, xTriggerLevelBytes, pucStreamBufferStorageArea, pxStaticStreamBuffer ) xStreamBufferGenericCreateStatic( xBufferSizeBytes, xTriggerLevelBytes, sbTYPE_MULTI_PRODUCER, pucStreamBufferStorageArea, pxStaticStreamBuffer )
+
 /**
  * stream_buffer.h
  *
@@ -415,6 +485,50 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
 								 size_t xDataLengthBytes,
 								 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+                           const StreamBufferIOVec_t * const pxVecs,
+                           UBaseType_t uxVecCount,
+                           TickType_t xTicksToWait );
+
+size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+                                  const StreamBufferIOVec_t * const pxVecs,
+                                  UBaseType_t uxVecCount,
+                                  BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * As xStreamBufferSend() and xStreamBufferSendFromISR(), but the data is
+ * gathered from the uxVecCount pieces described by pxVecs, in order, instead
+ * of from one contiguous buffer.  Used with a message buffer the pieces form a
+ * single message, written whole or not at all, so a header can be prefixed to
+ * a payload without first copying both into a temporary buffer.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to which the data is
+ * being sent.
+ *
+ * @param pxVecs An array of uxVecCount pieces of data.  Pieces with a length
+ * of 0 are skipped.
+ *
+ * @param uxVecCount The number of entries in pxVecs.
+ *
+ * @return The number of bytes written to the stream buffer.
+ *
+ * \defgroup xStreamBufferSendV xStreamBufferSendV
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+						   const StreamBufferIOVec_t * const pxVecs,
+						   UBaseType_t uxVecCount,
+						   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+								  const StreamBufferIOVec_t * const pxVecs,
+								  UBaseType_t uxVecCount,
+								  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -590,6 +704,161 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 									size_t xBufferLengthBytes,
 									BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+                                    StreamBufferSpans_t * const pxSpans,
+                                    TickType_t xTicksToWait );
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           StreamBufferSpans_t * const pxSpans );
+
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xBytesConsumed );
+
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+                                         size_t xBytesConsumed,
+                                         BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * Gives the reader direct access to the bytes in a stream buffer so they can
+ * be parsed where they are instead of being copied out first.
+ *
+ * xStreamBufferReceiveAcquire() describes every byte currently in the buffer
+ * in *pxSpans, as one span or, if the data wraps around the end of the
+ * storage area, two.  The bytes remain in the buffer, and can be read until
+ * vStreamBufferReceiveRelease() is called to remove xBytesConsumed of them
+ * from the front.  Any bytes not released are returned again by the next
+ * acquire, along with any that have arrived since, so a parser can release
+ * complete lines or frames and leave a partial one in place.
+ *
+ * Releasing bytes frees space in the buffer, so may unblock a task waiting to
+ * write.  Use the FromISR() variants from an interrupt service routine.
+ *
+ * Only the single reader may call these functions, and it must not call
+ * xStreamBufferReceive() between an acquire and the matching release.  They
+ * can't be used with message buffers.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being read.
+ *
+ * @param pxSpans Filled in with the location and length of the bytes that
+ * can be read.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data if the buffer is empty.
+ *
+ * @param xBytesConsumed The number of bytes to remove from the front of the
+ * buffer.  Must not be more than the last acquire returned.
+ *
+ * @return The total number of bytes that can be read, the sum of
+ * pxSpans->xFirstLength and pxSpans->xSecondLength.
+ *
+ * Example use:
+<pre>
+void vAParserTask( StreamBufferHandle_t xStreamBuffer )
+{
+StreamBufferSpans_t xSpans;
+size_t xLineLength;
+
+    for( ;; )
+    {
+        // Wait for any bytes to arrive.
+        if( xStreamBufferReceiveAcquire( xStreamBuffer, &xSpans, portMAX_DELAY ) > 0 )
+        {
+            // Scan xSpans.pucFirst then xSpans.pucSecond for a line ending.
+            xLineLength = prvFindLine( &xSpans );
+
+            // Remove the line once it has been handled, leaving any partial
+            // line in the buffer until the rest of it arrives.
+            vStreamBufferReceiveRelease( xStreamBuffer, xLineLength );
+        }
+    }
+}
+</pre>
+ * \defgroup xStreamBufferReceiveAcquire xStreamBufferReceiveAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									StreamBufferSpans_t * const pxSpans,
+									TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesConsumed ) PRIVILEGED_FUNCTION;
+
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										 size_t xBytesConsumed,
+										 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+<pre>
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+                                 StreamBufferSpans_t * const pxSpans,
+                                 TickType_t xTicksToWait );
+
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+                                        StreamBufferSpans_t * const pxSpans );
+
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+                              size_t xBytesWritten );
+
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+                                     size_t xBytesWritten,
+                                     BaseType_t * const pxHigherPriorityTaskWoken );
+</pre>
+ *
+ * The writer's equivalent of xStreamBufferReceiveAcquire(), letting data be
+ * produced, or DMAed, directly into a stream buffer's storage area.
+ *
+ * xStreamBufferSendAcquire() describes all the free space in the buffer in
+ * *pxSpans, as one or two spans.  Once data has been written to the start of
+ * that space vStreamBufferSendCommit() adds the first xBytesWritten bytes of
+ * it to the buffer, which unblocks the reader if that takes the buffer to its
+ * trigger level.  Bytes are not visible to the reader until they are
+ * committed.
+ *
+ * Only the single writer may call these functions, and it must not call
+ * xStreamBufferSend() between an acquire and the matching commit.  They can't
+ * be used with message buffers or buffers created with
+ * xStreamBufferCreateMultiProducer().
+ *
+ * @param xStreamBuffer The handle of the stream buffer being written.
+ *
+ * @param pxSpans Filled in with the location and length of the space that can
+ * be written.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for space if the buffer is full.
+ *
+ * @param xBytesWritten The number of bytes written to the start of the
+ * acquired space.  Must not be more than the last acquire returned.
+ *
+ * @return The total number of bytes that can be written, the sum of
+ * pxSpans->xFirstLength and pxSpans->xSecondLength.
+ *
+ * \defgroup xStreamBufferSendAcquire xStreamBufferSendAcquire
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+								 StreamBufferSpans_t * const pxSpans,
+								 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+							  size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									 size_t xBytesWritten,
+									 BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -834,6 +1103,18 @@ BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuf
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
 /* Functions below here are not part of the public API. */
+UBaseType_t xStreamBufferSendMultipleV( StreamBufferHandle_t xStreamBuffer,
+										const StreamBufferIOVec_t * const pxVecs,
+										const UBaseType_t * const puxVecCounts,
+										UBaseType_t uxNumMessages,
+										TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+UBaseType_t xStreamBufferSendMultipleVFromISR( StreamBufferHandle_t xStreamBuffer,
+											   const StreamBufferIOVec_t * const pxVecs,
+											   const UBaseType_t * const puxVecCounts,
+											   UBaseType_t uxNumMessages,
+											   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
 												 size_t xTriggerLevelBytes,
 												 BaseType_t xIsMessageBuffer ) PRIVILEGED_FUNCTION;
@@ -196,3 +196,90 @@ List_t * const pxList = pxItemToRemove->pxContainer;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+
+	void vListInitialiseEventList( EventList_t * const pxEventList )
+	{
+	UBaseType_t uxPriority;
+
+		vListInitialise( &( pxEventList->xWaiters ) );
+
+		for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configMAX_PRIORITIES; uxPriority++ )
+		{
+			pxEventList->pxPriorityTail[ uxPriority ] = NULL;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vListInsertInEventList( EventList_t * const pxEventList, ListItem_t * const pxNewListItem )
+	{
+	List_t * const pxList = &( pxEventList->xWaiters );
+	const TickType_t xValueOfInsertion = pxNewListItem->xItemValue;
+	ListItem_t *pxIterator = ( ListItem_t * ) &( pxList->xListEnd ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+	UBaseType_t uxIndex;
+
+		listTEST_LIST_INTEGRITY( pxList );
+		listTEST_LIST_ITEM_INTEGRITY( pxNewListItem );
+
+		/* The new item goes after the last item of the same or a lower item
+		value, which is the tail of the nearest such value that has one.  If
+		there is none the new item goes at the head of the list. */
+		uxIndex = ( UBaseType_t ) xValueOfInsertion;
+		while( uxIndex > ( UBaseType_t ) 0U )
+		{
+			uxIndex--;
+
+			if( pxEventList->pxPriorityTail[ uxIndex ] != NULL )
+			{
+				pxIterator = pxEventList->pxPriorityTail[ uxIndex ];
+				break;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxNewListItem->pxNext = pxIterator->pxNext;
+		pxNewListItem->pxNext->pxPrevious = pxNewListItem;
+		pxNewListItem->pxPrevious = pxIterator;
+		pxIterator->pxNext = pxNewListItem;
+
+		pxNewListItem->pxContainer = pxList;
+		pxEventList->pxPriorityTail[ xValueOfInsertion - ( TickType_t ) 1U ] = pxNewListItem;
+
+		( pxList->uxNumberOfItems )++;
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxListRemoveFromEventList( ListItem_t * const pxItemToRemove )
+	{
+	/* The waiters list is the first member of the event list, so the event
+	list can be obtained from the list item too. */
+	EventList_t * const pxEventList = ( EventList_t * ) pxItemToRemove->pxContainer; /*lint !e9087 !e740 EventList_t starts with the List_t the item is in. */
+	const UBaseType_t uxIndex = ( UBaseType_t ) ( pxItemToRemove->xItemValue - ( TickType_t ) 1U );
+
+		if( pxEventList->pxPriorityTail[ uxIndex ] == pxItemToRemove )
+		{
+			/* The previous item becomes the tail if it has the same item value.
+			The list end marker never does, its value is portMAX_DELAY. */
+			if( pxItemToRemove->pxPrevious->xItemValue == pxItemToRemove->xItemValue )
+			{
+				pxEventList->pxPriorityTail[ uxIndex ] = pxItemToRemove->pxPrevious;
+			}
+			else
+			{
+				pxEventList->pxPriorityTail[ uxIndex ] = NULL;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return uxListRemove( pxItemToRemove );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
@@ -0,0 +1,527 @@
+/*
+ * FreeRTOS Kernel V10.3.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * An implementation of pvPortMalloc() and vPortFree() that divides the heap
+ * into pools of fixed size blocks, one pool per block size.  The block sizes
+ * are chosen to match the objects the kernel allocates - timers and event
+ * groups, queues and semaphores, message buffers, task control blocks and task
+ * stacks - so a
+ * request is served by a block that wastes little.  Each pool keeps its free
+ * blocks on a singly linked list, so allocating and freeing take a bounded
+ * time that does not depend on what else is allocated, and the heap can never
+ * fragment into free space too scattered to use.
+ *
+ * A request takes a block from the smallest pool its size fits.  If that pool
+ * has no free block the request spills into the next larger pool that does.
+ *
+ * Both functions mask interrupts rather than suspending the scheduler, so
+ * vPortFree() (and pvPortMalloc()) can be called from interrupts that are
+ * allowed to use the FreeRTOS API.
+ *
+ * The pools are carved out of a configTOTAL_HEAP_SIZE byte array on the first
+ * call to pvPortMalloc().  configHEAP_POOL_BLOCK_SIZES and
+ * configHEAP_POOL_BLOCK_COUNTS can be defined in FreeRTOSConfig.h as array
+ * initialisers, with one entry per pool, to change the pools.
+ *
+ * See http://www.FreeRTOS.org/a00111.html for the general purpose heap
+ * schemes this can be used in place of.
+ */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+	#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+/* By default there is a pool for each kind of object the kernel allocates.  A
+message buffer is allocated as one block holding the buffer structure and its
+storage, so its pool is sized for a buffer of a few short messages. */
+#ifndef configHEAP_POOL_BLOCK_SIZES
+	#define configHEAP_POOL_BLOCK_SIZES		{ sizeof( StaticTimer_t ),											\
+											  sizeof( StaticQueue_t ) + 64U,									\
+											  sizeof( StaticStreamBuffer_t ) + 128U,							\
+											  sizeof( StaticTask_t ),											\
+											  ( size_t ) configMINIMAL_STACK_SIZE * sizeof( StackType_t ),		\
+											  ( size_t ) configMINIMAL_STACK_SIZE * 2U * sizeof( StackType_t ) }
+	#define configHEAP_POOL_BLOCK_COUNTS	{ 8, 8, 4, 6, 6, 4 }
+#endif
+
+/* Every block is aligned, and big enough to hold the free list link. */
+#define heapMINIMUM_BLOCK_SIZE	( ( size_t ) sizeof( FreeBlock_t ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if( configAPPLICATION_ALLOCATED_HEAP == 1 )
+	/* The application writer has already defined the array used for the RTOS
+	heap - probably so it can be placed in a special segment or address. */
+	extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+	static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* A free block holds the link to the next free block in the same pool. */
+typedef struct A_FREE_BLOCK
+{
+	struct A_FREE_BLOCK *pxNextFreeBlock;
+} FreeBlock_t;
+
+typedef struct A_POOL
+{
+	uint8_t *pucStart;				/*< First byte of the pool's blocks. */
+	uint8_t *pucEnd;				/*< First byte after the pool's blocks. */
+	FreeBlock_t *pxFreeBlocks;		/*< NULL when every block is in use. */
+	HeapPoolStats_t xStats;
+} Pool_t;
+
+/*
+ * Carves the heap into the pools, ordered from the smallest block size to the
+ * largest.
+ */
+static void prvHeapInit( void );
+
+/*-----------------------------------------------------------*/
+
+static const size_t xConfiguredBlockSizes[] = configHEAP_POOL_BLOCK_SIZES;
+static const UBaseType_t uxConfiguredBlockCounts[] = configHEAP_POOL_BLOCK_COUNTS;
+
+#define heapNUM_POOLS	( sizeof( xConfiguredBlockSizes ) / sizeof( xConfiguredBlockSizes[ 0 ] ) )
+
+static Pool_t xPools[ heapNUM_POOLS ];
+static BaseType_t xHeapInitialised = pdFALSE;
+
+/* Keeps track of the free bytes across all the pools, in whole blocks. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+void *pvReturn = NULL;
+UBaseType_t uxSavedInterruptStatus;
+UBaseType_t uxPool;
+Pool_t *pxFirstFit = NULL;
+FreeBlock_t *pxBlock;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( xHeapInitialised == pdFALSE )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( xWantedSize > ( size_t ) 0 )
+		{
+			/* The pools are in size order, so the first with a free block
+			that fits is the one that wastes least. */
+			for( uxPool = 0; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+			{
+				if( xPools[ uxPool ].xStats.xBlockSize >= xWantedSize )
+				{
+					if( pxFirstFit == NULL )
+					{
+						pxFirstFit = &( xPools[ uxPool ] );
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+
+					if( xPools[ uxPool ].pxFreeBlocks != NULL )
+					{
+						break;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			if( uxPool < ( UBaseType_t ) heapNUM_POOLS )
+			{
+				Pool_t * const pxPool = &( xPools[ uxPool ] );
+
+				pxBlock = pxPool->pxFreeBlocks;
+				pxPool->pxFreeBlocks = pxBlock->pxNextFreeBlock;
+				pvReturn = ( void * ) pxBlock;
+
+				pxPool->xStats.uxBlocksFree--;
+				if( pxPool->xStats.uxBlocksFree < pxPool->xStats.uxMinimumEverBlocksFree )
+				{
+					pxPool->xStats.uxMinimumEverBlocksFree = pxPool->xStats.uxBlocksFree;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxPool->xStats.ulAllocations++;
+				pxPool->xStats.ulBytesRequested += ( uint32_t ) xWantedSize;
+				if( pxPool != pxFirstFit )
+				{
+					pxPool->xStats.ulSpilled++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xFreeBytesRemaining -= pxPool->xStats.xBlockSize;
+				if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+				{
+					xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				xNumberOfSuccessfulAllocations++;
+			}
+			else
+			{
+				/* A request too big for any pool counts against the largest. */
+				if( pxFirstFit == NULL )
+				{
+					pxFirstFit = &( xPools[ heapNUM_POOLS - 1U ] );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				pxFirstFit->xStats.ulFailed++;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( ( pvReturn == NULL ) && ( xWantedSize > ( size_t ) 0 ) )
+		{
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+uint8_t *puc = ( uint8_t * ) pv;
+UBaseType_t uxSavedInterruptStatus;
+UBaseType_t uxPool;
+FreeBlock_t *pxBlock;
+
+	if( pv != NULL )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			/* The pool a block belongs to is found from its address, blocks
+			carry no header. */
+			for( uxPool = 0; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+			{
+				if( ( puc >= xPools[ uxPool ].pucStart ) && ( puc < xPools[ uxPool ].pucEnd ) )
+				{
+					break;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+
+			/* The memory being freed must have come from pvPortMalloc(), and
+			must be the start of the block. */
+			configASSERT( uxPool < ( UBaseType_t ) heapNUM_POOLS );
+
+			if( uxPool < ( UBaseType_t ) heapNUM_POOLS )
+			{
+				Pool_t * const pxPool = &( xPools[ uxPool ] );
+
+				configASSERT( ( ( size_t ) ( puc - pxPool->pucStart ) % pxPool->xStats.xBlockSize ) == 0 );
+				configASSERT( pxPool->xStats.uxBlocksFree < pxPool->xStats.uxNumBlocks );
+
+				pxBlock = ( FreeBlock_t * ) pv; /*lint !e9087 !e826 Blocks are aligned for a FreeBlock_t. */
+				pxBlock->pxNextFreeBlock = pxPool->pxFreeBlocks;
+				pxPool->pxFreeBlocks = pxBlock;
+
+				pxPool->xStats.uxBlocksFree++;
+				pxPool->xStats.ulFrees++;
+				xFreeBytesRemaining += pxPool->xStats.xBlockSize;
+				xNumberOfSuccessfulFrees++;
+
+				traceFREE( pv, pxPool->xStats.xBlockSize );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetHeapPoolCount( void )
+{
+	return ( UBaseType_t ) heapNUM_POOLS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetHeapPoolStats( UBaseType_t uxPool, HeapPoolStats_t *pxPoolStats )
+{
+BaseType_t xReturn = pdFALSE;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( pxPoolStats );
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( xHeapInitialised == pdFALSE )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( uxPool < ( UBaseType_t ) heapNUM_POOLS )
+		{
+			*pxPoolStats = xPools[ uxPool ].xStats;
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+UBaseType_t uxSavedInterruptStatus;
+UBaseType_t uxPool;
+
+	pxHeapStats->xSizeOfLargestFreeBlockInBytes = 0U;
+	pxHeapStats->xSizeOfSmallestFreeBlockInBytes = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+	pxHeapStats->xNumberOfFreeBlocks = 0U;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( xHeapInitialised == pdFALSE )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		for( uxPool = 0; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+		{
+			const HeapPoolStats_t * const pxStats = &( xPools[ uxPool ].xStats );
+
+			if( pxStats->uxBlocksFree > ( UBaseType_t ) 0 )
+			{
+				pxHeapStats->xNumberOfFreeBlocks += ( size_t ) pxStats->uxBlocksFree;
+
+				if( pxStats->xBlockSize > pxHeapStats->xSizeOfLargestFreeBlockInBytes )
+				{
+					pxHeapStats->xSizeOfLargestFreeBlockInBytes = pxStats->xBlockSize;
+				}
+
+				if( pxStats->xBlockSize < pxHeapStats->xSizeOfSmallestFreeBlockInBytes )
+				{
+					pxHeapStats->xSizeOfSmallestFreeBlockInBytes = pxStats->xBlockSize;
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+UBaseType_t uxPool, uxSorted, uxBlock, uxNumBlocks;
+size_t xAddress, xBlockSize, xHeapBytes, xTotalPoolBytes = 0U;
+BaseType_t xPoolsFit;
+uint8_t *pucNext;
+Pool_t xPool;
+
+	/* Every pool needs both a block size and a block count. */
+	configASSERT( heapNUM_POOLS == ( sizeof( uxConfiguredBlockCounts ) / sizeof( uxConfiguredBlockCounts[ 0 ] ) ) );
+
+	/* Ensure the pools start on a correctly aligned boundary. */
+	xAddress = ( size_t ) ucHeap;
+	xAddress = ( xAddress + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+	pucNext = ( uint8_t * ) xAddress;
+	xHeapBytes = ( size_t ) configTOTAL_HEAP_SIZE - ( size_t ) ( pucNext - ucHeap );
+
+	/* Size every pool before anything is written to the heap.  Each block is
+	rounded up so the next one is aligned too. */
+	for( uxPool = 0; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+	{
+		xBlockSize = xConfiguredBlockSizes[ uxPool ];
+		if( xBlockSize < heapMINIMUM_BLOCK_SIZE )
+		{
+			xBlockSize = heapMINIMUM_BLOCK_SIZE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		xBlockSize = ( xBlockSize + ( size_t ) portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+		xPools[ uxPool ].xStats.xBlockSize = xBlockSize;
+		xTotalPoolBytes += ( size_t ) uxConfiguredBlockCounts[ uxPool ] * xBlockSize;
+	}
+
+	/* The pools must fit in the heap.  If they don't, and configASSERT() is
+	not defined, the pools are left empty so every allocation fails rather than
+	the free lists being written past the end of the heap. */
+	xPoolsFit = ( xTotalPoolBytes <= xHeapBytes ) ? pdTRUE : pdFALSE;
+	configASSERT( xPoolsFit );
+
+	for( uxPool = 0; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+	{
+		xBlockSize = xPools[ uxPool ].xStats.xBlockSize;
+		uxNumBlocks = ( xPoolsFit != pdFALSE ) ? uxConfiguredBlockCounts[ uxPool ] : ( UBaseType_t ) 0;
+
+		xPools[ uxPool ].pucStart = pucNext;
+		xPools[ uxPool ].pxFreeBlocks = NULL;
+		xPools[ uxPool ].xStats.uxNumBlocks = uxNumBlocks;
+		xPools[ uxPool ].xStats.uxBlocksFree = uxNumBlocks;
+		xPools[ uxPool ].xStats.uxMinimumEverBlocksFree = uxNumBlocks;
+		xPools[ uxPool ].xStats.ulAllocations = 0U;
+		xPools[ uxPool ].xStats.ulFrees = 0U;
+		xPools[ uxPool ].xStats.ulSpilled = 0U;
+		xPools[ uxPool ].xStats.ulFailed = 0U;
+		xPools[ uxPool ].xStats.ulBytesRequested = 0U;
+
+		/* Link the blocks into the free list so the lowest address is handed
+		out first. */
+		for( uxBlock = uxNumBlocks; uxBlock > ( UBaseType_t ) 0; uxBlock-- )
+		{
+			FreeBlock_t * const pxBlock = ( FreeBlock_t * ) &( pucNext[ ( uxBlock - 1U ) * xBlockSize ] ); /*lint !e9087 !e826 Blocks are aligned for a FreeBlock_t. */
+			pxBlock->pxNextFreeBlock = xPools[ uxPool ].pxFreeBlocks;
+			xPools[ uxPool ].pxFreeBlocks = pxBlock;
+		}
+
+		pucNext += ( size_t ) uxNumBlocks * xBlockSize;
+		xPools[ uxPool ].pucEnd = pucNext;
+		xFreeBytesRemaining += ( size_t ) uxNumBlocks * xBlockSize;
+	}
+
+	/* Sort the pools by block size, there are only a handful of them. */
+	for( uxPool = 1; uxPool < ( UBaseType_t ) heapNUM_POOLS; uxPool++ )
+	{
+		xPool = xPools[ uxPool ];
+		for( uxSorted = uxPool; ( uxSorted > ( UBaseType_t ) 0 ) && ( xPools[ uxSorted - 1U ].xStats.xBlockSize > xPool.xStats.xBlockSize ); uxSorted-- )
+		{
+			xPools[ uxSorted ] = xPools[ uxSorted - 1U ];
+		}
+		xPools[ uxSorted ] = xPool;
+	}
+
+	xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+	xHeapInitialised = pdTRUE;
+}
@@ -105,8 +105,8 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		SemaphoreData_t xSemaphore; /*< Data required exclusively when this structure is used as a semaphore. */
 	} u;
 
-	List_t xTasksWaitingToSend;		/*< List of tasks that are blocked waiting to post onto this queue.  Stored in priority order. */
-	List_t xTasksWaitingToReceive;	/*< List of tasks that are blocked waiting to read from this queue.  Stored in priority order. */
+	EventList_t xTasksWaitingToSend;		/*< List of tasks that are blocked waiting to post onto this queue.  Stored in priority order. */
+	EventList_t xTasksWaitingToReceive;	/*< List of tasks that are blocked waiting to read from this queue.  Stored in priority order. */
 
 	volatile UBaseType_t uxMessagesWaiting;/*< The number of items currently in the queue. */
 	UBaseType_t uxLength;			/*< The length of the queue defined as the number of items it will hold, not the number of bytes. */
@@ -123,11 +123,21 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		struct QueueDefinition *pxQueueSetContainer;
 	#endif
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+		int8_t *pcReservedSlot;		/*< The slot handed out by xQueueReserve() that has not yet been committed, or NULL. */
+		int8_t *pcAcquiredItem;		/*< The item handed out by xQueueAcquire() that has not yet been released, or NULL. */
+	#endif
+
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxQueueNumber;
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_STATS == 1 )
+		QueueStats_t xStats;		/*< Usage statistics, uxLength is only filled in when they are copied out. */
+		uint32_t *pulEnqueueTimes;	/*< When the item in each slot was sent, or NULL if the queue has no room to record it. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -181,11 +191,12 @@ static void prvUnlockQueue( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 static BaseType_t prvIsQueueEmpty( const Queue_t *pxQueue ) PRIVILEGED_FUNCTION;
 
 /*
- * Uses a critical section to determine if there is any space in a queue.
+ * Uses a critical section to determine if there is any space in a queue for an
+ * item sent to the position xCopyPosition.
  *
  * @return pdTRUE if there is no space, otherwise pdFALSE;
  */
-static BaseType_t prvIsQueueFull( const Queue_t *pxQueue ) PRIVILEGED_FUNCTION;
+static BaseType_t prvIsQueueFull( const Queue_t *pxQueue, const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 
 /*
  * Copies an item into the queue, either at the front of the queue or the
@@ -206,6 +217,58 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 	static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	/*
+	 * Unblocks the highest priority task waiting to receive from the queue, or
+	 * notifies the queue set the queue is a member of.  Must be called from a
+	 * critical section with the queue unlocked.
+	 *
+	 * @return pdTRUE if a task with a higher priority than the calling task was
+	 * unblocked, otherwise pdFALSE.
+	 */
+	static BaseType_t prvUnblockReceiver( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Unblocks the highest priority task waiting to send to the queue.  Must be
+	 * called from a critical section with the queue unlocked.
+	 *
+	 * @return pdTRUE if a task with a higher priority than the calling task was
+	 * unblocked, otherwise pdFALSE.
+	 */
+	static BaseType_t prvUnblockSender( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	/*
+	 * Makes the reserved slot at the write position visible to receivers.
+	 */
+	static void prvCommitReservedSlot( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Removes the item at the read position from the count of waiting items
+	 * without copying it, leaving its slot occupied until it is released.
+	 */
+	static void *prvAcquireItem( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_STATS == 1 )
+	/*
+	 * Record the statistics for uxNumItems items that have been added to the
+	 * front or back of the queue, or removed from the front of the queue.  Must
+	 * be called from a critical section after uxMessagesWaiting and the
+	 * queue's pointers have been updated.
+	 */
+	static void prvStatsItemsAdded( Queue_t * const pxQueue, const BaseType_t xPosition, const UBaseType_t uxNumItems ) PRIVILEGED_FUNCTION;
+	static void prvStatsItemsRemoved( Queue_t * const pxQueue, const UBaseType_t uxNumItems ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Record the outcome of a send from a task.  xWaited is pdTRUE if the task
+	 * found the queue full at least once, in which case ulWaitStart is when it
+	 * first did.
+	 */
+	static void prvStatsSendReturned( Queue_t * const pxQueue, const BaseType_t xSent, const BaseType_t xWaited, const uint32_t ulWaitStart ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -252,6 +315,59 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	taskEXIT_CRITICAL()
 /*-----------------------------------------------------------*/
 
+/*
+ * Macros that record queue statistics, see prvStatsItemsAdded() and friends.
+ * They expand to nothing when statistics are not being kept, so the variables
+ * they use only need to exist when configUSE_QUEUE_STATS is 1.
+ */
+#if ( configUSE_QUEUE_STATS == 1 )
+	#define queueSTATS_ITEMS_ADDED( pxQueue, xPosition, uxNumItems )			prvStatsItemsAdded( ( pxQueue ), ( xPosition ), ( uxNumItems ) )
+	#define queueSTATS_ITEMS_REMOVED( pxQueue, uxNumItems )						prvStatsItemsRemoved( ( pxQueue ), ( uxNumItems ) )
+	#define queueSTATS_WAIT_STARTED( ulWaitStart )								( ulWaitStart ) = configQUEUE_STATS_TIMESTAMP()
+	#define queueSTATS_SEND_RETURNED( pxQueue, xSent, xWaited, ulWaitStart )	prvStatsSendReturned( ( pxQueue ), ( xSent ), ( xWaited ), ( ulWaitStart ) )
+	#define queueSTATS_SEND_FAILED_FROM_ISR( pxQueue )							( ( pxQueue )->xStats.ulSendFailedFromISR++ )
+#else
+	#define queueSTATS_ITEMS_ADDED( pxQueue, xPosition, uxNumItems )
+	#define queueSTATS_ITEMS_REMOVED( pxQueue, uxNumItems )
+	#define queueSTATS_WAIT_STARTED( ulWaitStart )
+	#define queueSTATS_SEND_RETURNED( pxQueue, xSent, xWaited, ulWaitStart )
+	#define queueSTATS_SEND_FAILED_FROM_ISR( pxQueue )
+#endif
+/*-----------------------------------------------------------*/
+
+/*
+ * Macro to test if an item can be posted to the queue at xCopyPosition.  Must
+ * be called from a critical section.
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	/* A reserved slot is the slot at pcWriteTo, so nothing else can be posted
+	until it has been committed.  An acquired item is no longer counted in
+	uxMessagesWaiting but still occupies the slot at pcReadFrom, so it reduces
+	the space available, and items cannot be sent to the front (which writes to
+	pcReadFrom) until it has been released. */
+	#define prvQueueCanSend( pxQueue, xCopyPosition )																			\
+		( ( ( pxQueue )->pcReservedSlot == NULL ) &&																		\
+		  ( ( ( pxQueue )->pcAcquiredItem == NULL ) ?																		\
+			( ( ( pxQueue )->uxMessagesWaiting < ( pxQueue )->uxLength ) || ( ( xCopyPosition ) == queueOVERWRITE ) ) :		\
+			( ( ( xCopyPosition ) == queueSEND_TO_BACK ) && ( ( ( pxQueue )->uxMessagesWaiting + ( UBaseType_t ) 1 ) < ( pxQueue )->uxLength ) ) ) )
+#else
+	#define prvQueueCanSend( pxQueue, xCopyPosition ) \
+		( ( ( pxQueue )->uxMessagesWaiting < ( pxQueue )->uxLength ) || ( ( xCopyPosition ) == queueOVERWRITE ) )
+#endif
+
+/*
+ * Macro that evaluates to the number of items that can be sent to the back of
+ * the queue.  Must be called from a critical section.
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	#define prvQueueSpaces( pxQueue )																							\
+		( ( ( pxQueue )->pcReservedSlot != NULL ) ? ( UBaseType_t ) 0 :													\
+		  ( ( pxQueue )->uxLength - ( pxQueue )->uxMessagesWaiting - ( ( ( pxQueue )->pcAcquiredItem != NULL ) ? ( UBaseType_t ) 1 : ( UBaseType_t ) 0 ) ) )
+#else
+	#define prvQueueSpaces( pxQueue ) ( ( pxQueue )->uxLength - ( pxQueue )->uxMessagesWaiting )
+#endif
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue, BaseType_t xNewQueue )
 {
 Queue_t * const pxQueue = xQueue;
@@ -267,6 +383,13 @@ Queue_t * const pxQueue = xQueue;
 		pxQueue->cRxLock = queueUNLOCKED;
 		pxQueue->cTxLock = queueUNLOCKED;
 
+		#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+		{
+			pxQueue->pcReservedSlot = NULL;
+			pxQueue->pcAcquiredItem = NULL;
+		}
+		#endif
+
 		if( xNewQueue == pdFALSE )
 		{
 			/* If there are tasks blocked waiting to read from the queue, then
@@ -274,7 +397,7 @@ Queue_t * const pxQueue = xQueue;
 			will still be empty.  If there are tasks blocked waiting to write to
 			the queue, then one should be unblocked as after this function exits
 			it will be possible to write to it. */
-			if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+			if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
 			{
 				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 				{
@@ -293,8 +416,8 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			/* Ensure the event queues start in the correct state. */
-			vListInitialise( &( pxQueue->xTasksWaitingToSend ) );
-			vListInitialise( &( pxQueue->xTasksWaitingToReceive ) );
+			vListInitialiseEventList( &( pxQueue->xTasksWaitingToSend ) );
+			vListInitialiseEventList( &( pxQueue->xTasksWaitingToReceive ) );
 		}
 	}
 	taskEXIT_CRITICAL();
@@ -370,6 +493,9 @@ Queue_t * const pxQueue = xQueue;
 	Queue_t *pxNewQueue;
 	size_t xQueueSizeInBytes;
 	uint8_t *pucQueueStorage;
+	#if ( configUSE_QUEUE_STATS == 1 )
+		size_t xEnqueueTimesOffset = 0;
+	#endif
 
 		configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
 
@@ -378,6 +504,18 @@ Queue_t * const pxQueue = xQueue;
 		zero in the case the queue is used as a semaphore. */
 		xQueueSizeInBytes = ( size_t ) ( uxQueueLength * uxItemSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
+		#if ( configUSE_QUEUE_STATS == 1 )
+		{
+			/* Queues that hold items also get a timestamp per slot, after the
+			item storage and aligned for a uint32_t, to measure latency. */
+			if( uxItemSize != ( UBaseType_t ) 0 )
+			{
+				xEnqueueTimesOffset = ( xQueueSizeInBytes + ( sizeof( uint32_t ) - 1U ) ) & ~( sizeof( uint32_t ) - 1U );
+				xQueueSizeInBytes = xEnqueueTimesOffset + ( ( size_t ) uxQueueLength * sizeof( uint32_t ) );
+			}
+		}
+		#endif
+
 		/* Allocate the queue and storage area.  Justification for MISRA
 		deviation as follows:  pvPortMalloc() always ensures returned memory
 		blocks are aligned per the requirements of the MCU stack.  In this case
@@ -406,6 +544,15 @@ Queue_t * const pxQueue = xQueue;
 			#endif /* configSUPPORT_STATIC_ALLOCATION */
 
 			prvInitialiseNewQueue( uxQueueLength, uxItemSize, pucQueueStorage, ucQueueType, pxNewQueue );
+
+			#if ( configUSE_QUEUE_STATS == 1 )
+			{
+				if( uxItemSize != ( UBaseType_t ) 0 )
+				{
+					pxNewQueue->pulEnqueueTimes = ( uint32_t * ) &( pucQueueStorage[ xEnqueueTimesOffset ] ); /*lint !e9087 !e826 The offset is aligned for a uint32_t. */
+				}
+			}
+			#endif
 		}
 		else
 		{
@@ -457,6 +604,16 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if ( configUSE_QUEUE_STATS == 1 )
+	{
+		/* Only xQueueGenericCreate() makes room for enqueue times, and it
+		sets the pointer once this returns.  Statically created queues are
+		given them by vQueueSetEnqueueTimes(). */
+		( void ) memset( ( void * ) &( pxNewQueue->xStats ), 0x00, sizeof( pxNewQueue->xStats ) );
+		pxNewQueue->pulEnqueueTimes = NULL;
+	}
+	#endif /* configUSE_QUEUE_STATS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -742,6 +899,9 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue, const void * const pvItemToQ
 BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
+#if ( configUSE_QUEUE_STATS == 1 )
+	uint32_t ulWaitStart = 0;
+#endif
 
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
@@ -764,7 +924,7 @@ Queue_t * const pxQueue = xQueue;
 			highest priority task wanting to access the queue.  If the head item
 			in the queue is to be overwritten then it does not matter if the
 			queue is full. */
-			if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+			if( prvQueueCanSend( pxQueue, xCopyPosition ) )
 			{
 				traceQUEUE_SEND( pxQueue );
 
@@ -799,7 +959,7 @@ Queue_t * const pxQueue = xQueue;
 					{
 						/* If there was a task waiting for data to arrive on the
 						queue then unblock it now. */
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -834,7 +994,7 @@ Queue_t * const pxQueue = xQueue;
 
 					/* If there was a task waiting for data to arrive on the
 					queue then unblock it now. */
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -864,6 +1024,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#endif /* configUSE_QUEUE_SETS */
 
+				queueSTATS_SEND_RETURNED( pxQueue, pdTRUE, xEntryTimeSet, ulWaitStart );
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -878,6 +1039,7 @@ Queue_t * const pxQueue = xQueue;
 					/* Return to the original privilege level before exiting
 					the function. */
 					traceQUEUE_SEND_FAILED( pxQueue );
+					queueSTATS_SEND_RETURNED( pxQueue, pdFALSE, xEntryTimeSet, ulWaitStart );
 					return errQUEUE_FULL;
 				}
 				else if( xEntryTimeSet == pdFALSE )
@@ -886,6 +1048,7 @@ Queue_t * const pxQueue = xQueue;
 					configure the timeout structure. */
 					vTaskInternalSetTimeOutState( &xTimeOut );
 					xEntryTimeSet = pdTRUE;
+					queueSTATS_WAIT_STARTED( ulWaitStart );
 				}
 				else
 				{
@@ -905,7 +1068,7 @@ Queue_t * const pxQueue = xQueue;
 		/* Update the timeout state to see if it has expired yet. */
 		if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
 		{
-			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			if( prvIsQueueFull( pxQueue, xCopyPosition ) != pdFALSE )
 			{
 				traceBLOCKING_ON_QUEUE_SEND( pxQueue );
 				vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
@@ -941,6 +1104,7 @@ Queue_t * const pxQueue = xQueue;
 			( void ) xTaskResumeAll();
 
 			traceQUEUE_SEND_FAILED( pxQueue );
+			queueSTATS_SEND_RETURNED( pxQueue, pdFALSE, xEntryTimeSet, ulWaitStart );
 			return errQUEUE_FULL;
 		}
 	} /*lint -restore */
@@ -980,7 +1144,7 @@ Queue_t * const pxQueue = xQueue;
 	post). */
 	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 	{
-		if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+		if( prvQueueCanSend( pxQueue, xCopyPosition ) )
 		{
 			const int8_t cTxLock = pxQueue->cTxLock;
 			const UBaseType_t uxPreviousMessagesWaiting = pxQueue->uxMessagesWaiting;
@@ -1030,7 +1194,7 @@ Queue_t * const pxQueue = xQueue;
 					}
 					else
 					{
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -1058,7 +1222,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#else /* configUSE_QUEUE_SETS */
 				{
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -1100,6 +1264,7 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED_FROM_ISR( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1198,7 +1363,7 @@ Queue_t * const pxQueue = xQueue;
 					}
 					else
 					{
-						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+						if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 						{
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
@@ -1226,7 +1391,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#else /* configUSE_QUEUE_SETS */
 				{
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -1265,6 +1430,7 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED_FROM_ISR( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1287,6 +1453,14 @@ Queue_t * const pxQueue = xQueue;
 	is zero (so no data is copied into the buffer. */
 	configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	{
+		/* The slot of an acquired item would be counted as free once another
+		item had been removed, and a send could overwrite it. */
+		configASSERT( pxQueue->pcAcquiredItem == NULL );
+	}
+	#endif
+
 	/* Cannot block if the scheduler is suspended. */
 	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 	{
@@ -1312,11 +1486,12 @@ Queue_t * const pxQueue = xQueue;
 				prvCopyDataFromQueue( pxQueue, pvBuffer );
 				traceQUEUE_RECEIVE( pxQueue );
 				pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
+				queueSTATS_ITEMS_REMOVED( pxQueue, ( UBaseType_t ) 1 );
 
 				/* There is now space in the queue, were any tasks waiting to
 				post to the queue?  If so, unblock the highest priority waiting
 				task. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
@@ -1478,7 +1653,7 @@ Queue_t * const pxQueue = xQueue;
 
 				/* Check to see if other tasks are blocked waiting to give the
 				semaphore, and if so, unblock the highest priority such task. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
@@ -1647,6 +1822,13 @@ Queue_t * const pxQueue = xQueue;
 	is zero (so no data is copied into the buffer. */
 	configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	{
+		/* See xQueueReceive(). */
+		configASSERT( pxQueue->pcAcquiredItem == NULL );
+	}
+	#endif
+
 	/* Cannot block if the scheduler is suspended. */
 	#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
 	{
@@ -1681,7 +1863,7 @@ Queue_t * const pxQueue = xQueue;
 
 				/* The data is being left in the queue, so see if there are
 				any other tasks waiting for the data. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
@@ -1791,6 +1973,13 @@ Queue_t * const pxQueue = xQueue;
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	{
+		/* See xQueueReceive(). */
+		configASSERT( pxQueue->pcAcquiredItem == NULL );
+	}
+	#endif
+
 	/* RTOS ports that support interrupt nesting have the concept of a maximum
 	system call (or maximum API call) interrupt priority.  Interrupts that are
 	above the maximum system call priority are kept permanently enabled, even
@@ -1820,6 +2009,7 @@ Queue_t * const pxQueue = xQueue;
 
 			prvCopyDataFromQueue( pxQueue, pvBuffer );
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting - ( UBaseType_t ) 1;
+			queueSTATS_ITEMS_REMOVED( pxQueue, ( UBaseType_t ) 1 );
 
 			/* If the queue is locked the event list will not be modified.
 			Instead update the lock count so the task that unlocks the queue
@@ -1827,7 +2017,7 @@ Queue_t * const pxQueue = xQueue;
 			locked. */
 			if( cRxLock == queueUNLOCKED )
 			{
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
@@ -1884,6 +2074,13 @@ Queue_t * const pxQueue = xQueue;
 	configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 	configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
 
+	#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+	{
+		/* See xQueueReceive(). */
+		configASSERT( pxQueue->pcAcquiredItem == NULL );
+	}
+	#endif
+
 	/* RTOS ports that support interrupt nesting have the concept of a maximum
 	system call (or maximum API call) interrupt priority.  Interrupts that are
 	above the maximum system call priority are kept permanently enabled, even
@@ -1927,149 +2124,606 @@ Queue_t * const pxQueue = xQueue;
 }
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
-
-	configASSERT( xQueue );
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
 
-	taskENTER_CRITICAL();
+	BaseType_t xQueueReserve( QueueHandle_t xQueue, void ** const ppvSlot, TickType_t xTicksToWait )
 	{
-		uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
-	}
-	taskEXIT_CRITICAL();
-
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
-
-UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
-Queue_t * const pxQueue = xQueue;
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
+	#if ( configUSE_QUEUE_STATS == 1 )
+		uint32_t ulWaitStart = 0;
+	#endif
 
-	configASSERT( pxQueue );
+		configASSERT( pxQueue );
+		configASSERT( ppvSlot );
 
-	taskENTER_CRITICAL();
-	{
-		uxReturn = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
-	}
-	taskEXIT_CRITICAL();
+		/* Semaphores have no storage to reserve. */
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
 
-UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
-{
-UBaseType_t uxReturn;
-Queue_t * const pxQueue = xQueue;
+		/*lint -save -e904 This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( prvQueueCanSend( pxQueue, queueSEND_TO_BACK ) )
+				{
+					/* Hand out the slot the next item would have been copied
+					into.  Receivers cannot see it until it is committed. */
+					pxQueue->pcReservedSlot = pxQueue->pcWriteTo;
+					*ppvSlot = ( void * ) pxQueue->pcReservedSlot;
 
-	configASSERT( pxQueue );
-	uxReturn = pxQueue->uxMessagesWaiting;
+					queueSTATS_SEND_RETURNED( pxQueue, pdTRUE, xEntryTimeSet, ulWaitStart );
+					taskEXIT_CRITICAL();
+					return pdPASS;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_SEND_FAILED( pxQueue );
+						queueSTATS_SEND_RETURNED( pxQueue, pdFALSE, xEntryTimeSet, ulWaitStart );
+						return errQUEUE_FULL;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+						queueSTATS_WAIT_STARTED( ulWaitStart );
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
 
-	return uxReturn;
-} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
-/*-----------------------------------------------------------*/
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
 
-void vQueueDelete( QueueHandle_t xQueue )
-{
-Queue_t * const pxQueue = xQueue;
+			/* Blocks in the same way as xQueueGenericSend(). */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
 
-	configASSERT( pxQueue );
-	traceQUEUE_DELETE( pxQueue );
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+				}
+				else
+				{
+					/* Try again. */
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				/* The timeout has expired. */
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
 
-	#if ( configQUEUE_REGISTRY_SIZE > 0 )
-	{
-		vQueueUnregisterQueue( pxQueue );
+				traceQUEUE_SEND_FAILED( pxQueue );
+				queueSTATS_SEND_RETURNED( pxQueue, pdFALSE, xEntryTimeSet, ulWaitStart );
+				return errQUEUE_FULL;
+			}
+		} /*lint -restore */
 	}
-	#endif
+	/*-----------------------------------------------------------*/
 
-	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
-	{
-		/* The queue can only have been allocated dynamically - free it
-		again. */
-		vPortFree( pxQueue );
-	}
-	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
-	{
-		/* The queue could have been allocated statically or dynamically, so
-		check before attempting to free the memory. */
-		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
-		{
-			vPortFree( pxQueue );
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
-	}
-	#else
+	void vQueueCommit( QueueHandle_t xQueue )
 	{
-		/* The queue must have been statically allocated, so is not going to be
-		deleted.  Avoid compiler warnings about the unused parameter. */
-		( void ) pxQueue;
-	}
-	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-}
-/*-----------------------------------------------------------*/
+	Queue_t * const pxQueue = xQueue;
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+		configASSERT( pxQueue );
 
-	UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
-	{
-		return ( ( Queue_t * ) xQueue )->uxQueueNumber;
-	}
+		taskENTER_CRITICAL();
+		{
+			configASSERT( pxQueue->pcReservedSlot != NULL );
 
-#endif /* configUSE_TRACE_FACILITY */
-/*-----------------------------------------------------------*/
+			traceQUEUE_SEND( pxQueue );
+			prvCommitReservedSlot( pxQueue );
 
-#if ( configUSE_TRACE_FACILITY == 1 )
+			if( prvUnblockReceiver( pxQueue ) != pdFALSE )
+			{
+				queueYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
 
-	void vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber )
-	{
-		( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
+			/* Other senders were held off while the slot was reserved. */
+			if( prvQueueCanSend( pxQueue, queueSEND_TO_BACK ) && ( prvUnblockSender( pxQueue ) != pdFALSE ) )
+			{
+				queueYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* configUSE_TRACE_FACILITY */
-/*-----------------------------------------------------------*/
-
-#if ( configUSE_TRACE_FACILITY == 1 )
-
-	uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
+	BaseType_t xQueueReserveFromISR( QueueHandle_t xQueue, void ** const ppvSlot )
 	{
-		return ( ( Queue_t * ) xQueue )->ucQueueType;
-	}
-
-#endif /* configUSE_TRACE_FACILITY */
-/*-----------------------------------------------------------*/
+	BaseType_t xReturn;
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = xQueue;
 
-#if( configUSE_MUTEXES == 1 )
+		configASSERT( pxQueue );
+		configASSERT( ppvSlot );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
-	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue )
-	{
-	UBaseType_t uxHighestPriorityOfWaitingTasks;
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-		/* If a task waiting for a mutex causes the mutex holder to inherit a
-		priority, but the waiting task times out, then the holder should
-		disinherit the priority - but only down to the highest priority of any
-		other tasks that are waiting for the same mutex.  For this purpose,
-		return the priority of the highest priority task that is waiting for the
-		mutex. */
-		if( listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) > 0U )
-		{
-			uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxQueue->xTasksWaitingToReceive ) );
-		}
-		else
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+			if( prvQueueCanSend( pxQueue, queueSEND_TO_BACK ) )
+			{
+				pxQueue->pcReservedSlot = pxQueue->pcWriteTo;
+				*ppvSlot = ( void * ) pxQueue->pcReservedSlot;
+				xReturn = pdPASS;
+			}
+			else
+			{
+				traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+				queueSTATS_SEND_FAILED_FROM_ISR( pxQueue );
+				xReturn = errQUEUE_FULL;
+			}
 		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-		return uxHighestPriorityOfWaitingTasks;
+		return xReturn;
 	}
+	/*-----------------------------------------------------------*/
 
-#endif /* configUSE_MUTEXES */
-/*-----------------------------------------------------------*/
+	void vQueueCommitFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			const int8_t cTxLock = pxQueue->cTxLock;
+			const int8_t cRxLock = pxQueue->cRxLock;
+
+			configASSERT( pxQueue->pcReservedSlot != NULL );
+
+			traceQUEUE_SEND_FROM_ISR( pxQueue );
+			prvCommitReservedSlot( pxQueue );
+
+			/* As in xQueueGenericSendFromISR(), the event lists are only
+			updated if the queue is not locked, otherwise the lock counts tell
+			the task that unlocks the queue which waiters to unblock. */
+			if( cTxLock == queueUNLOCKED )
+			{
+				if( ( prvUnblockReceiver( pxQueue ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+				{
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxQueue->cTxLock = ( int8_t ) ( cTxLock + 1 );
+			}
+
+			/* Other senders were held off while the slot was reserved. */
+			if( prvQueueCanSend( pxQueue, queueSEND_TO_BACK ) )
+			{
+				if( cRxLock == queueUNLOCKED )
+				{
+					if( ( prvUnblockSender( pxQueue ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+					{
+						*pxHigherPriorityTaskWoken = pdTRUE;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					pxQueue->cRxLock = ( int8_t ) ( cRxLock + 1 );
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xQueueAcquire( QueueHandle_t xQueue, void ** const ppvItem, TickType_t xTicksToWait )
+	{
+	BaseType_t xEntryTimeSet = pdFALSE;
+	TimeOut_t xTimeOut;
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( ppvItem );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+		{
+			configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+		}
+		#endif
+
+		/*lint -save -e904 This function relaxes the coding standard somewhat to
+		allow return statements within the function itself.  This is done in the
+		interest of execution time efficiency. */
+		for( ;; )
+		{
+			taskENTER_CRITICAL();
+			{
+				if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+				{
+					/* Only one item can be held at a time. */
+					configASSERT( pxQueue->pcAcquiredItem == NULL );
+
+					*ppvItem = prvAcquireItem( pxQueue );
+					traceQUEUE_RECEIVE( pxQueue );
+
+					/* The slot is still in use, so unlike xQueueReceive() no
+					sender is unblocked until the item is released. */
+					taskEXIT_CRITICAL();
+					return pdPASS;
+				}
+				else
+				{
+					if( xTicksToWait == ( TickType_t ) 0 )
+					{
+						taskEXIT_CRITICAL();
+						traceQUEUE_RECEIVE_FAILED( pxQueue );
+						return errQUEUE_EMPTY;
+					}
+					else if( xEntryTimeSet == pdFALSE )
+					{
+						vTaskInternalSetTimeOutState( &xTimeOut );
+						xEntryTimeSet = pdTRUE;
+					}
+					else
+					{
+						/* Entry time was already set. */
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			taskEXIT_CRITICAL();
+
+			vTaskSuspendAll();
+			prvLockQueue( pxQueue );
+
+			/* Blocks in the same way as xQueueReceive(). */
+			if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+			{
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+					vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+					prvUnlockQueue( pxQueue );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+				else
+				{
+					prvUnlockQueue( pxQueue );
+					( void ) xTaskResumeAll();
+				}
+			}
+			else
+			{
+				prvUnlockQueue( pxQueue );
+				( void ) xTaskResumeAll();
+
+				if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+				{
+					traceQUEUE_RECEIVE_FAILED( pxQueue );
+					return errQUEUE_EMPTY;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		} /*lint -restore */
+	}
+	/*-----------------------------------------------------------*/
+
+	void vQueueRelease( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			configASSERT( pxQueue->pcAcquiredItem != NULL );
+			pxQueue->pcAcquiredItem = NULL;
+
+			/* There is now space in the queue. */
+			if( prvUnblockSender( pxQueue ) != pdFALSE )
+			{
+				queueYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xQueueAcquireFromISR( QueueHandle_t xQueue, void ** const ppvItem )
+	{
+	BaseType_t xReturn;
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( ppvItem );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+			{
+				configASSERT( pxQueue->pcAcquiredItem == NULL );
+
+				traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+				*ppvItem = prvAcquireItem( pxQueue );
+				xReturn = pdPASS;
+			}
+			else
+			{
+				traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+				xReturn = pdFAIL;
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vQueueReleaseFromISR( QueueHandle_t xQueue, BaseType_t * const pxHigherPriorityTaskWoken )
+	{
+	UBaseType_t uxSavedInterruptStatus;
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			const int8_t cRxLock = pxQueue->cRxLock;
+
+			configASSERT( pxQueue->pcAcquiredItem != NULL );
+			pxQueue->pcAcquiredItem = NULL;
+
+			if( cRxLock == queueUNLOCKED )
+			{
+				if( ( prvUnblockSender( pxQueue ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+				{
+					*pxHigherPriorityTaskWoken = pdTRUE;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				/* Increment the lock count so the task that unlocks the queue
+				knows a slot was freed while it was locked. */
+				pxQueue->cRxLock = ( int8_t ) ( cRxLock + 1 );
+			}
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+
+	configASSERT( xQueue );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = ( ( Queue_t * ) xQueue )->uxMessagesWaiting;
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+
+	taskENTER_CRITICAL();
+	{
+		uxReturn = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+
+		#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+		{
+			/* Reserved and acquired slots hold no waiting item but cannot be
+			used either. */
+			if( pxQueue->pcReservedSlot != NULL )
+			{
+				uxReturn--;
+			}
+
+			if( pxQueue->pcAcquiredItem != NULL )
+			{
+				uxReturn--;
+			}
+		}
+		#endif
+	}
+	taskEXIT_CRITICAL();
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
+{
+UBaseType_t uxReturn;
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	uxReturn = pxQueue->uxMessagesWaiting;
+
+	return uxReturn;
+} /*lint !e818 Pointer cannot be declared const as xQueue is a typedef not pointer. */
+/*-----------------------------------------------------------*/
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+Queue_t * const pxQueue = xQueue;
+
+	configASSERT( pxQueue );
+	traceQUEUE_DELETE( pxQueue );
+
+	#if ( configQUEUE_REGISTRY_SIZE > 0 )
+	{
+		vQueueUnregisterQueue( pxQueue );
+	}
+	#endif
+
+	#if( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
+	{
+		/* The queue can only have been allocated dynamically - free it
+		again. */
+		vPortFree( pxQueue );
+	}
+	#elif( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+	{
+		/* The queue could have been allocated statically or dynamically, so
+		check before attempting to free the memory. */
+		if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+		{
+			vPortFree( pxQueue );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#else
+	{
+		/* The queue must have been statically allocated, so is not going to be
+		deleted.  Avoid compiler warnings about the unused parameter. */
+		( void ) pxQueue;
+	}
+	#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	UBaseType_t uxQueueGetQueueNumber( QueueHandle_t xQueue )
+	{
+		return ( ( Queue_t * ) xQueue )->uxQueueNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	void vQueueSetQueueNumber( QueueHandle_t xQueue, UBaseType_t uxQueueNumber )
+	{
+		( ( Queue_t * ) xQueue )->uxQueueNumber = uxQueueNumber;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+	uint8_t ucQueueGetQueueType( QueueHandle_t xQueue )
+	{
+		return ( ( Queue_t * ) xQueue )->ucQueueType;
+	}
+
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_MUTEXES == 1 )
+
+	static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue )
+	{
+	UBaseType_t uxHighestPriorityOfWaitingTasks;
+
+		/* If a task waiting for a mutex causes the mutex holder to inherit a
+		priority, but the waiting task times out, then the holder should
+		disinherit the priority - but only down to the highest priority of any
+		other tasks that are waiting for the same mutex.  For this purpose,
+		return the priority of the highest priority task that is waiting for the
+		mutex. */
+		if( listCURRENT_LIST_LENGTH( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) > 0U )
+		{
+			uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) );
+		}
+		else
+		{
+			uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+		}
+
+		return uxHighestPriorityOfWaitingTasks;
+	}
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
 
 static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue, const void *pvItemToQueue, const BaseType_t xPosition )
 {
@@ -2145,6 +2799,7 @@ UBaseType_t uxMessagesWaiting;
 	}
 
 	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+	queueSTATS_ITEMS_ADDED( pxQueue, xPosition, ( UBaseType_t ) 1 );
 
 	return xReturn;
 }
@@ -2168,6 +2823,288 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+	static BaseType_t prvUnblockReceiver( Queue_t * const pxQueue )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		#if ( configUSE_QUEUE_SETS == 1 )
+		{
+			if( pxQueue->pxQueueSetContainer != NULL )
+			{
+				return prvNotifyQueueSetContainer( pxQueue );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configUSE_QUEUE_SETS */
+
+		if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
+		{
+			xReturn = xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvUnblockSender( Queue_t * const pxQueue )
+	{
+	BaseType_t xReturn = pdFALSE;
+
+		if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
+		{
+			xReturn = xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+	static void prvCommitReservedSlot( Queue_t * const pxQueue )
+	{
+		/* This function is called from a critical section.  Sends are held
+		off while a slot is reserved, so the write position cannot have
+		moved. */
+		configASSERT( pxQueue->pcReservedSlot == pxQueue->pcWriteTo );
+
+		pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+		{
+			pxQueue->pcWriteTo = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxQueue->pcReservedSlot = NULL;
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting + ( UBaseType_t ) 1;
+		queueSTATS_ITEMS_ADDED( pxQueue, queueSEND_TO_BACK, ( UBaseType_t ) 1 );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void *prvAcquireItem( Queue_t * const pxQueue )
+	{
+		/* This function is called from a critical section.  The read position
+		is advanced exactly as prvCopyDataFromQueue() would, but the item is
+		left in place for the caller. */
+		pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+		if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+		{
+			pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxQueue->pcAcquiredItem = pxQueue->u.xQueue.pcReadFrom;
+		pxQueue->uxMessagesWaiting = pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1;
+		queueSTATS_ITEMS_REMOVED( pxQueue, ( UBaseType_t ) 1 );
+
+		return ( void * ) pxQueue->pcAcquiredItem;
+	}
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATS == 1 )
+
+	static void prvStatsItemsAdded( Queue_t * const pxQueue, const BaseType_t xPosition, const UBaseType_t uxNumItems )
+	{
+	UBaseType_t uxSlot, ux;
+	uint32_t ulNow;
+
+		/* This function is called from a critical section. */
+		pxQueue->xStats.ulItemsSent += ( uint32_t ) uxNumItems;
+
+		if( pxQueue->uxMessagesWaiting > pxQueue->xStats.uxPeakMessagesWaiting )
+		{
+			pxQueue->xStats.uxPeakMessagesWaiting = pxQueue->uxMessagesWaiting;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( pxQueue->pulEnqueueTimes != NULL )
+		{
+			/* The items waiting occupy the slots following pcReadFrom.  Items
+			sent to the front are the first of them, items sent to the back
+			the last. */
+			uxSlot = ( UBaseType_t ) ( ( size_t ) ( pxQueue->u.xQueue.pcReadFrom - pxQueue->pcHead ) / ( size_t ) pxQueue->uxItemSize ) + ( UBaseType_t ) 1;
+
+			if( xPosition == queueSEND_TO_BACK )
+			{
+				uxSlot += pxQueue->uxMessagesWaiting - uxNumItems;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			ulNow = configQUEUE_STATS_TIMESTAMP();
+
+			for( ux = ( UBaseType_t ) 0; ux < uxNumItems; ux++ )
+			{
+				pxQueue->pulEnqueueTimes[ ( uxSlot + ux ) % pxQueue->uxLength ] = ulNow;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStatsItemsRemoved( Queue_t * const pxQueue, const UBaseType_t uxNumItems )
+	{
+	UBaseType_t uxSlot, ux, uxBucket;
+	uint32_t ulNow, ulLatency;
+
+		/* This function is called from a critical section.  pcReadFrom has
+		been left pointing to the last item removed. */
+		if( pxQueue->pulEnqueueTimes != NULL )
+		{
+			uxSlot = ( UBaseType_t ) ( ( size_t ) ( pxQueue->u.xQueue.pcReadFrom - pxQueue->pcHead ) / ( size_t ) pxQueue->uxItemSize );
+			uxSlot += ( pxQueue->uxLength + ( UBaseType_t ) 1 ) - uxNumItems;
+
+			ulNow = configQUEUE_STATS_TIMESTAMP();
+
+			for( ux = ( UBaseType_t ) 0; ux < uxNumItems; ux++ )
+			{
+				ulLatency = ulNow - pxQueue->pulEnqueueTimes[ ( uxSlot + ux ) % pxQueue->uxLength ];
+
+				if( ulLatency > pxQueue->xStats.ulLatencyMax )
+				{
+					pxQueue->xStats.ulLatencyMax = ulLatency;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+
+				/* Each bucket after the first covers twice the range of the
+				one before it. */
+				ulLatency >>= configQUEUE_STATS_HISTOGRAM_SHIFT;
+				for( uxBucket = ( UBaseType_t ) 0; ( ulLatency != 0UL ) && ( uxBucket < ( UBaseType_t ) ( configQUEUE_STATS_HISTOGRAM_BUCKETS - 1 ) ); uxBucket++ )
+				{
+					ulLatency >>= 1;
+				}
+
+				pxQueue->xStats.ulLatencyHistogram[ uxBucket ]++;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvStatsSendReturned( Queue_t * const pxQueue, const BaseType_t xSent, const BaseType_t xWaited, const uint32_t ulWaitStart )
+	{
+	uint32_t ulWaitTime;
+
+		/* May be called from inside or outside a critical section. */
+		taskENTER_CRITICAL();
+		{
+			if( xWaited != pdFALSE )
+			{
+				ulWaitTime = configQUEUE_STATS_TIMESTAMP() - ulWaitStart;
+				pxQueue->xStats.ulSendWaits++;
+				pxQueue->xStats.ulSendWaitTime += ulWaitTime;
+
+				if( ulWaitTime > pxQueue->xStats.ulSendWaitTimeMax )
+				{
+					pxQueue->xStats.ulSendWaitTimeMax = ulWaitTime;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xSent == pdFALSE )
+			{
+				pxQueue->xStats.ulSendFailed++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vQueueGetStats( QueueHandle_t xQueue, QueueStats_t * const pxStats, const BaseType_t xReset )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
+		{
+			*pxStats = pxQueue->xStats;
+			pxStats->uxLength = pxQueue->uxLength;
+
+			if( xReset != pdFALSE )
+			{
+				( void ) memset( ( void * ) &( pxQueue->xStats ), 0x00, sizeof( pxQueue->xStats ) );
+				pxQueue->xStats.uxPeakMessagesWaiting = pxQueue->uxMessagesWaiting;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vQueueSetEnqueueTimes( QueueHandle_t xQueue, uint32_t * const pulEnqueueTimes )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pulEnqueueTimes );
+
+		/* Items already in the queue would have no timestamp. */
+		configASSERT( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 );
+		configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0 );
+
+		taskENTER_CRITICAL();
+		{
+			pxQueue->pulEnqueueTimes = pulEnqueueTimes;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATS */
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
 	/* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
@@ -2206,7 +3143,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 					/* Tasks that are removed from the event list will get
 					added to the pending ready list as the scheduler is still
 					suspended. */
-					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+					if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 					{
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
@@ -2229,7 +3166,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 			{
 				/* Tasks that are removed from the event list will get added to
 				the pending ready list as the scheduler is still suspended. */
-				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToReceive ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
@@ -2263,7 +3200,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 
 		while( cRxLock > queueLOCKED_UNMODIFIED )
 		{
-			if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+			if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueue->xTasksWaitingToSend ) ) ) == pdFALSE )
 			{
 				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 				{
@@ -2328,13 +3265,13 @@ Queue_t * const pxQueue = xQueue;
 } /*lint !e818 xQueue could not be pointer to const because it is a typedef. */
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvIsQueueFull( const Queue_t *pxQueue )
+static BaseType_t prvIsQueueFull( const Queue_t *pxQueue, const BaseType_t xCopyPosition )
 {
 BaseType_t xReturn;
 
 	taskENTER_CRITICAL();
 	{
-		if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+		if( !prvQueueCanSend( pxQueue, xCopyPosition ) )
 		{
 			xReturn = pdTRUE;
 		}
@@ -2355,7 +3292,7 @@ BaseType_t xReturn;
 Queue_t * const pxQueue = xQueue;
 
 	configASSERT( pxQueue );
-	if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+	if( !prvQueueCanSend( pxQueue, queueSEND_TO_BACK ) )
 	{
 		xReturn = pdTRUE;
 	}
@@ -2380,7 +3317,7 @@ Queue_t * const pxQueue = xQueue;
 		between the check to see if the queue is full and blocking on the queue. */
 		portDISABLE_INTERRUPTS();
 		{
-			if( prvIsQueueFull( pxQueue ) != pdFALSE )
+			if( prvIsQueueFull( pxQueue, queueSEND_TO_BACK ) != pdFALSE )
 			{
 				/* The queue is full - do we want to block or just leave without
 				posting? */
@@ -2700,6 +3637,47 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configQUEUE_REGISTRY_SIZE */
 /*-----------------------------------------------------------*/
 
+#if ( configQUEUE_REGISTRY_SIZE > 0 )
+
+	QueueHandle_t xQueueGetRegistryEntry( UBaseType_t uxIndex, const char **ppcName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+	{
+	QueueHandle_t xReturn = NULL;
+	const char *pcName = NULL; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+		/* As pcQueueGetName(), nothing protects against another task changing
+		the registry while it is being read. */
+		if( uxIndex < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE )
+		{
+			if( xQueueRegistry[ uxIndex ].pcQueueName != NULL )
+			{
+				xReturn = xQueueRegistry[ uxIndex ].xHandle;
+				pcName = xQueueRegistry[ uxIndex ].pcQueueName;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ppcName != NULL )
+		{
+			*ppcName = pcName;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xReturn;
+	}
+
+#endif /* configQUEUE_REGISTRY_SIZE */
+/*-----------------------------------------------------------*/
+
 #if ( configQUEUE_REGISTRY_SIZE > 0 )
 
 	void vQueueUnregisterQueue( QueueHandle_t xQueue )
@@ -2900,7 +3878,7 @@ Queue_t * const pxQueue = xQueue;
 
 			if( cTxLock == queueUNLOCKED )
 			{
-				if( listLIST_IS_EMPTY( &( pxQueueSetContainer->xTasksWaitingToReceive ) ) == pdFALSE )
+				if( listLIST_IS_EMPTY( listEVENT_LIST_WAITERS( &( pxQueueSetContainer->xTasksWaitingToReceive ) ) ) == pdFALSE )
 				{
 					if( xTaskRemoveFromEventList( &( pxQueueSetContainer->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
@@ -39,6 +39,10 @@ task.h is included from an application file. */
 #include "task.h"
 #include "stream_buffer.h"
 
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	#include "atomic.h"
+#endif
+
 #if( configUSE_TASK_NOTIFICATIONS != 1 )
 	#error configUSE_TASK_NOTIFICATIONS must be set to 1 to build stream_buffer.c
 #endif
@@ -93,8 +97,7 @@ that uses task notifications. */
 or #defined the notification macro away, them provide a default implementation
 that uses task notifications. */
 #ifndef sbSEND_COMPLETED
-	#define sbSEND_COMPLETED( pxStreamBuffer )											\
-		vTaskSuspendAll();																\
+	#define sbNOTIFY_RECEIVER( pxStreamBuffer )											\
 		{																				\
 			if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )						\
 			{																			\
@@ -103,8 +106,31 @@ that uses task notifications. */
 									  eNoAction );										\
 				( pxStreamBuffer )->xTaskWaitingToReceive = NULL;						\
 			}																			\
-		}																				\
-		( void ) xTaskResumeAll();
+		}
+
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		/* An interrupt writing to a multi-producer buffer can notify and clear
+		the waiting task between the check and the notify of a task writing to
+		it, so suspending the scheduler is not enough for those buffers. */
+		#define sbSEND_COMPLETED( pxStreamBuffer )										\
+			if( ( ( pxStreamBuffer )->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )	\
+			{																			\
+				taskENTER_CRITICAL();													\
+				sbNOTIFY_RECEIVER( pxStreamBuffer );									\
+				taskEXIT_CRITICAL();													\
+			}																			\
+			else																		\
+			{																			\
+				vTaskSuspendAll();														\
+				sbNOTIFY_RECEIVER( pxStreamBuffer );									\
+				( void ) xTaskResumeAll();												\
+			}
+	#else
+		#define sbSEND_COMPLETED( pxStreamBuffer )										\
+			vTaskSuspendAll();															\
+			sbNOTIFY_RECEIVER( pxStreamBuffer );										\
+			( void ) xTaskResumeAll();
+	#endif
 #endif /* sbSEND_COMPLETED */
 
 #ifndef sbSEND_COMPLETE_FROM_ISR
@@ -134,6 +160,7 @@ that uses task notifications. */
 /* Bits stored in the ucFlags field of the stream buffer. */
 #define sbFLAGS_IS_MESSAGE_BUFFER		( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
+#define sbFLAGS_IS_MULTI_PRODUCER		( ( uint8_t ) 4 ) /* Set if the stream buffer was created to be written to by more than one task or interrupt. */
 
 /*-----------------------------------------------------------*/
 
@@ -152,6 +179,11 @@ typedef struct StreamBufferDef_t /*lint !e9058 Style convention uses tag. */
 	#if ( configUSE_TRACE_FACILITY == 1 )
 		UBaseType_t uxStreamBufferNumber;		/* Used for tracing purposes. */
 	#endif
+
+	#if ( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+		volatile uint32_t ulReserveHead;		/* Index to the next byte to be reserved by a producer.  Data between xHead and ulReserveHead has been reserved but not all of it is committed. */
+		volatile uint32_t ulPendingCommits;		/* The number of producers that have reserved space but not yet committed it. */
+	#endif
 } StreamBuffer_t;
 
 /*
@@ -167,6 +199,81 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer ) PR
  */
 static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies xCount bytes from pucData into the buffer's storage area starting at
+ * index xOffset, wrapping to the start of the storage area if necessary.  The
+ * head is not moved.  Returns the index following the last byte written.
+ */
+static size_t prvWriteBytesToBufferAt( StreamBuffer_t * const pxStreamBuffer, size_t xOffset, const uint8_t *pucData, size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * As prvWriteBytesToBufferAt(), but takes the first xCount bytes of the data
+ * described by the uxVecCount entries of pxVecs, in order.
+ */
+static size_t prvWriteVectorToBufferAt( StreamBuffer_t * const pxStreamBuffer,
+										size_t xOffset,
+										const StreamBufferIOVec_t * pxVecs,
+										UBaseType_t uxVecCount,
+										size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the total number of bytes described by the uxVecCount entries of
+ * pxVecs.
+ */
+static size_t prvVectorLength( const StreamBufferIOVec_t * pxVecs, UBaseType_t uxVecCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task for up to xTicksToWait ticks until xRequiredSpace
+ * bytes are free in the buffer.  Returns the number of bytes free.
+ */
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+							   size_t xRequiredSpace,
+							   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * The number of bytes that can be written to the buffer if writing starts at
+ * index xHead.
+ */
+static size_t prvSpacesAvailableFrom( const StreamBuffer_t * const pxStreamBuffer, size_t xHead ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	/*
+	 * Reserves between xMinCount and xMaxCount bytes of space for the calling
+	 * producer without a critical section, so several tasks and interrupts can
+	 * copy data into the buffer at the same time.  Returns the number of bytes
+	 * reserved, with the index of the first in *pxOffset, or 0 if fewer than
+	 * xMinCount bytes were free.  Every call must be matched by a call to
+	 * prvCommitSpace(), even if nothing was reserved.
+	 */
+	static size_t prvReserveSpace( StreamBuffer_t * const pxStreamBuffer, size_t xMinCount, size_t xMaxCount, size_t *pxOffset ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Marks the calling producer's reservation as written.  Reservations are
+	 * made visible to the reader in the order they were made, when the last
+	 * outstanding one is committed.
+	 */
+	static void prvCommitSpace( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * The multi-producer equivalent of prvWriteMessageToBuffer().
+	 */
+	static size_t prvWriteMessageMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+												const StreamBufferIOVec_t * pxVecs,
+												UBaseType_t uxVecCount,
+												size_t xDataLengthBytes,
+												size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Describes the xCount bytes of the buffer's storage area starting at index
+ * xOffset as at most two contiguous spans, the second starting at the
+ * beginning of the storage area if the region wraps.  Returns xCount.
+ */
+static size_t prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+						   size_t xOffset,
+						   size_t xCount,
+						   StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
 /*
  * If the stream buffer is being used as a message buffer, then reads an entire
  * message out of the buffer.  If the stream buffer is being used as a stream
@@ -184,15 +291,29 @@ static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
  * If the stream buffer is being used as a message buffer, then writes an entire
  * message to the buffer.  If the stream buffer is being used as a stream
  * buffer then write as many bytes as possible to the buffer.
- * prvWriteBytestoBuffer() is called to actually send the bytes to the buffer's
- * data storage area.
+ * The data is gathered from the uxVecCount entries of pxVecs, which describe
+ * xDataLengthBytes bytes in total.  prvWriteVectorToBufferAt() is called to
+ * actually send the bytes to the buffer's data storage area.
  */
 static size_t prvWriteMessageToBuffer(  StreamBuffer_t * const pxStreamBuffer,
-										const void * pvTxData,
+										const StreamBufferIOVec_t * pxVecs,
+										UBaseType_t uxVecCount,
 										size_t xDataLengthBytes,
 										size_t xSpace,
 										size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
 
+/*
+ * Writes the uxNumMessages messages described by pxVecs and puxVecCounts to a
+ * message buffer, stopping at the first that doesn't fit.  Returns the number
+ * of messages written, with the number of data bytes they held in
+ * *pxBytesSent.
+ */
+static UBaseType_t prvWriteMessagesToBuffer( StreamBuffer_t * const pxStreamBuffer,
+											 const StreamBufferIOVec_t * pxVecs,
+											 const UBaseType_t * puxVecCounts,
+											 UBaseType_t uxNumMessages,
+											 size_t * const pxBytesSent ) PRIVILEGED_FUNCTION;
+
 /*
  * Read xMaxCount bytes from the pxStreamBuffer message buffer and write them
  * to pucData.
@@ -225,7 +346,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 		(that is, it will hold discrete messages with a little meta data that
 		says how big the next message is) check the buffer will be large enough
 		to hold at least one message. */
-		if( xIsMessageBuffer == pdTRUE )
+		if( ( xIsMessageBuffer & sbTYPE_MESSAGE_BUFFER ) != 0 )
 		{
 			/* Is a message buffer but not statically allocated. */
 			ucFlags = sbFLAGS_IS_MESSAGE_BUFFER;
@@ -239,6 +360,17 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 		}
 		configASSERT( xTriggerLevelBytes <= xBufferSizeBytes );
 
+		if( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) != 0 )
+		{
+			/* Multiple producers need configUSE_STREAM_BUFFER_MULTI_PRODUCER. */
+			configASSERT( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 );
+			ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
 		/* A trigger level of 0 would cause a waiting task to unblock even when
 		the buffer was empty. */
 		if( xTriggerLevelBytes == ( size_t ) 0 )
@@ -301,7 +433,7 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 			xTriggerLevelBytes = ( size_t ) 1;
 		}
 
-		if( xIsMessageBuffer != pdFALSE )
+		if( ( xIsMessageBuffer & sbTYPE_MESSAGE_BUFFER ) != 0 )
 		{
 			/* Statically allocated message buffer. */
 			ucFlags = sbFLAGS_IS_MESSAGE_BUFFER | sbFLAGS_IS_STATICALLY_ALLOCATED;
@@ -312,6 +444,16 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
 			ucFlags = sbFLAGS_IS_STATICALLY_ALLOCATED;
 		}
 
+		if( ( xIsMessageBuffer & sbTYPE_MULTI_PRODUCER ) != 0 )
+		{
+			configASSERT( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 );
+			ucFlags |= sbFLAGS_IS_MULTI_PRODUCER;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
 		/* In case the stream buffer is going to be used as a message buffer
 		(that is, it will hold discrete messages with a little meta data that
 		says how big the next message is) check the buffer will be large enough
@@ -413,7 +555,12 @@ BaseType_t xReturn = pdFAIL;
 	{
 		if( pxStreamBuffer->xTaskWaitingToReceive == NULL )
 		{
-			if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+				/* Nor if a producer is part way through writing to it. */
+				if( ( pxStreamBuffer->xTaskWaitingToSend == NULL ) && ( pxStreamBuffer->ulPendingCommits == ( uint32_t ) 0 ) )
+			#else
+				if( pxStreamBuffer->xTaskWaitingToSend == NULL )
+			#endif
 			{
 				prvInitialiseNewStreamBuffer( pxStreamBuffer,
 											  pxStreamBuffer->pucBuffer,
@@ -474,18 +621,22 @@ size_t xSpace;
 
 	configASSERT( pxStreamBuffer );
 
-	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
-	xSpace -= pxStreamBuffer->xHead;
-	xSpace -= ( size_t ) 1;
-
-	if( xSpace >= pxStreamBuffer->xLength )
-	{
-		xSpace -= pxStreamBuffer->xLength;
-	}
-	else
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
 	{
-		mtCOVERAGE_TEST_MARKER();
+		/* Space reserved by a producer is no longer available, even though it
+		has not been committed yet. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			return prvSpacesAvailableFrom( pxStreamBuffer, ( size_t ) pxStreamBuffer->ulReserveHead );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
 	}
+	#endif
+
+	xSpace = prvSpacesAvailableFrom( pxStreamBuffer, pxStreamBuffer->xHead );
 
 	return xSpace;
 }
@@ -508,14 +659,32 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
 						  size_t xDataLengthBytes,
 						  TickType_t xTicksToWait )
 {
+StreamBufferIOVec_t xVec;
+
+	configASSERT( pvTxData );
+
+	xVec.pvData = pvTxData;
+	xVec.xLength = xDataLengthBytes;
+
+	return xStreamBufferSendV( xStreamBuffer, &xVec, ( UBaseType_t ) 1, xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+						   const StreamBufferIOVec_t * const pxVecs,
+						   UBaseType_t uxVecCount,
+						   TickType_t xTicksToWait )
+{
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace = 0;
-size_t xRequiredSpace = xDataLengthBytes;
-TimeOut_t xTimeOut;
+size_t xDataLengthBytes, xRequiredSpace;
 
-	configASSERT( pvTxData );
+	configASSERT( pxVecs );
 	configASSERT( pxStreamBuffer );
 
+	xDataLengthBytes = prvVectorLength( pxVecs, uxVecCount );
+	xRequiredSpace = xDataLengthBytes;
+
 	/* This send function is used to write to both message buffers and stream
 	buffers.  If this is a message buffer then the space needed must be
 	increased by the amount of bytes needed to store the length of the
@@ -534,38 +703,7 @@ TimeOut_t xTimeOut;
 
 	if( xTicksToWait != ( TickType_t ) 0 )
 	{
-		vTaskSetTimeOutState( &xTimeOut );
-
-		do
-		{
-			/* Wait until the required number of bytes are free in the message
-			buffer. */
-			taskENTER_CRITICAL();
-			{
-				xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-
-				if( xSpace < xRequiredSpace )
-				{
-					/* Clear notification state as going to wait for space. */
-					( void ) xTaskNotifyStateClear( NULL );
-
-					/* Should only be one writer. */
-					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
-					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
-				}
-				else
-				{
-					taskEXIT_CRITICAL();
-					break;
-				}
-			}
-			taskEXIT_CRITICAL();
-
-			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
-			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
-			pxStreamBuffer->xTaskWaitingToSend = NULL;
-
-		} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+		xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
 	}
 	else
 	{
@@ -581,7 +719,7 @@ TimeOut_t xTimeOut;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pxVecs, uxVecCount, xDataLengthBytes, xSpace, xRequiredSpace );
 
 	if( xReturn > ( size_t ) 0 )
 	{
@@ -607,18 +745,91 @@ TimeOut_t xTimeOut;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xStreamBufferSendMultipleV( StreamBufferHandle_t xStreamBuffer,
+										const StreamBufferIOVec_t * const pxVecs,
+										const UBaseType_t * const puxVecCounts,
+										UBaseType_t uxNumMessages,
+										TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+UBaseType_t uxSent;
+size_t xBytesSent;
+
+	configASSERT( pxVecs );
+	configASSERT( puxVecCounts );
+	configASSERT( pxStreamBuffer );
+
+	/* A stream buffer has no message boundaries to batch on. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+
+	/* Only block if not even the first message fits. */
+	if( ( xTicksToWait != ( TickType_t ) 0 ) && ( uxNumMessages > ( UBaseType_t ) 0 ) )
+	{
+		( void ) prvWaitForSpace( pxStreamBuffer, prvVectorLength( pxVecs, puxVecCounts[ 0 ] ) + sbBYTES_TO_STORE_MESSAGE_LENGTH, xTicksToWait );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	uxSent = prvWriteMessagesToBuffer( pxStreamBuffer, pxVecs, puxVecCounts, uxNumMessages, &xBytesSent );
+
+	if( uxSent > ( UBaseType_t ) 0 )
+	{
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesSent );
+
+		/* Was a task waiting for the data?  Notified once for the whole
+		batch. */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+		traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+	}
+
+	return uxSent;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
 								 const void *pvTxData,
 								 size_t xDataLengthBytes,
 								 BaseType_t * const pxHigherPriorityTaskWoken )
 {
+StreamBufferIOVec_t xVec;
+
+	configASSERT( pvTxData );
+
+	xVec.pvData = pvTxData;
+	xVec.xLength = xDataLengthBytes;
+
+	return xStreamBufferSendVFromISR( xStreamBuffer, &xVec, ( UBaseType_t ) 1, pxHigherPriorityTaskWoken );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+								  const StreamBufferIOVec_t * const pxVecs,
+								  UBaseType_t uxVecCount,
+								  BaseType_t * const pxHigherPriorityTaskWoken )
+{
 StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
 size_t xReturn, xSpace;
-size_t xRequiredSpace = xDataLengthBytes;
+size_t xDataLengthBytes, xRequiredSpace;
 
-	configASSERT( pvTxData );
+	configASSERT( pxVecs );
 	configASSERT( pxStreamBuffer );
 
+	xDataLengthBytes = prvVectorLength( pxVecs, uxVecCount );
+	xRequiredSpace = xDataLengthBytes;
+
 	/* This send function is used to write to both message buffers and stream
 	buffers.  If this is a message buffer then the space needed must be
 	increased by the amount of bytes needed to store the length of the
@@ -633,7 +844,7 @@ size_t xRequiredSpace = xDataLengthBytes;
 	}
 
 	xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+	xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pxVecs, uxVecCount, xDataLengthBytes, xSpace, xRequiredSpace );
 
 	if( xReturn > ( size_t ) 0 )
 	{
@@ -658,8 +869,160 @@ size_t xRequiredSpace = xDataLengthBytes;
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xStreamBufferSendMultipleVFromISR( StreamBufferHandle_t xStreamBuffer,
+											   const StreamBufferIOVec_t * const pxVecs,
+											   const UBaseType_t * const puxVecCounts,
+											   UBaseType_t uxNumMessages,
+											   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+UBaseType_t uxSent;
+size_t xBytesSent;
+
+	configASSERT( pxVecs );
+	configASSERT( puxVecCounts );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+
+	uxSent = prvWriteMessagesToBuffer( pxStreamBuffer, pxVecs, puxVecCounts, uxNumMessages, &xBytesSent );
+
+	if( uxSent > ( UBaseType_t ) 0 )
+	{
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent );
+
+	return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+							   size_t xRequiredSpace,
+							   TickType_t xTicksToWait )
+{
+size_t xSpace = 0;
+TimeOut_t xTimeOut;
+TickType_t xWaitTicks;
+
+	vTaskSetTimeOutState( &xTimeOut );
+
+	do
+	{
+		/* Wait until the required number of bytes are free in the message
+		buffer. */
+		taskENTER_CRITICAL();
+		{
+			xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+			if( xSpace < xRequiredSpace )
+			{
+				/* Clear notification state as going to wait for space. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+				{
+					/* Only one task can be notified when space is freed.  If
+					another producer already holds that role this task checks
+					again after a tick instead. */
+					if( pxStreamBuffer->xTaskWaitingToSend != NULL )
+					{
+						configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 );
+						xWaitTicks = configMIN( xTicksToWait, ( TickType_t ) 1 );
+					}
+					else
+					{
+						pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+						xWaitTicks = xTicksToWait;
+					}
+				}
+				#else
+				{
+					/* Should only be one writer. */
+					configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+					pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+					xWaitTicks = xTicksToWait;
+				}
+				#endif
+			}
+			else
+			{
+				taskEXIT_CRITICAL();
+				break;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+		( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xWaitTicks );
+
+		/* Another producer may have taken over waiting for space. */
+		if( pxStreamBuffer->xTaskWaitingToSend == xTaskGetCurrentTaskHandle() )
+		{
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+	} while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+
+	return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvWriteMessagesToBuffer( StreamBuffer_t * const pxStreamBuffer,
+											 const StreamBufferIOVec_t * pxVecs,
+											 const UBaseType_t * puxVecCounts,
+											 UBaseType_t uxNumMessages,
+											 size_t * const pxBytesSent )
+{
+UBaseType_t uxSent;
+size_t xDataLengthBytes, xRequiredSpace, xSpace;
+
+	*pxBytesSent = 0;
+
+	for( uxSent = 0; uxSent < uxNumMessages; uxSent++ )
+	{
+		xDataLengthBytes = prvVectorLength( pxVecs, puxVecCounts[ uxSent ] );
+		xRequiredSpace = xDataLengthBytes + sbBYTES_TO_STORE_MESSAGE_LENGTH;
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+		/* Messages are sent in order, so stop at the first that doesn't
+		fit. */
+		if( prvWriteMessageToBuffer( pxStreamBuffer, pxVecs, puxVecCounts[ uxSent ], xDataLengthBytes, xSpace, xRequiredSpace ) == ( size_t ) 0 )
+		{
+			break;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		*pxBytesSent += xDataLengthBytes;
+		pxVecs += puxVecCounts[ uxSent ];
+	}
+
+	return uxSent;
+}
+/*-----------------------------------------------------------*/
+
 static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
-									   const void * pvTxData,
+									   const StreamBufferIOVec_t * pxVecs,
+									   UBaseType_t uxVecCount,
 									   size_t xDataLengthBytes,
 									   size_t xSpace,
 									   size_t xRequiredSpace )
@@ -667,6 +1030,21 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 	BaseType_t xShouldWrite;
 	size_t xReturn;
 
+	#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+	{
+		/* xSpace is only a snapshot, other producers may have taken it since,
+		so space has to be reserved before it is written to. */
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) != ( uint8_t ) 0 )
+		{
+			return prvWriteMessageMultiProducer( pxStreamBuffer, pxVecs, uxVecCount, xDataLengthBytes, xRequiredSpace );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
 	if( xSpace == ( size_t ) 0 )
 	{
 		/* Doesn't matter if this is a stream buffer or a message buffer, there
@@ -698,8 +1076,9 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
 
 	if( xShouldWrite != pdFALSE )
 	{
-		/* Writes the data itself. */
-		xReturn = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+		/* Writes the data itself, gathered from each of the vectors in turn. */
+		pxStreamBuffer->xHead = prvWriteVectorToBufferAt( pxStreamBuffer, pxStreamBuffer->xHead, pxVecs, uxVecCount, xDataLengthBytes );
+		xReturn = xDataLengthBytes;
 	}
 	else
 	{
@@ -915,27 +1294,339 @@ size_t xReceivedLength = 0, xBytesAvailable, xBytesToStoreMessageLength;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
-										void *pvRxData,
-										size_t xBufferLengthBytes,
-										size_t xBytesAvailable,
-										size_t xBytesToStoreMessageLength )
+size_t xStreamBufferSendAcquire( StreamBufferHandle_t xStreamBuffer,
+								 StreamBufferSpans_t * const pxSpans,
+								 TickType_t xTicksToWait )
 {
-size_t xOriginalTail, xReceivedLength, xNextMessageLength;
-configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xSpace;
 
-	if( xBytesToStoreMessageLength != ( size_t ) 0 )
-	{
-		/* A discrete message is being received.  First receive the length
-		of the message.  A copy of the tail is stored so the buffer can be
-		returned to its prior state if the length of the message is too
-		large for the provided buffer. */
-		xOriginalTail = pxStreamBuffer->xTail;
-		( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xBytesAvailable );
-		xNextMessageLength = ( size_t ) xTempNextMessageLength;
+	configASSERT( pxSpans );
+	configASSERT( pxStreamBuffer );
 
-		/* Reduce the number of bytes available by the number of bytes just
-		read out. */
+	/* A message must be written whole, with its length in front of it. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	/* Writing in place relies on there being a single writer. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) == ( uint8_t ) 0 );
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		/* Checking if there is space and clearing the notification state must
+		be performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+			if( xSpace == ( size_t ) 0 )
+			{
+				/* Clear notification state as going to wait for space. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one writer. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+				pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xSpace == ( size_t ) 0 )
+		{
+			/* Wait for space to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToSend = NULL;
+
+			/* Recheck the space available after blocking. */
+			xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+	}
+
+	return prvGetSpans( pxStreamBuffer, pxStreamBuffer->xHead, xSpace, pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										StreamBufferSpans_t * const pxSpans )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxSpans );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MULTI_PRODUCER ) == ( uint8_t ) 0 );
+
+	return prvGetSpans( pxStreamBuffer, pxStreamBuffer->xHead, xStreamBufferSpacesAvailable( pxStreamBuffer ), pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferSendCommit( StreamBufferHandle_t xStreamBuffer,
+							  size_t xBytesWritten )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextHead;
+
+	configASSERT( pxStreamBuffer );
+
+	/* Can't commit more than was acquired. */
+	configASSERT( xBytesWritten <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+
+		traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesWritten );
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETED( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferSendCommitFromISR( StreamBufferHandle_t xStreamBuffer,
+									 size_t xBytesWritten,
+									 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextHead;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesWritten <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+	if( xBytesWritten > ( size_t ) 0 )
+	{
+		xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+		if( xNextHead >= pxStreamBuffer->xLength )
+		{
+			xNextHead -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xHead = xNextHead;
+
+		/* Was a task waiting for the data? */
+		if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+		{
+			sbSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesWritten );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquire( StreamBufferHandle_t xStreamBuffer,
+									StreamBufferSpans_t * const pxSpans,
+									TickType_t xTicksToWait )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xBytesAvailable;
+
+	configASSERT( pxSpans );
+	configASSERT( pxStreamBuffer );
+
+	/* The bytes of a message buffer include the length of each message. */
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	if( xTicksToWait != ( TickType_t ) 0 )
+	{
+		/* Checking if there is data and clearing the notification state must be
+		performed atomically. */
+		taskENTER_CRITICAL();
+		{
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+			if( xBytesAvailable == ( size_t ) 0 )
+			{
+				/* Clear notification state as going to wait for data. */
+				( void ) xTaskNotifyStateClear( NULL );
+
+				/* Should only be one reader. */
+				configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+				pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if( xBytesAvailable == ( size_t ) 0 )
+		{
+			/* Wait for data to be available. */
+			traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
+			( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+			pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+			/* Recheck the data available after blocking. */
+			xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	else
+	{
+		xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+	}
+
+	return prvGetSpans( pxStreamBuffer, pxStreamBuffer->xTail, xBytesAvailable, pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferReceiveAcquireFromISR( StreamBufferHandle_t xStreamBuffer,
+										   StreamBufferSpans_t * const pxSpans )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+	configASSERT( pxSpans );
+	configASSERT( pxStreamBuffer );
+	configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+	return prvGetSpans( pxStreamBuffer, pxStreamBuffer->xTail, prvBytesInBuffer( pxStreamBuffer ), pxSpans );
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReceiveRelease( StreamBufferHandle_t xStreamBuffer,
+								  size_t xBytesConsumed )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextTail;
+
+	configASSERT( pxStreamBuffer );
+
+	/* Can't release more than was acquired. */
+	configASSERT( xBytesConsumed <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	if( xBytesConsumed > ( size_t ) 0 )
+	{
+		/* Move the tail to effectively remove the data from the buffer. */
+		xNextTail = pxStreamBuffer->xTail + xBytesConsumed;
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+
+		/* Was a task waiting for space in the buffer? */
+		traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesConsumed );
+		sbRECEIVE_COMPLETED( pxStreamBuffer );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReceiveReleaseFromISR( StreamBufferHandle_t xStreamBuffer,
+										 size_t xBytesConsumed,
+										 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+size_t xNextTail;
+
+	configASSERT( pxStreamBuffer );
+	configASSERT( xBytesConsumed <= prvBytesInBuffer( pxStreamBuffer ) );
+
+	if( xBytesConsumed > ( size_t ) 0 )
+	{
+		xNextTail = pxStreamBuffer->xTail + xBytesConsumed;
+		if( xNextTail >= pxStreamBuffer->xLength )
+		{
+			xNextTail -= pxStreamBuffer->xLength;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxStreamBuffer->xTail = xNextTail;
+
+		/* Was a task waiting for space in the buffer? */
+		sbRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xBytesConsumed );
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageFromBuffer( StreamBuffer_t *pxStreamBuffer,
+										void *pvRxData,
+										size_t xBufferLengthBytes,
+										size_t xBytesAvailable,
+										size_t xBytesToStoreMessageLength )
+{
+size_t xOriginalTail, xReceivedLength, xNextMessageLength;
+configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+	if( xBytesToStoreMessageLength != ( size_t ) 0 )
+	{
+		/* A discrete message is being received.  First receive the length
+		of the message.  A copy of the tail is stored so the buffer can be
+		returned to its prior state if the length of the message is too
+		large for the provided buffer. */
+		xOriginalTail = pxStreamBuffer->xTail;
+		( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, xBytesToStoreMessageLength, xBytesAvailable );
+		xNextMessageLength = ( size_t ) xTempNextMessageLength;
+
+		/* Reduce the number of bytes available by the number of bytes just
+		read out. */
 		xBytesAvailable -= xBytesToStoreMessageLength;
 
 		/* Check there is enough space in the buffer provided by the
@@ -1087,11 +1778,20 @@ UBaseType_t uxSavedInterruptStatus;
 
 static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer, const uint8_t *pucData, size_t xCount )
 {
-size_t xNextHead, xFirstLength;
-
 	configASSERT( xCount > ( size_t ) 0 );
 
-	xNextHead = pxStreamBuffer->xHead;
+	/* The head is only moved once the data is in the buffer. */
+	pxStreamBuffer->xHead = prvWriteBytesToBufferAt( pxStreamBuffer, pxStreamBuffer->xHead, pucData, xCount );
+
+	return xCount;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteBytesToBufferAt( StreamBuffer_t * const pxStreamBuffer, size_t xOffset, const uint8_t *pucData, size_t xCount )
+{
+size_t xNextHead, xFirstLength;
+
+	xNextHead = xOffset;
 
 	/* Calculate the number of bytes that can be added in the first write -
 	which may be less than the total number of bytes that need to be added if
@@ -1125,7 +1825,34 @@ size_t xNextHead, xFirstLength;
 		mtCOVERAGE_TEST_MARKER();
 	}
 
-	pxStreamBuffer->xHead = xNextHead;
+	return xNextHead;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+						   size_t xOffset,
+						   size_t xCount,
+						   StreamBufferSpans_t * const pxSpans )
+{
+size_t xFirstLength;
+
+	/* Calculate the number of bytes before the end of the storage area - which
+	may be less than xCount if the region wraps around to the start of it. */
+	xFirstLength = configMIN( pxStreamBuffer->xLength - xOffset, xCount );
+
+	pxSpans->pucFirst = &( pxStreamBuffer->pucBuffer[ xOffset ] );
+	pxSpans->xFirstLength = xFirstLength;
+
+	if( xCount > xFirstLength )
+	{
+		pxSpans->pucSecond = pxStreamBuffer->pucBuffer;
+		pxSpans->xSecondLength = xCount - xFirstLength;
+	}
+	else
+	{
+		pxSpans->pucSecond = NULL;
+		pxSpans->xSecondLength = 0;
+	}
 
 	return xCount;
 }
@@ -1186,6 +1913,201 @@ size_t xCount, xFirstLength, xNextTail;
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvWriteVectorToBufferAt( StreamBuffer_t * const pxStreamBuffer,
+										size_t xOffset,
+										const StreamBufferIOVec_t * pxVecs,
+										UBaseType_t uxVecCount,
+										size_t xCount )
+{
+size_t xThisCount;
+UBaseType_t uxVec;
+
+	for( uxVec = 0; ( uxVec < uxVecCount ) && ( xCount > ( size_t ) 0 ); uxVec++ )
+	{
+		xThisCount = configMIN( pxVecs[ uxVec ].xLength, xCount );
+
+		if( xThisCount > ( size_t ) 0 )
+		{
+			configASSERT( pxVecs[ uxVec ].pvData );
+			xOffset = prvWriteBytesToBufferAt( pxStreamBuffer, xOffset, ( const uint8_t * ) pxVecs[ uxVec ].pvData, xThisCount ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alighment and access. */
+			xCount -= xThisCount;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+
+	return xOffset;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvVectorLength( const StreamBufferIOVec_t * pxVecs, UBaseType_t uxVecCount )
+{
+size_t xLength = 0;
+UBaseType_t uxVec;
+
+	for( uxVec = 0; uxVec < uxVecCount; uxVec++ )
+	{
+		xLength += pxVecs[ uxVec ].xLength;
+	}
+
+	return xLength;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvSpacesAvailableFrom( const StreamBuffer_t * const pxStreamBuffer, size_t xHead )
+{
+size_t xSpace;
+
+	xSpace = pxStreamBuffer->xLength + pxStreamBuffer->xTail;
+	xSpace -= xHead;
+	xSpace -= ( size_t ) 1;
+
+	if( xSpace >= pxStreamBuffer->xLength )
+	{
+		xSpace -= pxStreamBuffer->xLength;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_STREAM_BUFFER_MULTI_PRODUCER == 1 )
+
+	static size_t prvReserveSpace( StreamBuffer_t * const pxStreamBuffer, size_t xMinCount, size_t xMaxCount, size_t *pxOffset )
+	{
+	uint32_t ulOffset, ulNextOffset;
+	size_t xSpace, xCount;
+
+		/* The reservation is counted before any space is claimed, so a producer
+		that commits in the meantime cannot publish the region this producer is
+		about to write. */
+		( void ) Atomic_Increment_u32( &( pxStreamBuffer->ulPendingCommits ) );
+
+		do
+		{
+			ulOffset = pxStreamBuffer->ulReserveHead;
+			xSpace = prvSpacesAvailableFrom( pxStreamBuffer, ( size_t ) ulOffset );
+
+			if( xSpace < xMinCount )
+			{
+				return ( size_t ) 0;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			xCount = configMIN( xSpace, xMaxCount );
+
+			ulNextOffset = ulOffset + ( uint32_t ) xCount;
+			if( ulNextOffset >= ( uint32_t ) pxStreamBuffer->xLength )
+			{
+				ulNextOffset -= ( uint32_t ) pxStreamBuffer->xLength;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* Another producer may have reserved space since the reservation
+			head was read, in which case try again from the new head. */
+		} while( Atomic_CompareAndSwap_u32( &( pxStreamBuffer->ulReserveHead ), ulNextOffset, ulOffset ) != ATOMIC_COMPARE_AND_SWAP_SUCCESS );
+
+		*pxOffset = ( size_t ) ulOffset;
+
+		return xCount;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCommitSpace( StreamBuffer_t * const pxStreamBuffer )
+	{
+		/* Reading the reservation head and publishing it must be one step,
+		otherwise a producer reserving in between would have its region
+		published before it is written.  This is a handful of instructions
+		regardless of how much data was written. */
+		ATOMIC_ENTER_CRITICAL();
+		{
+			configASSERT( pxStreamBuffer->ulPendingCommits > ( uint32_t ) 0 );
+			pxStreamBuffer->ulPendingCommits--;
+
+			/* Producers that interrupted, or were interrupted by, this one have
+			either committed already or will publish this region when they
+			do. */
+			if( pxStreamBuffer->ulPendingCommits == ( uint32_t ) 0 )
+			{
+				pxStreamBuffer->xHead = ( size_t ) pxStreamBuffer->ulReserveHead;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		ATOMIC_EXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	static size_t prvWriteMessageMultiProducer( StreamBuffer_t * const pxStreamBuffer,
+												const StreamBufferIOVec_t * pxVecs,
+												UBaseType_t uxVecCount,
+												size_t xDataLengthBytes,
+												size_t xRequiredSpace )
+	{
+	size_t xOffset = 0, xReturn = 0;
+
+		if( xDataLengthBytes == ( size_t ) 0 )
+		{
+			return ( size_t ) 0;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+		{
+			/* A message is written whole or not at all. */
+			if( prvReserveSpace( pxStreamBuffer, xRequiredSpace, xRequiredSpace, &xOffset ) != ( size_t ) 0 )
+			{
+				xOffset = prvWriteBytesToBufferAt( pxStreamBuffer, xOffset, ( const uint8_t * ) &( xDataLengthBytes ), sbBYTES_TO_STORE_MESSAGE_LENGTH );
+				( void ) prvWriteVectorToBufferAt( pxStreamBuffer, xOffset, pxVecs, uxVecCount, xDataLengthBytes );
+				xReturn = xDataLengthBytes;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			/* Write as many bytes of the stream as possible. */
+			xReturn = prvReserveSpace( pxStreamBuffer, ( size_t ) 1, xDataLengthBytes, &xOffset );
+
+			if( xReturn != ( size_t ) 0 )
+			{
+				( void ) prvWriteVectorToBufferAt( pxStreamBuffer, xOffset, pxVecs, uxVecCount, xReturn );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+
+		/* Committed even if nothing was reserved, as the reservation was still
+		counted. */
+		prvCommitSpace( pxStreamBuffer );
+
+		return xReturn;
+	}
+
+#endif /* configUSE_STREAM_BUFFER_MULTI_PRODUCER */
+/*-----------------------------------------------------------*/
+
 static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 {
 /* Returns the distance between xTail and xHead. */
@@ -193,6 +193,23 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	#if( ( configDELAYED_TASK_WHEEL_SLOT_BITS < 1 ) || ( configDELAYED_TASK_WHEEL_SLOT_BITS > 5 ) )
+		#error configDELAYED_TASK_WHEEL_SLOT_BITS must be between 1 and 5.
+	#endif
+
+	/* The delayed task wheel splits a tick count into digits of
+	configDELAYED_TASK_WHEEL_SLOT_BITS bits, one digit per level of the wheel,
+	with enough levels to cover every bit of TickType_t. */
+	#define tskWHEEL_SLOTS						( ( UBaseType_t ) 1U << configDELAYED_TASK_WHEEL_SLOT_BITS )
+	#define tskWHEEL_SLOT_MASK					( tskWHEEL_SLOTS - ( UBaseType_t ) 1U )
+	#define tskWHEEL_LEVELS						( ( UBaseType_t ) ( ( ( sizeof( TickType_t ) * 8U ) + ( configDELAYED_TASK_WHEEL_SLOT_BITS - 1U ) ) / configDELAYED_TASK_WHEEL_SLOT_BITS ) )
+	#define tskWHEEL_SHIFT( uxLevel )			( ( uxLevel ) * ( UBaseType_t ) configDELAYED_TASK_WHEEL_SLOT_BITS )
+	#define tskWHEEL_DIGIT( xTime, uxLevel )	( ( UBaseType_t ) ( ( xTime ) >> tskWHEEL_SHIFT( uxLevel ) ) & tskWHEEL_SLOT_MASK )
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
 count overflows. */
 #define taskSWITCH_DELAYED_LISTS()																	\
@@ -222,6 +239,16 @@ count overflows. */
 	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
+#if( configUSE_BUCKETED_EVENT_LISTS == 0 )
+
+	/* Without bucketed event lists a task's event list item can be removed
+	from, or have its priority changed in, any list directly. */
+	#define prvRemoveTaskFromEventList( pxTCB )			( void ) uxListRemove( &( ( pxTCB )->xEventListItem ) )
+	#define prvSetEventListItemValue( pxTCB, xValue )	listSET_LIST_ITEM_VALUE( &( ( pxTCB )->xEventListItem ), ( xValue ) )
+
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+/*-----------------------------------------------------------*/
+
 /*
  * Several functions take an TaskHandle_t parameter that can optionally be NULL,
  * where NULL is used to indicate that the handle of the currently executing
@@ -290,7 +317,8 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	#endif
 
 	#if( configGENERATE_RUN_TIME_STATS == 1 )
-		uint32_t		ulRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
+		configRUN_TIME_COUNTER_TYPE	ulRunTimeCounter;	/*< Stores the amount of time the task has spent in the Running state. */
+		uint32_t		ulSwitchInCount;	/*< Stores the number of times the task has been switched in. */
 	#endif
 
 	#if ( configUSE_NEWLIB_REENTRANT == 1 )
@@ -308,8 +336,8 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments in FreeRTOS.h with the definition of
@@ -341,10 +369,30 @@ xDelayedTaskList1 and xDelayedTaskList2 could be move to function scople but
 doing so breaks some kernel aware debuggers and debuggers that rely on removing
 the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];/*< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	/* When configUSE_DELAYED_TASK_WHEEL is 1 delayed tasks are held in a
+	hierarchical timing wheel instead of two sorted lists.  A task is placed in
+	the level of the most significant digit in which its wake time differs from
+	xDelayedWheelTime, in the slot for that digit of its wake time.  Slots are
+	not sorted, so blocking with a timeout is O(1) however many tasks are
+	already delayed.  Reaching a level 0 slot unblocks every task in it, reaching
+	a slot in a higher level moves its tasks down to lower levels.  Bit n of
+	ulDelayedWheelOccupied[ x ] is set if slot n of level x may contain tasks -
+	tasks leave the wheel through uxListRemove() from many places, so bits are
+	only cleared once the slot is next found to be empty. */
+	PRIVILEGED_DATA static List_t xDelayedTaskWheel[ tskWHEEL_LEVELS ][ tskWHEEL_SLOTS ];	/*< Delayed tasks. */
+	PRIVILEGED_DATA static uint32_t ulDelayedWheelOccupied[ tskWHEEL_LEVELS ];
+	PRIVILEGED_DATA static TickType_t xDelayedWheelTime = ( TickType_t ) 0U;		/*< Every wake time up to and including this time has been processed. */
+
+#else
+
+	PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
+	PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+	PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
+	PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if( INCLUDE_vTaskDelete == 1 )
@@ -392,8 +440,8 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended	= ( UBaseType_t
 
 	/* Do not move these variables to function scope as doing so prevents the
 	code working with debuggers that need to remove the static qualifier. */
-	PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
-	PRIVILEGED_DATA static uint32_t ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
+	PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL;	/*< Holds the value of a timer/counter the last time a task was switched in. */
+	PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL;		/*< Holds the total amount of execution time as defined by the run time counter clock. */
 
 #endif
 
@@ -478,6 +526,17 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
  */
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+/*
+ * Marks a task as no longer waiting on any of its notifications.  A task that
+ * waits on several indexes with uxTaskNotifyWaitAny() is marked as waiting on
+ * each of them, and is unblocked by whichever is notified first.
+ */
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	static void prvClearNotifyWaits( TCB_t *pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -534,6 +593,57 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+
+	/*
+	 * Remove a task's event list item from whichever list it is in, keeping
+	 * the priority tails up to date if that is the event list of a queue.
+	 */
+	static void prvRemoveTaskFromEventList( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Set the item value of a task's event list item.  If the task is waiting
+	 * on a queue it is moved to the position for its new priority.
+	 */
+	static void prvSetEventListItemValue( TCB_t * const pxTCB, const TickType_t xValue ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	/*
+	 * Place a task in the delayed task wheel slot for its wake time, relative
+	 * to the current wheel time.  Returns the time at which the task must next
+	 * be looked at - its wake time if it went into level 0, otherwise the time
+	 * its slot is reached and it moves down a level.
+	 */
+	static TickType_t prvInsertTaskInDelayedWheel( TCB_t * const pxTCB, const TickType_t xTimeToWake ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Place the calling task in the delayed task wheel, bringing
+	 * xNextTaskUnblockTime forward if its slot is the next to be reached.
+	 */
+	static void prvAddCurrentTaskToDelayedWheel( const TickType_t xTimeToWake, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Find the next time at which the delayed task wheel needs processing,
+	 * and the level of the wheel the slot for that time is in.  Returns pdFALSE
+	 * if no tasks are delayed.
+	 */
+	static BaseType_t prvGetNextDelayedWheelEvent( TickType_t * const pxEventTime, UBaseType_t * const puxLevel ) PRIVILEGED_FUNCTION;
+
+	#if( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
+
+		/*
+		 * Returns pdTRUE if pxList is one of the slots of the delayed task
+		 * wheel.
+		 */
+		static BaseType_t prvIsDelayedWheelSlot( const List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+	#endif
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -964,6 +1074,7 @@ UBaseType_t x;
 	#if ( configGENERATE_RUN_TIME_STATS == 1 )
 	{
 		pxNewTCB->ulRunTimeCounter = 0UL;
+		pxNewTCB->ulSwitchInCount = 0UL;
 	}
 	#endif /* configGENERATE_RUN_TIME_STATS */
 
@@ -989,8 +1100,8 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		memset( ( void * ) &( pxNewTCB->ulNotifiedValue[ 0 ] ), 0x00, sizeof( pxNewTCB->ulNotifiedValue ) );
+		memset( ( void * ) &( pxNewTCB->ucNotifyState[ 0 ] ), taskNOT_WAITING_NOTIFICATION, sizeof( pxNewTCB->ucNotifyState ) );
 	}
 	#endif
 
@@ -1182,7 +1293,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			/* Is the task waiting on an event also? */
 			if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
 			{
-				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+				prvRemoveTaskFromEventList( pxTCB );
 			}
 			else
 			{
@@ -1386,7 +1497,10 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 	eTaskState eTaskGetState( TaskHandle_t xTask )
 	{
 	eTaskState eReturn;
-	List_t const * pxStateList, *pxDelayedList, *pxOverflowedDelayedList;
+	List_t const * pxStateList;
+	#if( configUSE_DELAYED_TASK_WHEEL == 0 )
+		List_t const *pxDelayedList, *pxOverflowedDelayedList;
+	#endif
 	const TCB_t * const pxTCB = xTask;
 
 		configASSERT( pxTCB );
@@ -1401,12 +1515,20 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			taskENTER_CRITICAL();
 			{
 				pxStateList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
-				pxDelayedList = pxDelayedTaskList;
-				pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+				#if( configUSE_DELAYED_TASK_WHEEL == 0 )
+				{
+					pxDelayedList = pxDelayedTaskList;
+					pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+				}
+				#endif /* configUSE_DELAYED_TASK_WHEEL */
 			}
 			taskEXIT_CRITICAL();
 
-			if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+				if( prvIsDelayedWheelSlot( pxStateList ) != pdFALSE )
+			#else
+				if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+			#endif
 			{
 				/* The task being queried is referenced from one of the Blocked
 				lists. */
@@ -1423,17 +1545,21 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					{
 						#if( configUSE_TASK_NOTIFICATIONS == 1 )
 						{
+						UBaseType_t uxIndex;
+
 							/* The task does not appear on the event list item of
 							and of the RTOS objects, but could still be in the
-							blocked state if it is waiting on its notification
-							rather than waiting on an object. */
-							if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
-							{
-								eReturn = eBlocked;
-							}
-							else
+							blocked state if it is waiting on one of its
+							notifications rather than waiting on an object. */
+							eReturn = eSuspended;
+
+							for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
 							{
-								eReturn = eSuspended;
+								if( pxTCB->ucNotifyState[ uxIndex ] == taskWAITING_NOTIFICATION )
+								{
+									eReturn = eBlocked;
+									break;
+								}
 							}
 						}
 						#else
@@ -1645,7 +1771,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				being used for anything else. */
 				if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
 				{
-					listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+					prvSetEventListItemValue( pxTCB, ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 				}
 				else
 				{
@@ -1727,7 +1853,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			/* Is the task waiting on an event also? */
 			if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
 			{
-				( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+				prvRemoveTaskFromEventList( pxTCB );
 			}
 			else
 			{
@@ -1738,12 +1864,9 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
-				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
-				}
+				/* The task may have been blocked to wait for a notification,
+				but is now suspended, so no notification was received. */
+				prvClearNotifyWaits( pxTCB );
 			}
 			#endif
 		}
@@ -2462,15 +2585,28 @@ TCB_t *pxTCB;
 			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 			/* Search the delayed lists. */
-			if( pxTCB == NULL )
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+				uxQueue = ( UBaseType_t ) 0U;
+				while( ( pxTCB == NULL ) && ( uxQueue < ( tskWHEEL_LEVELS * tskWHEEL_SLOTS ) ) )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( &( xDelayedTaskWheel[ uxQueue / tskWHEEL_SLOTS ][ uxQueue & tskWHEEL_SLOT_MASK ] ), pcNameToQuery );
+					uxQueue++;
+				}
 			}
-
-			if( pxTCB == NULL )
+			#else
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+				}
+
+				if( pxTCB == NULL )
+				{
+					pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				}
 			}
+			#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 			#if ( INCLUDE_vTaskSuspend == 1 )
 			{
@@ -2502,7 +2638,7 @@ TCB_t *pxTCB;
 
 #if ( configUSE_TRACE_FACILITY == 1 )
 
-	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
+	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime )
 	{
 	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
 
@@ -2522,8 +2658,19 @@ TCB_t *pxTCB;
 
 				/* Fill in an TaskStatus_t structure with information on each
 				task in the Blocked state. */
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+				{
+					for( uxQueue = ( UBaseType_t ) 0U; uxQueue < ( tskWHEEL_LEVELS * tskWHEEL_SLOTS ); uxQueue++ )
+					{
+						uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedTaskWheel[ uxQueue / tskWHEEL_SLOTS ][ uxQueue & tskWHEEL_SLOT_MASK ] ), eBlocked );
+					}
+				}
+				#else
+				{
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				}
+				#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 				#if( INCLUDE_vTaskDelete == 1 )
 				{
@@ -2600,6 +2747,18 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 		each stepped tick. */
 		configASSERT( ( xTickCount + xTicksToJump ) <= xNextTaskUnblockTime );
 		xTickCount += xTicksToJump;
+
+		#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+		{
+			/* Nothing in the wheel was due during the stepped ticks, so the
+			wheel can be moved on too - unless something is due now, in which
+			case the next tick interrupt will process it. */
+			if( xTickCount < xNextTaskUnblockTime )
+			{
+				xDelayedWheelTime = xTickCount;
+			}
+		}
+		#endif /* configUSE_DELAYED_TASK_WHEEL */
 		traceINCREASE_TICK_COUNT( xTicksToJump );
 	}
 
@@ -2654,7 +2813,7 @@ BaseType_t xYieldRequired = pdFALSE;
 				{
 					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
 					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+						prvRemoveTaskFromEventList( pxTCB );
 
 						/* This lets the task know it was forcibly removed from the
 						blocked state so it should not re-evaluate its block time and
@@ -2707,7 +2866,9 @@ BaseType_t xYieldRequired = pdFALSE;
 BaseType_t xTaskIncrementTick( void )
 {
 TCB_t * pxTCB;
-TickType_t xItemValue;
+#if( configUSE_DELAYED_TASK_WHEEL == 0 )
+	TickType_t xItemValue;
+#endif
 BaseType_t xSwitchRequired = pdFALSE;
 
 	/* Called by the portable layer each time a tick interrupt occurs.
@@ -2724,96 +2885,199 @@ BaseType_t xSwitchRequired = pdFALSE;
 		delayed lists if it wraps to 0. */
 		xTickCount = xConstTickCount;
 
-		if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
+		#if( configUSE_DELAYED_TASK_WHEEL == 1 )
 		{
-			taskSWITCH_DELAYED_LISTS();
-		}
-		else
-		{
-			mtCOVERAGE_TEST_MARKER();
-		}
+		TickType_t xEventTime;
+		UBaseType_t uxLevel;
+		List_t *pxSlot;
 
-		/* See if this tick has made a timeout expire.  Tasks are stored in
-		the	queue in the order of their wake time - meaning once one task
-		has been found whose block time has not expired there is no need to
-		look any further down the list. */
-		if( xConstTickCount >= xNextTaskUnblockTime )
-		{
-			for( ;; )
+			if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
 			{
-				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-				{
-					/* The delayed list is empty.  Set xNextTaskUnblockTime
-					to the maximum possible value so it is extremely
-					unlikely that the
-					if( xTickCount >= xNextTaskUnblockTime ) test will pass
-					next time through. */
-					xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-					break;
-				}
-				else
+				/* Wake times beyond the overflow were left out of
+				xNextTaskUnblockTime, they can be considered now. */
+				xNumOfOverflows++;
+				prvResetNextTaskUnblockTime();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xConstTickCount >= xNextTaskUnblockTime )
+			{
+				/* Process every event in the wheel up to the current time, in
+				time order.  Each is either a level 0 slot of tasks that are all
+				due to wake at the event time, or a higher level slot of tasks
+				to move down a level. */
+				while( prvGetNextDelayedWheelEvent( &xEventTime, &uxLevel ) != pdFALSE )
 				{
-					/* The delayed list is not empty, get the value of the
-					item at the head of the delayed list.  This is the time
-					at which the task at the head of the delayed list must
-					be removed from the Blocked state. */
-					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
-
-					if( xConstTickCount < xItemValue )
+					if( ( TickType_t ) ( xEventTime - xDelayedWheelTime ) > ( TickType_t ) ( xConstTickCount - xDelayedWheelTime ) )
 					{
-						/* It is not time to unblock this item yet, but the
-						item value is the time at which the task at the head
-						of the blocked list must be removed from the Blocked
-						state -	so record the item value in
-						xNextTaskUnblockTime. */
-						xNextTaskUnblockTime = xItemValue;
-						break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
+						break;
 					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
 					}
 
-					/* It is time to remove the item from the Blocked state. */
-					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					xDelayedWheelTime = xEventTime;
+					pxSlot = &( xDelayedTaskWheel[ uxLevel ][ tskWHEEL_DIGIT( xEventTime, uxLevel ) ] );
 
-					/* Is the task waiting on an event also?  If so remove
-					it from the event list. */
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+					while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+					{
+						pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+
+						if( uxLevel != ( UBaseType_t ) 0U )
+						{
+							/* The wheel time has reached this task's slot, so
+							it goes into a lower level. */
+							( void ) prvInsertTaskInDelayedWheel( pxTCB, listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) );
+							continue;
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						/* It is time to remove the task from the Blocked
+						state.  Is it waiting on an event also?  If so remove
+						it from the event list. */
+						if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+						{
+							prvRemoveTaskFromEventList( pxTCB );
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						prvAddTaskToReadyList( pxTCB );
+
+						#if (  configUSE_PREEMPTION == 1 )
+						{
+							if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+							{
+								xSwitchRequired = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif /* configUSE_PREEMPTION */
+					}
+
+					ulDelayedWheelOccupied[ uxLevel ] &= ~( 1UL << tskWHEEL_DIGIT( xEventTime, uxLevel ) );
+				}
+
+				/* Nothing else is due up to the current time. */
+				xDelayedWheelTime = xConstTickCount;
+				prvResetNextTaskUnblockTime();
+			}
+			else
+			{
+				/* Nothing is due up to the current time, so the wheel can move
+				straight on to it without any task changing slot.  This keeps
+				the wheel time close enough to the tick count for any block
+				time to be placed in the wheel. */
+				xDelayedWheelTime = xConstTickCount;
+			}
+		}
+		#else
+		{
+			if( xConstTickCount == ( TickType_t ) 0U ) /*lint !e774 'if' does not always evaluate to false as it is looking for an overflow. */
+			{
+				taskSWITCH_DELAYED_LISTS();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			/* See if this tick has made a timeout expire.  Tasks are stored in
+			the	queue in the order of their wake time - meaning once one task
+			has been found whose block time has not expired there is no need to
+			look any further down the list. */
+			if( xConstTickCount >= xNextTaskUnblockTime )
+			{
+				for( ;; )
+				{
+					if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
 					{
-						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+						/* The delayed list is empty.  Set xNextTaskUnblockTime
+						to the maximum possible value so it is extremely
+						unlikely that the
+						if( xTickCount >= xNextTaskUnblockTime ) test will pass
+						next time through. */
+						xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+						break;
 					}
 					else
 					{
-						mtCOVERAGE_TEST_MARKER();
-					}
+						/* The delayed list is not empty, get the value of the
+						item at the head of the delayed list.  This is the time
+						at which the task at the head of the delayed list must
+						be removed from the Blocked state. */
+						pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+						xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
+
+						if( xConstTickCount < xItemValue )
+						{
+							/* It is not time to unblock this item yet, but the
+							item value is the time at which the task at the head
+							of the blocked list must be removed from the Blocked
+							state -	so record the item value in
+							xNextTaskUnblockTime. */
+							xNextTaskUnblockTime = xItemValue;
+							break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
 
-					/* Place the unblocked task into the appropriate ready
-					list. */
-					prvAddTaskToReadyList( pxTCB );
+						/* It is time to remove the item from the Blocked state. */
+						( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 
-					/* A task being unblocked cannot cause an immediate
-					context switch if preemption is turned off. */
-					#if (  configUSE_PREEMPTION == 1 )
-					{
-						/* Preemption is on, but a context switch should
-						only be performed if the unblocked task has a
-						priority that is equal to or higher than the
-						currently executing task. */
-						if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+						/* Is the task waiting on an event also?  If so remove
+						it from the event list. */
+						if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
 						{
-							xSwitchRequired = pdTRUE;
+							prvRemoveTaskFromEventList( pxTCB );
 						}
 						else
 						{
 							mtCOVERAGE_TEST_MARKER();
 						}
+
+						/* Place the unblocked task into the appropriate ready
+						list. */
+						prvAddTaskToReadyList( pxTCB );
+
+						/* A task being unblocked cannot cause an immediate
+						context switch if preemption is turned off. */
+						#if (  configUSE_PREEMPTION == 1 )
+						{
+							/* Preemption is on, but a context switch should
+							only be performed if the unblocked task has a
+							priority that is equal to or higher than the
+							currently executing task. */
+							if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+							{
+								xSwitchRequired = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						#endif /* configUSE_PREEMPTION */
 					}
-					#endif /* configUSE_PREEMPTION */
 				}
 			}
 		}
+		#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 		/* Tasks of equal priority to the currently running task will share
 		processing time (time slice) if preemption is on, and the application
@@ -2996,6 +3260,10 @@ void vTaskSwitchContext( void )
 	}
 	else
 	{
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+			TCB_t * const pxPreviousTCB = pxCurrentTCB;
+		#endif
+
 		xYieldPending = pdFALSE;
 		traceTASK_SWITCHED_OUT();
 
@@ -3041,6 +3309,20 @@ void vTaskSwitchContext( void )
 		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 		traceTASK_SWITCHED_IN();
 
+		#if ( configGENERATE_RUN_TIME_STATS == 1 )
+		{
+			/* Only count switches to a different task. */
+			if( pxCurrentTCB != pxPreviousTCB )
+			{
+				( pxCurrentTCB->ulSwitchInCount )++;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif /* configGENERATE_RUN_TIME_STATS */
+
 		/* After the new task is switched in, update the global errno. */
 		#if( configUSE_POSIX_ERRNO == 1 )
 		{
@@ -3061,7 +3343,7 @@ void vTaskSwitchContext( void )
 }
 /*-----------------------------------------------------------*/
 
-void vTaskPlaceOnEventList( List_t * const pxEventList, const TickType_t xTicksToWait )
+void vTaskPlaceOnEventList( EventList_t * const pxEventList, const TickType_t xTicksToWait )
 {
 	configASSERT( pxEventList );
 
@@ -3072,7 +3354,7 @@ void vTaskPlaceOnEventList( List_t * const pxEventList, const TickType_t xTicksT
 	This is placed in the list in priority order so the highest priority task
 	is the first to be woken by the event.  The queue that contains the event
 	list is locked, preventing simultaneous access from interrupts. */
-	vListInsert( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+	vListInsertInEventList( pxEventList, &( pxCurrentTCB->xEventListItem ) );
 
 	prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
 }
@@ -3104,7 +3386,7 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList, const TickType_t xIte
 
 #if( configUSE_TIMERS == 1 )
 
-	void vTaskPlaceOnEventListRestricted( List_t * const pxEventList, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely )
+	void vTaskPlaceOnEventListRestricted( EventList_t * const pxEventList, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely )
 	{
 		configASSERT( pxEventList );
 
@@ -3117,8 +3399,17 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList, const TickType_t xIte
 		/* Place the event list item of the TCB in the appropriate event list.
 		In this case it is assume that this is the only task that is going to
 		be waiting on this event list, so the faster vListInsertEnd() function
-		can be used in place of vListInsert. */
-		vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+		can be used in place of vListInsert.  A bucketed event list has its own
+		constant time insertion, which also keeps its tails up to date. */
+		#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+		{
+			vListInsertInEventList( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+		}
+		#else
+		{
+			vListInsertEnd( pxEventList, &( pxCurrentTCB->xEventListItem ) );
+		}
+		#endif /* configUSE_BUCKETED_EVENT_LISTS */
 
 		/* If the task should block indefinitely then set the block time to a
 		value that will be recognised as an indefinite delay inside the
@@ -3135,7 +3426,7 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList, const TickType_t xIte
 #endif /* configUSE_TIMERS */
 /*-----------------------------------------------------------*/
 
-BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
+BaseType_t xTaskRemoveFromEventList( const EventList_t * const pxEventList )
 {
 TCB_t *pxUnblockedTCB;
 BaseType_t xReturn;
@@ -3153,9 +3444,9 @@ BaseType_t xReturn;
 
 	This function assumes that a check has already been made to ensure that
 	pxEventList is not empty. */
-	pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( listEVENT_LIST_WAITERS( pxEventList ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 	configASSERT( pxUnblockedTCB );
-	( void ) uxListRemove( &( pxUnblockedTCB->xEventListItem ) );
+	( void ) uxListRemoveFromEventList( &( pxUnblockedTCB->xEventListItem ) );
 
 	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 	{
@@ -3251,6 +3542,66 @@ TCB_t *pxUnblockedTCB;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_EVENT_GROUP_DIRECT_ISR == 1 )
+
+	BaseType_t xTaskRemoveFromUnorderedEventListFromISR( ListItem_t * pxEventListItem, const TickType_t xItemValue )
+	{
+	TCB_t *pxUnblockedTCB;
+	BaseType_t xReturn;
+
+		/* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION, OR WITH
+		INTERRUPTS MASKED WITHIN AN ISR.  It is used by event groups that are
+		updated directly from interrupts, and unlike
+		vTaskRemoveFromUnorderedEventList() the scheduler need not be
+		suspended. */
+
+		/* Store the new item value in the event list. */
+		listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+		/* The event group is not locked by a task, so exclusive access to its
+		list of waiting tasks is guaranteed by the critical section. */
+		pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+		configASSERT( pxUnblockedTCB );
+		( void ) uxListRemove( pxEventListItem );
+
+		if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+		{
+			( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+			prvAddTaskToReadyList( pxUnblockedTCB );
+
+			#if( configUSE_TICKLESS_IDLE != 0 )
+			{
+				/* See the comment in xTaskRemoveFromEventList(). */
+				prvResetNextTaskUnblockTime();
+			}
+			#endif
+		}
+		else
+		{
+			/* The delayed and ready lists cannot be accessed, so hold this
+			task pending until the scheduler is resumed. */
+			vListInsertEnd( &( xPendingReadyList ), pxEventListItem );
+		}
+
+		if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+		{
+			/* Mark that a yield is pending in case the user is not using the
+			"xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS
+			function. */
+			xReturn = pdTRUE;
+			xYieldPending = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR */
+/*-----------------------------------------------------------*/
+
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
 {
 	configASSERT( pxTimeOut );
@@ -3613,8 +3964,24 @@ UBaseType_t uxPriority;
 		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
 	}
 
-	vListInitialise( &xDelayedTaskList1 );
-	vListInitialise( &xDelayedTaskList2 );
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+	{
+	UBaseType_t uxLevel, uxSlot;
+
+		for( uxLevel = ( UBaseType_t ) 0U; uxLevel < tskWHEEL_LEVELS; uxLevel++ )
+		{
+			for( uxSlot = ( UBaseType_t ) 0U; uxSlot < tskWHEEL_SLOTS; uxSlot++ )
+			{
+				vListInitialise( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ) );
+			}
+		}
+	}
+	#else
+	{
+		vListInitialise( &xDelayedTaskList1 );
+		vListInitialise( &xDelayedTaskList2 );
+	}
+	#endif /* configUSE_DELAYED_TASK_WHEEL */
 	vListInitialise( &xPendingReadyList );
 
 	#if ( INCLUDE_vTaskDelete == 1 )
@@ -3629,10 +3996,14 @@ UBaseType_t uxPriority;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 
-	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-	using list2. */
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	#if( configUSE_DELAYED_TASK_WHEEL == 0 )
+	{
+		/* Start with pxDelayedTaskList using list1 and the
+		pxOverflowDelayedTaskList using list2. */
+		pxDelayedTaskList = &xDelayedTaskList1;
+		pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	}
+	#endif /* configUSE_DELAYED_TASK_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
@@ -3693,10 +4064,12 @@ static void prvCheckTasksWaitingTermination( void )
 		#if ( configGENERATE_RUN_TIME_STATS == 1 )
 		{
 			pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
+			pxTaskStatus->ulSwitchInCount = pxTCB->ulSwitchInCount;
 		}
 		#else
 		{
 			pxTaskStatus->ulRunTimeCounter = 0;
+			pxTaskStatus->ulSwitchInCount = 0;
 		}
 		#endif
 
@@ -3756,6 +4129,14 @@ static void prvCheckTasksWaitingTermination( void )
 		{
 			pxTaskStatus->usStackHighWaterMark = 0;
 		}
+
+		/* Both ends of the stack are only known when the high address is
+		recorded, or the stack grows up. */
+		#if( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
+		{
+			pxTaskStatus->usStackDepth = ( configSTACK_DEPTH_TYPE ) ( ( pxTCB->pxEndOfStack - pxTCB->pxStack ) + 1 );
+		}
+		#endif
 	}
 
 #endif /* configUSE_TRACE_FACILITY */
@@ -3942,28 +4323,218 @@ static void prvCheckTasksWaitingTermination( void )
 
 static void prvResetNextTaskUnblockTime( void )
 {
-TCB_t *pxTCB;
-
-	if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+	#if( configUSE_DELAYED_TASK_WHEEL == 1 )
 	{
-		/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-		the maximum possible value so it is	extremely unlikely that the
-		if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-		there is an item in the delayed list. */
-		xNextTaskUnblockTime = portMAX_DELAY;
+	TickType_t xEventTime;
+	UBaseType_t uxLevel;
+
+		if( prvGetNextDelayedWheelEvent( &xEventTime, &uxLevel ) == pdFALSE )
+		{
+			/* No tasks are delayed. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		else if( ( TickType_t ) ( xEventTime - xDelayedWheelTime ) <= ( TickType_t ) ( xTickCount - xDelayedWheelTime ) )
+		{
+			/* The event is already due, so process it on the next tick. */
+			xNextTaskUnblockTime = xTickCount;
+		}
+		else if( xEventTime < xTickCount )
+		{
+			/* The event is beyond the next tick count overflow, the same as
+			a task in the overflow delayed list.  xNextTaskUnblockTime is
+			reset again when the tick count overflows. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		else
+		{
+			xNextTaskUnblockTime = xEventTime;
+		}
 	}
-	else
+	#else
 	{
-		/* The new current delayed list is not empty, get the value of
-		the item at the head of the delayed list.  This is the time at
-		which the task at the head of the delayed list should be removed
-		from the Blocked state. */
-		( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+	TCB_t *pxTCB;
+
+		if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+		{
+			/* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+			the maximum possible value so it is	extremely unlikely that the
+			if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+			there is an item in the delayed list. */
+			xNextTaskUnblockTime = portMAX_DELAY;
+		}
+		else
+		{
+			/* The new current delayed list is not empty, get the value of
+			the item at the head of the delayed list.  This is the time at
+			which the task at the head of the delayed list should be removed
+			from the Blocked state. */
+			( pxTCB ) = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
+		}
 	}
+	#endif /* configUSE_DELAYED_TASK_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+	static TickType_t prvInsertTaskInDelayedWheel( TCB_t * const pxTCB, const TickType_t xTimeToWake )
+	{
+	TickType_t xDifference;
+	UBaseType_t uxLevel = ( UBaseType_t ) 0U, uxSlot;
+
+		/* Find the most significant digit in which the wake time differs from
+		the wheel time.  This is a fixed number of steps, not dependent on the
+		number of delayed tasks. */
+		xDifference = xTimeToWake ^ xDelayedWheelTime;
+		while( ( uxLevel < ( tskWHEEL_LEVELS - ( UBaseType_t ) 1U ) ) && ( ( xDifference >> tskWHEEL_SHIFT( uxLevel + ( UBaseType_t ) 1U ) ) != ( TickType_t ) 0U ) )
+		{
+			uxLevel++;
+		}
+
+		uxSlot = tskWHEEL_DIGIT( xTimeToWake, uxLevel );
+		vListInsertEnd( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ), &( pxTCB->xStateListItem ) );
+		ulDelayedWheelOccupied[ uxLevel ] |= ( 1UL << uxSlot );
+
+		/* The slot is reached when the wheel time's digits from this level up
+		match the wake time's. */
+		return xTimeToWake & ~( ( ( TickType_t ) 1U << tskWHEEL_SHIFT( uxLevel ) ) - ( TickType_t ) 1U );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvAddCurrentTaskToDelayedWheel( const TickType_t xTimeToWake, const TickType_t xConstTickCount )
+	{
+	TickType_t xEventTime;
+
+		xEventTime = prvInsertTaskInDelayedWheel( pxCurrentTCB, xTimeToWake );
+
+		/* An event time below the tick count is beyond the next tick count
+		overflow, which updates xNextTaskUnblockTime itself. */
+		if( ( xEventTime >= xConstTickCount ) && ( xEventTime < xNextTaskUnblockTime ) )
+		{
+			xNextTaskUnblockTime = xEventTime;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static BaseType_t prvGetNextDelayedWheelEvent( TickType_t * const pxEventTime, UBaseType_t * const puxLevel )
+	{
+	UBaseType_t uxLevel, uxDigit, uxOffset, uxSlot;
+
+		/* Tasks in a lower level are always due before those in a higher
+		level, so the next event is in the lowest level that contains any
+		tasks.  Search forward from the wheel time's own slot, only level 0
+		can hold tasks in that slot, ones that wake at the wheel time. */
+		for( uxLevel = ( UBaseType_t ) 0U; uxLevel < tskWHEEL_LEVELS; uxLevel++ )
+		{
+			uxDigit = tskWHEEL_DIGIT( xDelayedWheelTime, uxLevel );
+			uxOffset = ( UBaseType_t ) 0U;
+
+			while( ulDelayedWheelOccupied[ uxLevel ] != 0UL )
+			{
+				uxSlot = ( uxDigit + uxOffset ) & tskWHEEL_SLOT_MASK;
+
+				if( ( ulDelayedWheelOccupied[ uxLevel ] & ( 1UL << uxSlot ) ) == 0UL )
+				{
+					uxOffset++;
+				}
+				else if( listLIST_IS_EMPTY( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ) ) != pdFALSE )
+				{
+					/* Every task in the slot left the Blocked state early. */
+					ulDelayedWheelOccupied[ uxLevel ] &= ~( 1UL << uxSlot );
+					uxOffset++;
+				}
+				else
+				{
+					*pxEventTime = xDelayedWheelTime & ~( ( ( TickType_t ) 1U << tskWHEEL_SHIFT( uxLevel ) ) - ( TickType_t ) 1U );
+					*pxEventTime += ( TickType_t ) ( ( TickType_t ) uxOffset << tskWHEEL_SHIFT( uxLevel ) );
+					*puxLevel = uxLevel;
+					return pdTRUE;
+				}
+			}
+		}
+
+		return pdFALSE;
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
+
+		static BaseType_t prvIsDelayedWheelSlot( const List_t * const pxList )
+		{
+		const portPOINTER_SIZE_TYPE uxFirstSlot = ( portPOINTER_SIZE_TYPE ) &( xDelayedTaskWheel[ 0 ][ 0 ] );
+		const portPOINTER_SIZE_TYPE uxList = ( portPOINTER_SIZE_TYPE ) pxList;
+		UBaseType_t uxSlot;
+		BaseType_t xReturn = pdFALSE;
+
+			/* The slots are one contiguous array, so the list is a slot if its
+			address falls inside the array. */
+			if( ( uxList >= uxFirstSlot ) && ( ( uxList - uxFirstSlot ) < ( portPOINTER_SIZE_TYPE ) sizeof( xDelayedTaskWheel ) ) )
+			{
+				uxSlot = ( UBaseType_t ) ( ( uxList - uxFirstSlot ) / ( portPOINTER_SIZE_TYPE ) sizeof( List_t ) );
+				configASSERT( pxList == &( xDelayedTaskWheel[ uxSlot / tskWHEEL_SLOTS ][ uxSlot & tskWHEEL_SLOT_MASK ] ) );
+				( void ) uxSlot;
+				xReturn = pdTRUE;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			return xReturn;
+		}
+		/*-----------------------------------------------------------*/
+
+	#endif
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+#if( configUSE_BUCKETED_EVENT_LISTS == 1 )
+
+	static void prvRemoveTaskFromEventList( TCB_t * const pxTCB )
+	{
+	const List_t * const pxContainer = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+		/* Apart from the pending ready list, the only lists a task's event list
+		item is placed in without its priority as the item value are the
+		unordered lists of event groups, which mark the value as in use. */
+		if( ( pxContainer == &xPendingReadyList ) || ( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) != 0UL ) )
+		{
+			( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+		}
+		else
+		{
+			( void ) uxListRemoveFromEventList( &( pxTCB->xEventListItem ) );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvSetEventListItemValue( TCB_t * const pxTCB, const TickType_t xValue )
+	{
+	List_t * const pxContainer = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+		/* Callers only change the value when it is not in use, so if the item
+		is in a list other than the pending ready list it is in the event list
+		of a queue.  Move it to keep the list in priority order. */
+		if( ( pxContainer != NULL ) && ( pxContainer != &xPendingReadyList ) )
+		{
+			( void ) uxListRemoveFromEventList( &( pxTCB->xEventListItem ) );
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), xValue );
+			vListInsertInEventList( ( EventList_t * ) pxContainer, &( pxTCB->xEventListItem ) ); /*lint !e9087 !e740 EventList_t starts with the List_t the item was in. */
+		}
+		else
+		{
+			listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), xValue );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_BUCKETED_EVENT_LISTS */
+
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
 
 	TaskHandle_t xTaskGetCurrentTaskHandle( void )
@@ -4031,7 +4602,7 @@ TCB_t *pxTCB;
 				not being used for anything else. */
 				if( ( listGET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
 				{
-					listSET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+					prvSetEventListItemValue( pxMutexHolderTCB, ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 				}
 				else
 				{
@@ -4231,7 +4802,7 @@ TCB_t *pxTCB;
 					being used for anything else. */
 					if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
 					{
-						listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriorityToUse ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+						prvSetEventListItemValue( pxTCB, ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriorityToUse ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 					}
 					else
 					{
@@ -4478,7 +5049,7 @@ TCB_t *pxTCB;
 	{
 	TaskStatus_t *pxTaskStatusArray;
 	UBaseType_t uxArraySize, x;
-	uint32_t ulTotalTime, ulStatsAsPercentage;
+	configRUN_TIME_COUNTER_TYPE ulTotalTime, ulStatsAsPercentage;
 
 		#if( configUSE_TRACE_FACILITY != 1 )
 		{
@@ -4551,7 +5122,7 @@ TCB_t *pxTCB;
 					{
 						#ifdef portLU_PRINTF_SPECIFIER_REQUIRED
 						{
-							sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
+							sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", ( unsigned long ) pxTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned long ) ulStatsAsPercentage );
 						}
 						#else
 						{
@@ -4567,7 +5138,7 @@ TCB_t *pxTCB;
 						consumed less than 1% of the total run time. */
 						#ifdef portLU_PRINTF_SPECIFIER_REQUIRED
 						{
-							sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter );
+							sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", ( unsigned long ) pxTaskStatusArray[ x ].ulRunTimeCounter );
 						}
 						#else
 						{
@@ -4632,17 +5203,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4670,17 +5243,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4688,7 +5261,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4700,22 +5273,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4748,14 +5323,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4764,11 +5339,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4780,12 +5355,13 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
 
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 		configASSERT( xTaskToNotify );
 		pxTCB = xTaskToNotify;
 
@@ -4793,31 +5369,31 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4835,7 +5411,7 @@ TickType_t uxReturn;
 					/* Should not get here if all enums are handled.
 					Artificially force an assert by testing a value the
 					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
+					configASSERT( pxTCB->ulNotifiedValue[ uxIndexToNotify ] == ~0UL );
 
 					break;
 			}
@@ -4846,6 +5422,8 @@ TickType_t uxReturn;
 			notification then unblock it now. */
 			if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
 			{
+				prvClearNotifyWaits( pxTCB );
+
 				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
 				prvAddTaskToReadyList( pxTCB );
 
@@ -4894,7 +5472,7 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
@@ -4902,6 +5480,7 @@ TickType_t uxReturn;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4927,30 +5506,30 @@ TickType_t uxReturn;
 		{
 			if( pulPreviousNotificationValue != NULL )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
 			}
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			switch( eAction )
 			{
 				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
 					break;
 
 				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
+					( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 					break;
 
 				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					break;
 
 				case eSetValueWithoutOverwrite :
 					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
 					}
 					else
 					{
@@ -4968,7 +5547,7 @@ TickType_t uxReturn;
 					/* Should not get here if all enums are handled.
 					Artificially force an assert by testing a value the
 					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
+					configASSERT( pxTCB->ulNotifiedValue[ uxIndexToNotify ] == ~0UL );
 					break;
 			}
 
@@ -4978,6 +5557,8 @@ TickType_t uxReturn;
 			notification then unblock it now. */
 			if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
 			{
+				prvClearNotifyWaits( pxTCB );
+
 				/* The task should not have been on an event list. */
 				configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
 
@@ -5023,13 +5604,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -5053,12 +5635,12 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -5066,6 +5648,8 @@ TickType_t uxReturn;
 			notification then unblock it now. */
 			if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
 			{
+				prvClearNotifyWaits( pxTCB );
+
 				/* The task should not have been on an event list. */
 				configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
 
@@ -5109,20 +5693,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -5140,11 +5726,13 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyValueClear( TaskHandle_t xTask, uint32_t ulBitsToClear )
+	uint32_t ulTaskGenericNotifyValueClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear )
 	{
 	TCB_t *pxTCB;
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
@@ -5153,8 +5741,8 @@ TickType_t uxReturn;
 		{
 			/* Return the notification as it was before the bits were cleared,
 			then clear the bit mask. */
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
-			pxTCB->ulNotifiedValue &= ~ulBitsToClear;
+			ulReturn = pxTCB->ulNotifiedValue[ uxIndexToClear ];
+			pxTCB->ulNotifiedValue[ uxIndexToClear ] &= ~ulBitsToClear;
 		}
 		taskEXIT_CRITICAL();
 
@@ -5164,9 +5752,113 @@ TickType_t uxReturn;
 #endif /* configUSE_TASK_NOTIFICATIONS */
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	UBaseType_t uxTaskNotifyWaitAny( UBaseType_t uxIndexesToWaitOn, TickType_t xTicksToWait )
+	{
+	UBaseType_t uxIndex, uxPending = 0;
+
+		configASSERT( uxIndexesToWaitOn != 0 );
+		configASSERT( ( uxIndexesToWaitOn >> configTASK_NOTIFICATION_ARRAY_ENTRIES ) == 0 );
+
+		taskENTER_CRITICAL();
+		{
+			/* Only block if none of the notifications is already pending. */
+			for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+			{
+				if( ( ( uxIndexesToWaitOn & ( ( UBaseType_t ) 1 << uxIndex ) ) != 0 ) &&
+					( pxCurrentTCB->ucNotifyState[ uxIndex ] == taskNOTIFICATION_RECEIVED ) )
+				{
+					uxPending |= ( UBaseType_t ) 1 << uxIndex;
+				}
+			}
+
+			if( uxPending == 0 )
+			{
+				/* Mark this task as waiting on each of the notifications, the
+				first to be notified unblocks it. */
+				for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+				{
+					if( ( uxIndexesToWaitOn & ( ( UBaseType_t ) 1 << uxIndex ) ) != 0 )
+					{
+						pxCurrentTCB->ucNotifyState[ uxIndex ] = taskWAITING_NOTIFICATION;
+					}
+				}
+
+				if( xTicksToWait > ( TickType_t ) 0 )
+				{
+					prvAddCurrentTaskToDelayedList( xTicksToWait, pdTRUE );
+					traceTASK_NOTIFY_WAIT_BLOCK();
+
+					/* All ports are written to allow a yield in a critical
+					section (some will yield immediately, others wait until the
+					critical section exits) - but it is not something that
+					application code should ever do. */
+					portYIELD_WITHIN_API();
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		taskENTER_CRITICAL();
+		{
+			traceTASK_NOTIFY_WAIT();
+
+			/* The notifications are left pending for the task to take. */
+			uxPending = 0;
+			for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+			{
+				if( ( ( uxIndexesToWaitOn & ( ( UBaseType_t ) 1 << uxIndex ) ) != 0 ) &&
+					( pxCurrentTCB->ucNotifyState[ uxIndex ] == taskNOTIFICATION_RECEIVED ) )
+				{
+					uxPending |= ( UBaseType_t ) 1 << uxIndex;
+				}
+			}
+
+			/* After a timeout the task is still marked as waiting. */
+			prvClearNotifyWaits( pxCurrentTCB );
+		}
+		taskEXIT_CRITICAL();
+
+		return uxPending;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	static void prvClearNotifyWaits( TCB_t *pxTCB )
+	{
+	UBaseType_t uxIndex;
+
+		for( uxIndex = 0; uxIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES; uxIndex++ )
+		{
+			if( pxTCB->ucNotifyState[ uxIndex ] == taskWAITING_NOTIFICATION )
+			{
+				pxTCB->ucNotifyState[ uxIndex ] = taskNOT_WAITING_NOTIFICATION;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
 #if( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) )
 
-	uint32_t ulTaskGetIdleRunTimeCounter( void )
+	configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void )
 	{
 		return xIdleTaskHandle->ulRunTimeCounter;
 	}
@@ -5220,30 +5912,38 @@ const TickType_t xConstTickCount = xTickCount;
 			/* The list item will be inserted in wake time order. */
 			listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-			if( xTimeToWake < xConstTickCount )
+			#if( configUSE_DELAYED_TASK_WHEEL == 1 )
 			{
-				/* Wake time has overflowed.  Place this item in the overflow
-				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				prvAddCurrentTaskToDelayedWheel( xTimeToWake, xConstTickCount );
 			}
-			else
+			#else
 			{
-				/* The wake time has not overflowed, so the current block list
-				is used. */
-				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-
-				/* If the task entering the blocked state was placed at the
-				head of the list of blocked tasks then xNextTaskUnblockTime
-				needs to be updated too. */
-				if( xTimeToWake < xNextTaskUnblockTime )
+				if( xTimeToWake < xConstTickCount )
 				{
-					xNextTaskUnblockTime = xTimeToWake;
+					/* Wake time has overflowed.  Place this item in the overflow
+					list. */
+					vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
 				}
 				else
 				{
-					mtCOVERAGE_TEST_MARKER();
+					/* The wake time has not overflowed, so the current block list
+					is used. */
+					vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+
+					/* If the task entering the blocked state was placed at the
+					head of the list of blocked tasks then xNextTaskUnblockTime
+					needs to be updated too. */
+					if( xTimeToWake < xNextTaskUnblockTime )
+					{
+						xNextTaskUnblockTime = xTimeToWake;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
 				}
 			}
+			#endif /* configUSE_DELAYED_TASK_WHEEL */
 		}
 	}
 	#else /* INCLUDE_vTaskSuspend */
@@ -5256,28 +5956,36 @@ const TickType_t xConstTickCount = xTickCount;
 		/* The list item will be inserted in wake time order. */
 		listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-		if( xTimeToWake < xConstTickCount )
+		#if( configUSE_DELAYED_TASK_WHEEL == 1 )
 		{
-			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			prvAddCurrentTaskToDelayedWheel( xTimeToWake, xConstTickCount );
 		}
-		else
+		#else
 		{
-			/* The wake time has not overflowed, so the current block list is used. */
-			vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
-
-			/* If the task entering the blocked state was placed at the head of the
-			list of blocked tasks then xNextTaskUnblockTime needs to be updated
-			too. */
-			if( xTimeToWake < xNextTaskUnblockTime )
+			if( xTimeToWake < xConstTickCount )
 			{
-				xNextTaskUnblockTime = xTimeToWake;
+				/* Wake time has overflowed.  Place this item in the overflow list. */
+				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
 			}
 			else
 			{
-				mtCOVERAGE_TEST_MARKER();
+				/* The wake time has not overflowed, so the current block list is used. */
+				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+
+				/* If the task entering the blocked state was placed at the head of the
+				list of blocked tasks then xNextTaskUnblockTime needs to be updated
+				too. */
+				if( xTimeToWake < xNextTaskUnblockTime )
+				{
+					xNextTaskUnblockTime = xTimeToWake;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
 			}
 		}
+		#endif /* configUSE_DELAYED_TASK_WHEEL */
 
 		/* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
 		( void ) xCanBlockIndefinitely;
@@ -69,6 +69,23 @@ defining trmTIMER_SERVICE_TASK_NAME in FreeRTOSConfig.h. */
 #define tmrSTATUS_IS_STATICALLY_ALLOCATED	( ( uint8_t ) 0x02 )
 #define tmrSTATUS_IS_AUTORELOAD				( ( uint8_t ) 0x04 )
 
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	#if( ( configTIMER_WHEEL_SLOT_BITS < 1 ) || ( configTIMER_WHEEL_SLOT_BITS > 5 ) )
+		#error configTIMER_WHEEL_SLOT_BITS must be between 1 and 5.
+	#endif
+
+	/* The timer wheel splits a tick count into digits of
+	configTIMER_WHEEL_SLOT_BITS bits, one digit per level of the wheel, with
+	enough levels to cover every bit of TickType_t. */
+	#define tmrWHEEL_SLOTS						( ( UBaseType_t ) 1U << configTIMER_WHEEL_SLOT_BITS )
+	#define tmrWHEEL_SLOT_MASK					( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+	#define tmrWHEEL_LEVELS						( ( UBaseType_t ) ( ( ( sizeof( TickType_t ) * 8U ) + ( configTIMER_WHEEL_SLOT_BITS - 1U ) ) / configTIMER_WHEEL_SLOT_BITS ) )
+	#define tmrWHEEL_SHIFT( uxLevel )			( ( uxLevel ) * ( UBaseType_t ) configTIMER_WHEEL_SLOT_BITS )
+	#define tmrWHEEL_DIGIT( xTime, uxLevel )	( ( UBaseType_t ) ( ( xTime ) >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK )
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /* The definition of the timers themselves. */
 typedef struct tmrTimerControl /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 {
@@ -132,10 +149,31 @@ timer service task is allowed to access these lists.
 xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
 breaks some kernel aware debuggers, and debuggers that reply on removing the
 static qualifier. */
-PRIVILEGED_DATA static List_t xActiveTimerList1;
-PRIVILEGED_DATA static List_t xActiveTimerList2;
-PRIVILEGED_DATA static List_t *pxCurrentTimerList;
-PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/* When configUSE_TIMER_WHEEL is 1 active timers are instead stored in a
+	hierarchical timing wheel.  A timer is placed in the level of the most
+	significant digit in which its expiry time differs from xWheelTime, in the
+	slot for that digit of its expiry time.  Slots are not sorted, so starting,
+	stopping and resetting a timer are O(1) regardless of how many timers are
+	active.  When xWheelTime reaches a level 0 slot the timers in it have
+	expired.  When it reaches a slot in a higher level the timers in it are
+	moved down to lower levels, which happens at most once per level for each
+	timer.  All times are compared relative to xWheelTime, so tick count
+	overflows need no special handling.  Bit n of ulWheelOccupied[ x ] is set
+	if slot n of level x contains any timers. */
+	PRIVILEGED_DATA static List_t xTimerWheel[ tmrWHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+	PRIVILEGED_DATA static uint32_t ulWheelOccupied[ tmrWHEEL_LEVELS ];
+	PRIVILEGED_DATA static TickType_t xWheelTime = ( TickType_t ) 0U;
+
+#else
+
+	PRIVILEGED_DATA static List_t xActiveTimerList1;
+	PRIVILEGED_DATA static List_t xActiveTimerList2;
+	PRIVILEGED_DATA static List_t *pxCurrentTimerList;
+	PRIVILEGED_DATA static List_t *pxOverflowTimerList;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
 PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -180,17 +218,49 @@ static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
  */
 static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer, const TickType_t xNextExpiryTime, const TickType_t xTimeNow, const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
 
+/*
+ * Remove the timer from the active timer list or timer wheel, if it is in
+ * one.
+ */
+static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	/*
+	 * Place the timer in the timer wheel slot for its expiry time, relative to
+	 * the current wheel time.
+	 */
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer, const TickType_t xNextExpiryTime ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Move every timer in a slot of the timer wheel down to the level for its
+	 * expiry time, once the wheel time has reached that slot.
+	 */
+	static void prvCascadeWheelSlot( const UBaseType_t uxLevel, const UBaseType_t uxSlot ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Returns the lowest level of the timer wheel that contains any timers, or
+	 * tmrWHEEL_LEVELS if the wheel is empty.
+	 */
+	static UBaseType_t prvGetLowestOccupiedLevel( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
+
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
  * auto-reload timer, then call its callback.
  */
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
-/*
- * The tick count has overflowed.  Switch the timer lists after ensuring the
- * current timer list does not still reference some timers.
- */
-static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+#if( configUSE_TIMER_WHEEL == 0 )
+
+	/*
+	 * The tick count has overflowed.  Switch the timer lists after ensuring the
+	 * current timer list does not still reference some timers.
+	 */
+	static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -507,11 +577,40 @@ Timer_t *pxTimer = xTimer;
 static void prvProcessExpiredTimer( const TickType_t xNextExpireTime, const TickType_t xTimeNow )
 {
 BaseType_t xResult;
+#if( configUSE_TIMER_WHEEL == 1 )
+	Timer_t *pxTimer;
+	UBaseType_t uxLevel, uxSlot;
+
+	/* xNextExpireTime is the time of the first event in the wheel, which has
+	been reached. */
+	xWheelTime = xNextExpireTime;
+	uxLevel = prvGetLowestOccupiedLevel();
+	configASSERT( uxLevel < tmrWHEEL_LEVELS );
+	uxSlot = tmrWHEEL_DIGIT( xNextExpireTime, uxLevel );
+
+	if( uxLevel != ( UBaseType_t ) 0 )
+	{
+		/* No timer has expired yet, but the timers in this slot are now near
+		enough to their expiry times to be moved to lower levels. */
+		prvCascadeWheelSlot( uxLevel, uxSlot );
+		return;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Remove the timer from the wheel.  A check has already been performed
+	to ensure the slot is not empty. */
+	pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( xTimerWheel[ 0 ][ uxSlot ] ) ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+	prvRemoveTimerFromActiveList( pxTimer );
+#else
 Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
 	/* Remove the timer from the list of active timers.  A check has already
 	been performed to ensure the list is not empty. */
 	( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+#endif /* configUSE_TIMER_WHEEL */
 	traceTIMER_EXPIRED( pxTimer );
 
 	/* If the timer is an auto-reload timer then calculate the next
@@ -584,47 +683,34 @@ BaseType_t xListWasEmpty;
 static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime, BaseType_t xListWasEmpty )
 {
 TickType_t xTimeNow;
-BaseType_t xTimerListsWereSwitched;
 
-	vTaskSuspendAll();
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
-		/* Obtain the time now to make an assessment as to whether the timer
-		has expired or not.  If obtaining the time causes the lists to switch
-		then don't process this timer as any timers that remained in the list
-		when the lists were switched will have been processed within the
-		prvSampleTimeNow() function. */
-		xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
-		if( xTimerListsWereSwitched == pdFALSE )
+		vTaskSuspendAll();
 		{
-			/* The tick count has not overflowed, has the timer expired? */
-			if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+			xTimeNow = xTaskGetTickCount();
+
+			/* Has the next event in the wheel been reached?  Both times are
+			taken relative to the wheel time, so this holds across a tick
+			count overflow. */
+			if( ( xListWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextExpireTime - xWheelTime ) <= ( TickType_t ) ( xTimeNow - xWheelTime ) ) )
 			{
 				( void ) xTaskResumeAll();
 				prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
 			}
 			else
 			{
-				/* The tick count has not overflowed, and the next expire
-				time has not been reached yet.  This task should therefore
-				block to wait for the next expire time or a command to be
-				received - whichever comes first.  The following line cannot
-				be reached unless xNextExpireTime > xTimeNow, except in the
-				case when the current timer list is empty. */
-				if( xListWasEmpty != pdFALSE )
-				{
-					/* The current timer list is empty - is the overflow list
-					also empty? */
-					xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
-				}
+				/* Nothing is due before xNextExpireTime, so the wheel can
+				move straight to the current time without any timer having
+				to change slot. */
+				xWheelTime = xTimeNow;
 
 				vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
 				if( xTaskResumeAll() == pdFALSE )
 				{
 					/* Yield to wait for either a command to arrive, or the
-					block time to expire.  If a command arrived between the
-					critical section being exited and this yield then the yield
-					will not cause the task to block. */
+					block time to expire. */
 					portYIELD_WITHIN_API();
 				}
 				else
@@ -633,11 +719,65 @@ BaseType_t xTimerListsWereSwitched;
 				}
 			}
 		}
-		else
+	}
+	#else
+	{
+	BaseType_t xTimerListsWereSwitched;
+
+		vTaskSuspendAll();
 		{
-			( void ) xTaskResumeAll();
+			/* Obtain the time now to make an assessment as to whether the timer
+			has expired or not.  If obtaining the time causes the lists to switch
+			then don't process this timer as any timers that remained in the list
+			when the lists were switched will have been processed within the
+			prvSampleTimeNow() function. */
+			xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+			if( xTimerListsWereSwitched == pdFALSE )
+			{
+				/* The tick count has not overflowed, has the timer expired? */
+				if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+				{
+					( void ) xTaskResumeAll();
+					prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+				}
+				else
+				{
+					/* The tick count has not overflowed, and the next expire
+					time has not been reached yet.  This task should therefore
+					block to wait for the next expire time or a command to be
+					received - whichever comes first.  The following line cannot
+					be reached unless xNextExpireTime > xTimeNow, except in the
+					case when the current timer list is empty. */
+					if( xListWasEmpty != pdFALSE )
+					{
+						/* The current timer list is empty - is the overflow list
+						also empty? */
+						xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+					}
+
+					vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+					if( xTaskResumeAll() == pdFALSE )
+					{
+						/* Yield to wait for either a command to arrive, or the
+						block time to expire.  If a command arrived between the
+						critical section being exited and this yield then the yield
+						will not cause the task to block. */
+						portYIELD_WITHIN_API();
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+				}
+			}
+			else
+			{
+				( void ) xTaskResumeAll();
+			}
 		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
@@ -652,16 +792,56 @@ TickType_t xNextExpireTime;
 	this task to unblock when the tick count overflows, at which point the
 	timer lists will be switched and the next expiry time can be
 	re-assessed.  */
-	*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-	if( *pxListWasEmpty == pdFALSE )
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
-		xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+	UBaseType_t uxLevel, uxDigit, uxOffset;
+
+		/* When using the timer wheel the next event is in the lowest level
+		that contains any timers.  In level 0 it is the expiry of the timers
+		in the next occupied slot.  In a higher level it is the time the timers
+		in the next occupied slot are moved down a level, which is no later
+		than any of them expire. */
+		uxLevel = prvGetLowestOccupiedLevel();
+
+		if( uxLevel < tmrWHEEL_LEVELS )
+		{
+			*pxListWasEmpty = pdFALSE;
+
+			/* Search forward from the wheel time's own slot.  Only level 0 can
+			hold timers in that slot, ones that expire at the wheel time
+			itself. */
+			uxDigit = tmrWHEEL_DIGIT( xWheelTime, uxLevel );
+			uxOffset = 0;
+			while( ( ulWheelOccupied[ uxLevel ] & ( 1UL << ( ( uxDigit + uxOffset ) & tmrWHEEL_SLOT_MASK ) ) ) == 0UL )
+			{
+				uxOffset++;
+			}
+
+			xNextExpireTime = xWheelTime & ~( ( ( TickType_t ) 1U << tmrWHEEL_SHIFT( uxLevel ) ) - ( TickType_t ) 1U );
+			xNextExpireTime += ( TickType_t ) ( ( TickType_t ) uxOffset << tmrWHEEL_SHIFT( uxLevel ) );
+		}
+		else
+		{
+			/* The wheel does not need the task to unblock when the tick count
+			rolls over, it will wait indefinitely for a command. */
+			*pxListWasEmpty = pdTRUE;
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
 	}
-	else
+	#else
 	{
-		/* Ensure the task unblocks when the tick count rolls over. */
-		xNextExpireTime = ( TickType_t ) 0U;
+		*pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+		if( *pxListWasEmpty == pdFALSE )
+		{
+			xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+		}
+		else
+		{
+			/* Ensure the task unblocks when the tick count rolls over. */
+			xNextExpireTime = ( TickType_t ) 0U;
+		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xNextExpireTime;
 }
@@ -670,21 +850,33 @@ TickType_t xNextExpireTime;
 static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
 {
 TickType_t xTimeNow;
-PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
-
-	xTimeNow = xTaskGetTickCount();
 
-	if( xTimeNow < xLastTime )
-	{
-		prvSwitchTimerLists();
-		*pxTimerListsWereSwitched = pdTRUE;
-	}
-	else
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
+		/* Times in the timer wheel are relative to the wheel time, so there
+		are no lists to switch when the tick count overflows. */
+		xTimeNow = xTaskGetTickCount();
 		*pxTimerListsWereSwitched = pdFALSE;
 	}
+	#else
+	{
+	PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
-	xLastTime = xTimeNow;
+		xTimeNow = xTaskGetTickCount();
+
+		if( xTimeNow < xLastTime )
+		{
+			prvSwitchTimerLists();
+			*pxTimerListsWereSwitched = pdTRUE;
+		}
+		else
+		{
+			*pxTimerListsWereSwitched = pdFALSE;
+		}
+
+		xLastTime = xTimeNow;
+	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xTimeNow;
 }
@@ -697,40 +889,165 @@ BaseType_t xProcessTimerNow = pdFALSE;
 	listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
 	listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
 
-	if( xNextExpiryTime <= xTimeNow )
+	#if( configUSE_TIMER_WHEEL == 1 )
 	{
 		/* Has the expiry time elapsed between the command to start/reset a
-		timer was issued, and the time the command was processed? */
-		if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+		timer was issued, and the time the command was processed?  Both times
+		are measured from the command time, which also covers the tick count
+		overflowing in between. */
+		if( ( ( TickType_t ) ( xNextExpiryTime - xCommandTime ) ) <= ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 		{
-			/* The time between a command being issued and the command being
-			processed actually exceeds the timers period.  */
 			xProcessTimerNow = pdTRUE;
 		}
 		else
 		{
-			vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			/* An empty wheel can move straight to the current time. */
+			if( prvGetLowestOccupiedLevel() == tmrWHEEL_LEVELS )
+			{
+				xWheelTime = xTimeNow;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			prvInsertTimerInWheel( pxTimer, xNextExpiryTime );
 		}
 	}
-	else
+	#else
 	{
-		if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+		if( xNextExpiryTime <= xTimeNow )
 		{
-			/* If, since the command was issued, the tick count has overflowed
-			but the expiry time has not, then the timer must have already passed
-			its expiry time and should be processed immediately. */
-			xProcessTimerNow = pdTRUE;
+			/* Has the expiry time elapsed between the command to start/reset a
+			timer was issued, and the time the command was processed? */
+			if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+			{
+				/* The time between a command being issued and the command being
+				processed actually exceeds the timers period.  */
+				xProcessTimerNow = pdTRUE;
+			}
+			else
+			{
+				vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+			}
 		}
 		else
 		{
-			vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+			{
+				/* If, since the command was issued, the tick count has overflowed
+				but the expiry time has not, then the timer must have already passed
+				its expiry time and should be processed immediately. */
+				xProcessTimerNow = pdTRUE;
+			}
+			else
+			{
+				vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+			}
 		}
 	}
+	#endif /* configUSE_TIMER_WHEEL */
 
 	return xProcessTimerNow;
 }
 /*-----------------------------------------------------------*/
 
+static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer )
+{
+	#if( configUSE_TIMER_WHEEL == 1 )
+	{
+	List_t * const pxSlot = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+	UBaseType_t uxIndex;
+
+		if( pxSlot != NULL )
+		{
+			if( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0 )
+			{
+				/* The slot is now empty. */
+				uxIndex = ( UBaseType_t ) ( pxSlot - &( xTimerWheel[ 0 ][ 0 ] ) );
+				ulWheelOccupied[ uxIndex / tmrWHEEL_SLOTS ] &= ~( 1UL << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#else
+	{
+		if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+		{
+			/* The timer is in a list, remove it. */
+			( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif /* configUSE_TIMER_WHEEL */
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TIMER_WHEEL == 1 )
+
+	static void prvInsertTimerInWheel( Timer_t * const pxTimer, const TickType_t xNextExpiryTime )
+	{
+	TickType_t xDifference;
+	UBaseType_t uxLevel = 0, uxSlot;
+
+		/* Find the most significant digit in which the expiry time differs
+		from the wheel time.  This is a fixed number of steps, not dependent on
+		the number of active timers. */
+		xDifference = xNextExpiryTime ^ xWheelTime;
+		while( ( uxLevel < ( tmrWHEEL_LEVELS - ( UBaseType_t ) 1U ) ) && ( ( xDifference >> tmrWHEEL_SHIFT( uxLevel + ( UBaseType_t ) 1U ) ) != ( TickType_t ) 0U ) )
+		{
+			uxLevel++;
+		}
+
+		uxSlot = tmrWHEEL_DIGIT( xNextExpiryTime, uxLevel );
+		vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+		ulWheelOccupied[ uxLevel ] |= ( 1UL << uxSlot );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCascadeWheelSlot( const UBaseType_t uxLevel, const UBaseType_t uxSlot )
+	{
+	List_t * const pxSlot = &( xTimerWheel[ uxLevel ][ uxSlot ] );
+	Timer_t *pxTimer;
+
+		/* The wheel time now matches the timers' expiry times in this digit
+		and every digit above it, so each timer goes into a lower level. */
+		while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+		{
+			pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+			( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+			prvInsertTimerInWheel( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+		}
+
+		ulWheelOccupied[ uxLevel ] &= ~( 1UL << uxSlot );
+	}
+	/*-----------------------------------------------------------*/
+
+	static UBaseType_t prvGetLowestOccupiedLevel( void )
+	{
+	UBaseType_t uxLevel = 0;
+
+		while( ( uxLevel < tmrWHEEL_LEVELS ) && ( ulWheelOccupied[ uxLevel ] == 0UL ) )
+		{
+			uxLevel++;
+		}
+
+		return uxLevel;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMER_WHEEL */
+
 static void	prvProcessReceivedCommands( void )
 {
 DaemonTaskMessage_t xMessage;
@@ -770,15 +1087,8 @@ TickType_t xTimeNow;
 			software timer. */
 			pxTimer = xMessage.u.xTimerParameters.pxTimer;
 
-			if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
-			{
-				/* The timer is in a list, remove it. */
-				( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
-			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
+			/* If the timer is active, remove it. */
+			prvRemoveTimerFromActiveList( pxTimer );
 
 			traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
 
@@ -879,6 +1189,8 @@ TickType_t xTimeNow;
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_TIMER_WHEEL == 0 )
+
 static void prvSwitchTimerLists( void )
 {
 TickType_t xNextExpireTime, xReloadTime;
@@ -938,6 +1250,9 @@ BaseType_t xResult;
 }
 /*-----------------------------------------------------------*/
 
+#endif /* configUSE_TIMER_WHEEL */
+/*-----------------------------------------------------------*/
+
 static void prvCheckForValidListAndQueue( void )
 {
 	/* Check that the list from which active timers are referenced, and the
@@ -947,10 +1262,26 @@ static void prvCheckForValidListAndQueue( void )
 	{
 		if( xTimerQueue == NULL )
 		{
-			vListInitialise( &xActiveTimerList1 );
-			vListInitialise( &xActiveTimerList2 );
-			pxCurrentTimerList = &xActiveTimerList1;
-			pxOverflowTimerList = &xActiveTimerList2;
+			#if( configUSE_TIMER_WHEEL == 1 )
+			{
+			UBaseType_t uxLevel, uxSlot;
+
+				for( uxLevel = 0; uxLevel < tmrWHEEL_LEVELS; uxLevel++ )
+				{
+					for( uxSlot = 0; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+					{
+						vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+					}
+				}
+			}
+			#else
+			{
+				vListInitialise( &xActiveTimerList1 );
+				vListInitialise( &xActiveTimerList2 );
+				pxCurrentTimerList = &xActiveTimerList1;
+				pxOverflowTimerList = &xActiveTimerList2;
+			}
+			#endif /* configUSE_TIMER_WHEEL */
 
 			#if( configSUPPORT_STATIC_ALLOCATION == 1 )
 			{
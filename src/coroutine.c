@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  coroutine.c
+//
+//  Stackless Coroutines
+//
+//  Module description in coroutine.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Library Includes
+
+// Project Includes
+
+// Module Includes
+#include "coroutine.h"
+
+/* ***************************   Definitions   **************************** */
+
+// Deep enough for the deepest of the flows, they take turns on it
+#define CORO_TASK_STACK_SIZE            configMINIMAL_STACK_SIZE
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void coroTask(void *pvParameters);
+static bool coroIsRunnable(const coroutine_t *p_co, const TickType_t now);
+static TickType_t coroTicksLeft(const coroutine_t *p_co, const TickType_t now);
+static void coroRemoveIfDone(coroutine_t *p_co);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static TaskHandle_t coro_task = NULL;
+static StaticTask_t coro_task_buffer;
+static StackType_t coro_task_stack[CORO_TASK_STACK_SIZE];
+
+// Coroutines that have been started and have not finished, only the coroutine task removes them
+static coroutine_t *p_coroutines = NULL;
+
+/* *************************   Public  Functions   ************************ */
+
+void coroInit(const int task_priority)
+{
+    coro_task = xTaskCreateStatic(coroTask, "Coroutine", CORO_TASK_STACK_SIZE, NULL, task_priority,
+                                  coro_task_stack, &coro_task_buffer);
+    assert(coro_task != NULL);
+}
+
+// Runs fn on the coroutine task from the top, with no events pending. A coroutine that has
+// finished can be started again, returns false if it is still running.
+bool coroStart(coroutine_t *p_co, coroFn_t fn, void *p_context)
+{
+    bool linked = false;
+
+    taskENTER_CRITICAL();
+    for(const coroutine_t *p_entry = p_coroutines; p_entry != NULL; p_entry = p_entry->p_next)
+    {
+        linked |= (p_entry == p_co);
+    }
+
+    bool started = !linked || (p_co->resume == CORO_RESUME_DONE);
+    if(started)
+    {
+        p_co->fn = fn;
+        p_co->p_context = p_context;
+        p_co->events = 0;
+        p_co->wait_ticks = portMAX_DELAY;
+        p_co->resume = CORO_RESUME_START;
+        p_co->run = true;
+        p_co->timed_out = false;
+
+        // A finished coroutine the task has not got round to removing yet stays where it is
+        if(!linked)
+        {
+            p_co->p_next = p_coroutines;
+            p_coroutines = p_co;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if(started)
+    {
+        xTaskNotifyGive(coro_task);
+    }
+
+    return started;
+}
+
+bool coroIsRunning(const coroutine_t *p_co)
+{
+    bool running = false;
+
+    taskENTER_CRITICAL();
+    for(const coroutine_t *p_entry = p_coroutines; p_entry != NULL; p_entry = p_entry->p_next)
+    {
+        running |= (p_entry == p_co) && (p_co->resume != CORO_RESUME_DONE);
+    }
+    taskEXIT_CRITICAL();
+
+    return running;
+}
+
+// Sets events for a coroutine and has it check what it is waiting for
+void coroSignal(coroutine_t *p_co, const uint32_t events)
+{
+    taskENTER_CRITICAL();
+    p_co->events |= events;
+    p_co->run = true;
+    taskEXIT_CRITICAL();
+
+    xTaskNotifyGive(coro_task);
+}
+
+void coroSignalFromISR(coroutine_t *p_co, const uint32_t events, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    UBaseType_t saved_mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    p_co->events |= events;
+    p_co->run = true;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved_mask);
+
+    vTaskNotifyGiveFromISR(coro_task, pxHigherPriorityTaskWoken);
+}
+
+void coroPrepareWait(coroutine_t *p_co, const TickType_t timeout)
+{
+    p_co->wait_start = xTaskGetTickCount();
+    p_co->wait_ticks = timeout;
+    p_co->timed_out = false;
+}
+
+bool coroWaitExpired(coroutine_t *p_co)
+{
+    return (coroTicksLeft(p_co, xTaskGetTickCount()) == 0);
+}
+
+// Clears and returns whichever of the events have been signalled
+uint32_t coroTakeEvents(coroutine_t *p_co, const uint32_t events)
+{
+    taskENTER_CRITICAL();
+    uint32_t taken = p_co->events & events;
+    p_co->events &= ~taken;
+    taskEXIT_CRITICAL();
+
+    return taken;
+}
+
+/* *************************   Private Functions   ************************ */
+
+// Runs every coroutine that was signalled or whose wait has timed out, then sleeps until the next
+// signal or timeout. A signal that comes in while the coroutines are being run leaves the task's
+// notification pending, so it goes round again rather than sleeping.
+static void coroTask(void *pvParameters)
+{
+    (void)pvParameters;
+
+    for(;;)
+    {
+        TickType_t sleep_ticks = portMAX_DELAY;
+
+        coroutine_t *p_co = p_coroutines;
+        while(p_co != NULL)
+        {
+            coroutine_t *p_next = p_co->p_next;
+            TickType_t now = xTaskGetTickCount();
+
+            if(coroIsRunnable(p_co, now))
+            {
+                p_co->run = false;
+                p_co->fn(p_co);
+                coroRemoveIfDone(p_co);
+            }
+
+            if(p_co->run)
+            {
+                sleep_ticks = 0;
+            }
+            else if(p_co->resume != CORO_RESUME_DONE)
+            {
+                TickType_t ticks_left = coroTicksLeft(p_co, xTaskGetTickCount());
+                sleep_ticks = (ticks_left < sleep_ticks) ? ticks_left : sleep_ticks;
+            }
+
+            p_co = p_next;
+        }
+
+        ulTaskNotifyTake(pdTRUE, sleep_ticks);
+    }
+}
+
+static bool coroIsRunnable(const coroutine_t *p_co, const TickType_t now)
+{
+    return (p_co->resume != CORO_RESUME_DONE) && (p_co->run || (coroTicksLeft(p_co, now) == 0));
+}
+
+// Ticks until the coroutine's wait times out, portMAX_DELAY for a wait with no timeout
+static TickType_t coroTicksLeft(const coroutine_t *p_co, const TickType_t now)
+{
+    if(p_co->wait_ticks == portMAX_DELAY)
+    {
+        return portMAX_DELAY;
+    }
+
+    TickType_t elapsed = now - p_co->wait_start;
+    return (elapsed >= p_co->wait_ticks) ? 0 : (p_co->wait_ticks - elapsed);
+}
+
+static void coroRemoveIfDone(coroutine_t *p_co)
+{
+    taskENTER_CRITICAL();
+    if(p_co->resume == CORO_RESUME_DONE)
+    {
+        coroutine_t **pp_entry = &p_coroutines;
+        while(*pp_entry != p_co)
+        {
+            pp_entry = &(*pp_entry)->p_next;
+        }
+        *pp_entry = p_co->p_next;
+    }
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  crc.c
+//
+//  CRC Engine
+//
+//  Module description in crc.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+
+// FreeRTOS Includes
+
+// Library Includes
+
+// Project Includes
+
+// Module Includes
+#include "crc.h"
+
+/* ***************************   Definitions   **************************** */
+
+#if (CRC_SLICE_BY != 4) && (CRC_SLICE_BY != 8)
+    #error CRC_SLICE_BY must be 4 or 8
+#endif
+
+// Lookup tables in flash, crc16_table and crc32_table, generated by tools/crc_tables.py from
+// the polynomials below
+#include "crc_tables.h"
+
+// CRC-16/CCITT-FALSE, MSB first
+#define CRC16_POLY                      0x1021      // Only used to generate the tables
+#define CRC16_INIT                      0xFFFF
+
+// CRC-32 (IEEE 802.3), LSB first
+#define CRC32_POLY_REFLECTED            0xEDB88320  // Only used to generate the tables
+#define CRC32_INIT                      0xFFFFFFFF
+#define CRC32_XOR_OUT                   0xFFFFFFFF
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+/* ***********************   File Scope Variables   *********************** */
+
+/* *************************   Public  Functions   ************************ */
+
+uint16_t crc16Start(void)
+{
+    return CRC16_INIT;
+}
+
+// Adds a buffer to a running CRC-16
+uint16_t crc16Update(uint16_t crc, const uint8_t *p_bytes, unsigned int num_bytes)
+{
+    while(num_bytes >= CRC_SLICE_BY)
+    {
+        // The 16-bit CRC only overlaps the first two bytes of the slice
+        uint16_t next = crc16_table[CRC_SLICE_BY - 1][p_bytes[0] ^ (crc >> 8)] ^
+                        crc16_table[CRC_SLICE_BY - 2][p_bytes[1] ^ (crc & 0xFF)];
+        for(int idx = 2; idx < CRC_SLICE_BY; idx++)
+        {
+            next ^= crc16_table[CRC_SLICE_BY - 1 - idx][p_bytes[idx]];
+        }
+
+        crc = next;
+        p_bytes += CRC_SLICE_BY;
+        num_bytes -= CRC_SLICE_BY;
+    }
+
+    while(num_bytes-- > 0)
+    {
+        crc = crc16UpdateByte(crc, *p_bytes++);
+    }
+
+    return crc;
+}
+
+// Adds a single byte to a running CRC-16, cheap enough to call per byte from a receive interrupt
+uint16_t crc16UpdateByte(const uint16_t crc, const uint8_t byte)
+{
+    return (uint16_t)(crc << 8) ^ crc16_table[0][(crc >> 8) ^ byte];
+}
+
+uint16_t crc16Finish(const uint16_t crc)
+{
+    return crc;
+}
+
+uint16_t crc16Calc(const uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    return crc16Finish(crc16Update(crc16Start(), p_bytes, num_bytes));
+}
+
+uint32_t crc32Start(void)
+{
+    return CRC32_INIT;
+}
+
+// Adds a buffer to a running CRC-32
+uint32_t crc32Update(uint32_t crc, const uint8_t *p_bytes, unsigned int num_bytes)
+{
+    while(num_bytes >= CRC_SLICE_BY)
+    {
+        // Bytes are combined individually so the buffer needs no particular alignment
+        crc ^= (uint32_t)p_bytes[0] | ((uint32_t)p_bytes[1] << 8) |
+               ((uint32_t)p_bytes[2] << 16) | ((uint32_t)p_bytes[3] << 24);
+
+        uint32_t next = crc32_table[CRC_SLICE_BY - 1][crc & 0xFF] ^
+                        crc32_table[CRC_SLICE_BY - 2][(crc >> 8) & 0xFF] ^
+                        crc32_table[CRC_SLICE_BY - 3][(crc >> 16) & 0xFF] ^
+                        crc32_table[CRC_SLICE_BY - 4][crc >> 24];
+        for(int idx = 4; idx < CRC_SLICE_BY; idx++)
+        {
+            next ^= crc32_table[CRC_SLICE_BY - 1 - idx][p_bytes[idx]];
+        }
+
+        crc = next;
+        p_bytes += CRC_SLICE_BY;
+        num_bytes -= CRC_SLICE_BY;
+    }
+
+    while(num_bytes-- > 0)
+    {
+        crc = crc32UpdateByte(crc, *p_bytes++);
+    }
+
+    return crc;
+}
+
+// Adds a single byte to a running CRC-32
+uint32_t crc32UpdateByte(const uint32_t crc, const uint8_t byte)
+{
+    return (crc >> 8) ^ crc32_table[0][(crc ^ byte) & 0xFF];
+}
+
+uint32_t crc32Finish(const uint32_t crc)
+{
+    return crc ^ CRC32_XOR_OUT;
+}
+
+uint32_t crc32Calc(const uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    return crc32Finish(crc32Update(crc32Start(), p_bytes, num_bytes));
+}
+
+/* *************************   Private Functions   ************************ */
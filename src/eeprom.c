@@ -36,72 +36,334 @@
 // Standard Includes
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 // FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
 
 // Library Includes
 
 // Project Includes
+#include "spi_bus.h"
+#include "run_time_stats.h"
 
 // Module Includes
+#include "eeprom.h"
 
 /* ***************************   Definitions   **************************** */
 
+// SPI instruction set of the EEPROM
+#define EEPROM_CMD_READ                 0x03
+#define EEPROM_CMD_WRITE                0x02
+#define EEPROM_CMD_WRITE_ENABLE         0x06
+#define EEPROM_CMD_READ_STATUS          0x05
+
+// Status register bit set while an internal write cycle is in progress
+#define EEPROM_STATUS_WIP               0x01
+
+// A write cycle still in progress after this long has failed, the part's maximum is 5 ms
+#define EEPROM_WRITE_TIMEOUT_MS         10
+
+// Chip select line the EEPROM is wired to
+#define EEPROM_CHIP_SELECT              0
+
+// Size of the chunks read back when comparing, keeps the compare off the caller's stack
+#define EEPROM_COMPARE_CHUNK_SIZE       16
+
 /* ****************************   Structures   **************************** */
 
 /* ***********************   Function Prototypes   ************************ */
 
+static void eepromSendCommand(const uint8_t cmd, const uint32_t addr);
+static bool eepromPageMatches(const uint32_t addr, const uint8_t *bytes, const unsigned int num_bytes);
+static void eepromProgramPage(const uint32_t addr, const uint8_t *bytes, const unsigned int num_bytes);
+static eepromWriteResult_t eepromPollWriteCycle(const eepromWriteJob_t *p_job);
+static eepromWriteResult_t eepromWriteFinish(eepromWriteJob_t *p_job, const eepromWriteResult_t result);
+static void eepromLock(void);
+static bool eepromTryLock(void);
+static void eepromUnlock(void);
+
 /* ***********************   File Scope Variables   *********************** */
 
+static eepromWriteMode_t write_mode = E_EEPROM_WRITE_ALWAYS;
+
+static int spi_client = SPI_BUS_CLIENT_INVALID;
+
+// Held from the start of a write until its last write cycle has finished, and for every read, so
+// no one talks to the part during a write cycle. The SPI bus itself is free for other clients
+// while the cycle runs.
+static SemaphoreHandle_t eeprom_mutex = NULL;
+static StaticSemaphore_t eeprom_mutex_buffer;
+
 /* *************************   Public  Functions   ************************ */
 
 
+// Registers the EEPROM on the shared SPI bus, spiBusInit() must have been called
 void eepromInit(void)
 {
-    // Initialize the SPI interface for using the EEPROM
-    SPI_Init();
+    spi_client = spiBusRegisterClient("EEPROM", EEPROM_CHIP_SELECT);
+    assert(spi_client != SPI_BUS_CLIENT_INVALID);
+
+    eeprom_mutex = xSemaphoreCreateMutexStatic(&eeprom_mutex_buffer);
+    assert(eeprom_mutex != NULL);
+    vQueueAddToRegistry(eeprom_mutex, "EEPROM");
+}
+
+// Selects whether eepromWriteBytes() reads pages back before programming them
+void eepromSetWriteMode(const eepromWriteMode_t mode)
+{
+    write_mode = mode;
 }
 
 // Reads bytes from EEPROM
 bool eepromReadBytes(const uint32_t addr, uint8_t *bytes, const unsigned int num_bytes)
 {
-    // Send SPI commands to setup EEPROM for reading data at specified address
+    if((addr + num_bytes) > EEPROM_SIZE_BYTES)
+    {
+        return false;
+    }
 
-    // Read data out and write to data buffer
-    bool result = true;
-    for(int idx = 0; idx < num_bytes; idx++)
+    // A single READ instruction streams out sequential bytes for as long as the clock runs, so
+    // the whole range is read in one burst
+    eepromLock();
+    if(!spiBusAcquire(spi_client, portMAX_DELAY))
     {
-        // Get byte from EEPROM'
+        eepromUnlock();
+        return false;
+    }
+
+    spiBusSelect(spi_client, true);
+    eepromSendCommand(EEPROM_CMD_READ, addr);
+    spiBusRead(spi_client, bytes, num_bytes);
+    spiBusSelect(spi_client, false);
+
+    spiBusRelease(spi_client);
+    eepromUnlock();
+    return true;
+}
+
+// Writes bytes to the EEPROM, blocking until the last write cycle has finished
+bool eepromWriteBytes(const uint32_t addr, uint8_t *bytes, const unsigned int num_bytes)
+{
+    eepromWriteJob_t job;
+    eepromWriteStart(&job, addr, bytes, num_bytes);
+
+    // Block on the lock rather than trying it each tick, so its holder inherits our priority
+    eepromLock();
+    job.locked = true;
 
-        // Write byte
-        uint8_t incoming_byte = eepromGetByte();
-        *(bytes + idx) = incoming_byte;
+    eepromWriteResult_t result;
+    while((result = eepromWriteStep(&job)) == E_EEPROM_WRITE_BUSY)
+    {
+        if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+        {
+            vTaskDelay(1);
+        }
     }
 
     // If no errors, return is true
-    return result;
+    return (result == E_EEPROM_WRITE_DONE);
 }
 
-// Writes bytes to the EEPROM
-bool eepromWriteBytes(const uint32_t addr, uint8_t *bytes, const unsigned int num_bytes)
+void eepromWriteStart(eepromWriteJob_t *p_job, const uint32_t addr, const uint8_t *bytes,
+                      const unsigned int num_bytes)
+{
+    memset(p_job, 0, sizeof(*p_job));
+    p_job->addr = addr;
+    p_job->bytes = bytes;
+    p_job->num_bytes = num_bytes;
+}
+
+// Takes a write as far as it can go without waiting on the part: takes the EEPROM lock if it is
+// free, checks once on the running write cycle and starts the next page's cycle once it has
+// finished. Pages that don't need programming are passed over in the same step. Returns
+// E_EEPROM_WRITE_BUSY until the write is done, the caller steps it again a tick or so later.
+eepromWriteResult_t eepromWriteStep(eepromWriteJob_t *p_job)
 {
-    // Send SPI commands to setup EEPROM for reading data at specified address
+    if((p_job->addr + p_job->num_bytes) > EEPROM_SIZE_BYTES)
+    {
+        return eepromWriteFinish(p_job, E_EEPROM_WRITE_FAILED);
+    }
 
-    // Read data out and write to data buffer
-    bool result = true;
-    for(int idx = 0; idx < num_bytes; idx++)
+    if(!p_job->locked)
     {
-        // Get byte from EEPROM'
+        if(!eepromTryLock())
+        {
+            return E_EEPROM_WRITE_BUSY;
+        }
 
-        // Write byte
-        uint8_t incoming_byte = eepromGetByte();
-        *(bytes + idx) = incoming_byte;
+        p_job->locked = true;
     }
 
-    // If no errors, return is true
+    if(p_job->in_cycle)
+    {
+        // The part ignores further writes while a cycle is stuck, so the rest aren't attempted
+        eepromWriteResult_t cycle_result = eepromPollWriteCycle(p_job);
+        if(cycle_result != E_EEPROM_WRITE_DONE)
+        {
+            return (cycle_result == E_EEPROM_WRITE_BUSY) ? cycle_result : eepromWriteFinish(p_job, cycle_result);
+        }
 
-    return result;
+        p_job->in_cycle = false;
+    }
+
+    // Split the range on page boundaries, a single write cycle can't cross one
+    while(p_job->offset < p_job->num_bytes)
+    {
+        uint32_t page_addr = p_job->addr + p_job->offset;
+        unsigned int page_remaining = EEPROM_PAGE_SIZE - (page_addr % EEPROM_PAGE_SIZE);
+        unsigned int chunk_len = p_job->num_bytes - p_job->offset;
+        if(chunk_len > page_remaining)
+        {
+            chunk_len = page_remaining;
+        }
+
+        // Compare and program of a page run as one batch on the bus
+        if(!spiBusAcquire(spi_client, portMAX_DELAY))
+        {
+            return eepromWriteFinish(p_job, E_EEPROM_WRITE_FAILED);
+        }
+
+        // A read back is a few microseconds on the bus, a write cycle is several milliseconds and
+        // wears the part, so unchanged pages are skipped when enabled
+        const uint8_t *bytes = p_job->bytes + p_job->offset;
+        bool program = (write_mode != E_EEPROM_WRITE_SKIP_UNCHANGED) ||
+                       !eepromPageMatches(page_addr, bytes, chunk_len);
+        if(program)
+        {
+            eepromProgramPage(page_addr, bytes, chunk_len);
+        }
+
+        spiBusRelease(spi_client);
+
+        p_job->offset += chunk_len;
+        if(program)
+        {
+            p_job->cycle_start = rtStatsReadCounter();
+            p_job->in_cycle = true;
+            return E_EEPROM_WRITE_BUSY;
+        }
+    }
+
+    return eepromWriteFinish(p_job, E_EEPROM_WRITE_DONE);
 }
 
 
 /* *************************   Private Functions   ************************ */
+
+// Sends an instruction and the 16-bit address it applies to, chip select must already be asserted
+static void eepromSendCommand(const uint8_t cmd, const uint32_t addr)
+{
+    uint8_t header[3] = {cmd, (uint8_t)(addr >> 8), (uint8_t)addr};
+    spiBusWrite(spi_client, header, sizeof(header));
+}
+
+// Compares the EEPROM contents against a buffer, stopping at the first difference
+static bool eepromPageMatches(const uint32_t addr, const uint8_t *bytes, const unsigned int num_bytes)
+{
+    uint8_t current[EEPROM_COMPARE_CHUNK_SIZE];
+    bool matches = true;
+
+    spiBusSelect(spi_client, true);
+    eepromSendCommand(EEPROM_CMD_READ, addr);
+    for(unsigned int offset = 0; (offset < num_bytes) && matches; offset += sizeof(current))
+    {
+        unsigned int chunk_len = num_bytes - offset;
+        if(chunk_len > sizeof(current))
+        {
+            chunk_len = sizeof(current);
+        }
+
+        spiBusRead(spi_client, current, chunk_len);
+        matches = (memcmp(current, bytes + offset, chunk_len) == 0);
+    }
+    spiBusSelect(spi_client, false);
+
+    return matches;
+}
+
+// Starts the write cycle for bytes within a single page, the bus must be held
+static void eepromProgramPage(const uint32_t addr, const uint8_t *bytes, const unsigned int num_bytes)
+{
+    uint8_t cmd = EEPROM_CMD_WRITE_ENABLE;
+    spiBusSelect(spi_client, true);
+    spiBusWrite(spi_client, &cmd, sizeof(cmd));
+    spiBusSelect(spi_client, false);
+
+    spiBusSelect(spi_client, true);
+    eepromSendCommand(EEPROM_CMD_WRITE, addr);
+    spiBusWrite(spi_client, bytes, num_bytes);
+    spiBusSelect(spi_client, false);
+}
+
+// Reads the status register once, E_EEPROM_WRITE_FAILED once the cycle has taken longer than
+// EEPROM_WRITE_TIMEOUT_MS. The bus is only held for the read so other clients are not locked out
+// for the milliseconds a write cycle takes, the EEPROM lock keeps other users of the part waiting.
+// Timed on the cycle counter, as the tick count doesn't run before the scheduler starts.
+static eepromWriteResult_t eepromPollWriteCycle(const eepromWriteJob_t *p_job)
+{
+    uint8_t cmd = EEPROM_CMD_READ_STATUS;
+    uint8_t status = EEPROM_STATUS_WIP;
+    uint32_t timeout = (rtStatsCounterHz() / 1000) * EEPROM_WRITE_TIMEOUT_MS;
+
+    if(!spiBusAcquire(spi_client, portMAX_DELAY))
+    {
+        return E_EEPROM_WRITE_FAILED;
+    }
+
+    spiBusSelect(spi_client, true);
+    spiBusWrite(spi_client, &cmd, sizeof(cmd));
+    spiBusRead(spi_client, &status, sizeof(status));
+    spiBusSelect(spi_client, false);
+
+    spiBusRelease(spi_client);
+
+    if((status & EEPROM_STATUS_WIP) == 0)
+    {
+        return E_EEPROM_WRITE_DONE;
+    }
+
+    return ((rtStatsReadCounter() - p_job->cycle_start) > timeout) ? E_EEPROM_WRITE_FAILED : E_EEPROM_WRITE_BUSY;
+}
+
+// Gives the lock back once a write has ended either way
+static eepromWriteResult_t eepromWriteFinish(eepromWriteJob_t *p_job, const eepromWriteResult_t result)
+{
+    if(p_job->locked)
+    {
+        eepromUnlock();
+        p_job->locked = false;
+    }
+
+    return result;
+}
+
+// Before the scheduler runs there is only one thread of execution, so nothing to lock out
+static void eepromLock(void)
+{
+    if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+    {
+        xSemaphoreTake(eeprom_mutex, portMAX_DELAY);
+    }
+}
+
+// Takes the lock only if it is free, for callers that wait for it a step at a time
+static bool eepromTryLock(void)
+{
+    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+    {
+        return true;
+    }
+
+    return (xSemaphoreTake(eeprom_mutex, 0) == pdTRUE);
+}
+
+static void eepromUnlock(void)
+{
+    if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+    {
+        xSemaphoreGive(eeprom_mutex);
+    }
+}
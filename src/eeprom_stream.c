@@ -0,0 +1,439 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  eeprom_stream.c
+//
+//  EEPROM Stream
+//
+//  Module description in eeprom_stream.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Library Includes
+
+// Project Includes
+#include "coroutine.h"
+#include "crc.h"
+#include "eeprom.h"
+#include "run_time_stats.h"
+
+// Module Includes
+#include "eeprom_stream.h"
+
+/* ***************************   Definitions   **************************** */
+
+#define STREAM_EVENT_TX_DONE            0x01
+#define STREAM_EVENT_RX_FRAME           0x02
+
+#define EEPROM_STREAM_NUM_FRAMES        2
+
+// An import the host has stopped sending to is abandoned after this long, so it can be restarted
+#define EEPROM_STREAM_IMPORT_TIMEOUT_MS 10000
+
+// How often a write cycle is checked on, the part's cycles take up to 5 ms
+#define EEPROM_STREAM_WRITE_POLL_TICKS  1
+
+// Position of the CRC field within a frame, it counts as zero when calculating the CRC
+#define EEPROM_STREAM_CRC_POS           offsetof(eepromStreamHeader_t, crc)
+#define EEPROM_STREAM_CRC_END           (EEPROM_STREAM_CRC_POS + sizeof(uint16_t))
+
+// Max length of an ack line, "ACK 65536\n"
+#define EEPROM_STREAM_ACK_MAX_SIZE      16
+
+typedef enum
+{
+    E_STREAM_IDLE = 0,
+    E_STREAM_EXPORT,
+    E_STREAM_IMPORT
+}eepromStreamState_t;
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void eepromStreamExport(coroutine_t *p_co);
+static void eepromStreamImport(coroutine_t *p_co);
+static bool eepromStreamStartSession(coroFn_t fn);
+static eepromWriteResult_t eepromStreamStartFrame(void);
+static void eepromStreamFinishFrame(const eepromWriteResult_t result);
+static void eepromStreamFillFrame(eepromStreamFrame_t *p_frame, const uint32_t offset);
+static uint16_t eepromStreamFrameCrc(eepromStreamFrame_t *p_frame);
+static void eepromStreamSendAck(const char *p_type, const uint32_t offset);
+
+static void UART_TxDmaComplete(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+// Runs the export or the import, whichever was started, on the coroutine task
+static coroutine_t stream_co;
+
+static int tx_dma_isr_stats = RT_STATS_ISR_INVALID;
+
+// Set when a session is started, so the port is owned from then on, and cleared by the session as it ends
+static volatile eepromStreamState_t stream_state = E_STREAM_IDLE;
+static int stream_uart;
+
+// Export: next EEPROM offset to read. Import: next EEPROM offset expected from the host.
+static uint32_t stream_offset = 0;
+
+// Frames are filled by one side while the other side drains the previous one
+static eepromStreamFrame_t frames[EEPROM_STREAM_NUM_FRAMES];
+
+// Export only, frame being sent and whether it is the empty frame that ends the stream
+static unsigned int tx_frame = 0;
+static bool tx_end_of_stream = false;
+
+// Import only, set by the receive ISR when a frame is complete and cleared by the session once written
+static volatile bool frame_full[EEPROM_STREAM_NUM_FRAMES];
+
+// Import only, CRC of each received frame, calculated by the receive ISR as the bytes arrive
+static uint16_t frame_crc[EEPROM_STREAM_NUM_FRAMES];
+
+// Import only, next frame to be written to the EEPROM, and its write while it is being written
+static unsigned int write_frame = 0;
+static eepromWriteJob_t write_job;
+static eepromWriteResult_t write_result;
+
+// Import only, frame the receive ISR is filling, the next byte position within it and its CRC so far
+static unsigned int rx_frame = 0;
+static unsigned int rx_pos = 0;
+static uint16_t rx_crc = 0;
+
+/* *************************   Public  Functions   ************************ */
+
+void eepromStreamInit(void)
+{
+    tx_dma_isr_stats = rtStatsRegisterIsr("Stream TX");
+}
+
+// Starts dumping the EEPROM from start_offset to the end of the part. The caller must not use the
+// serial port for anything else until the end of stream frame has been sent.
+bool eepromStreamStartExport(const int uart, const uint32_t start_offset)
+{
+    if((start_offset > EEPROM_SIZE_BYTES) || coroIsRunning(&stream_co))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    stream_uart = uart;
+    stream_offset = start_offset;
+    stream_state = E_STREAM_EXPORT;
+    taskEXIT_CRITICAL();
+
+    return eepromStreamStartSession(eepromStreamExport);
+}
+
+// Starts restoring the EEPROM. Received bytes are passed in through eepromStreamRxByteFromISR()
+// and every frame is acknowledged with the next offset expected, which is also where the host
+// restarts from after a NAK or a dropped connection. An import that stops receiving frames is
+// abandoned after EEPROM_STREAM_IMPORT_TIMEOUT_MS. The NVM data index in RAM is not updated, the
+// device must be restarted after a restore so it is rebuilt from the restored contents.
+bool eepromStreamStartImport(const int uart, const uint32_t start_offset)
+{
+    if((start_offset > EEPROM_SIZE_BYTES) || coroIsRunning(&stream_co))
+    {
+        return false;
+    }
+
+    // The receive interrupt takes the port's bytes as soon as the state is set, before the session
+    // has first run
+    taskENTER_CRITICAL();
+    memset((void *)frame_full, 0, sizeof(frame_full));
+    write_frame = 0;
+    rx_frame = 0;
+    rx_pos = 0;
+    rx_crc = crc16Start();
+    stream_uart = uart;
+    stream_offset = start_offset;
+    stream_state = E_STREAM_IMPORT;
+    taskEXIT_CRITICAL();
+
+    return eepromStreamStartSession(eepromStreamImport);
+}
+
+// Returns true while an export or import owns the serial port, nothing else may be sent on it
+bool eepromStreamIsActive(const int uart)
+{
+    return (stream_state != E_STREAM_IDLE) && (stream_uart == uart);
+}
+
+// Called from the UART receive interrupt, returns true if the byte belongs to an import and must
+// not be processed any further by the caller
+bool eepromStreamRxByteFromISR(const int uart, const uint8_t byte, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if((stream_state != E_STREAM_IMPORT) || (uart != stream_uart))
+    {
+        return false;
+    }
+
+    // Both frames are still waiting to be written, drop the byte. The frame fails its CRC or
+    // offset check and the host resends from the last acknowledged offset.
+    if(frame_full[rx_frame])
+    {
+        return true;
+    }
+
+    // Resynchronise on the first sync byte
+    if((rx_pos == 0) && (byte != (uint8_t)EEPROM_STREAM_SYNC))
+    {
+        return true;
+    }
+
+    // Running the CRC here spreads its cost over the byte interrupts, so the task doesn't have to
+    // walk the frame again before writing it
+    bool is_crc_field = (rx_pos >= EEPROM_STREAM_CRC_POS) && (rx_pos < EEPROM_STREAM_CRC_END);
+    rx_crc = crc16UpdateByte(rx_crc, is_crc_field ? 0 : byte);
+
+    uint8_t *p_frame_bytes = (uint8_t *)&frames[rx_frame];
+    p_frame_bytes[rx_pos++] = byte;
+
+    if(rx_pos < sizeof(eepromStreamHeader_t))
+    {
+        return true;
+    }
+
+    eepromStreamHeader_t *p_header = &frames[rx_frame].header;
+    if((p_header->sync != EEPROM_STREAM_SYNC) || (p_header->num_bytes > EEPROM_STREAM_CHUNK_SIZE))
+    {
+        rx_pos = 0;
+        rx_crc = crc16Start();
+        return true;
+    }
+
+    if(rx_pos == (sizeof(eepromStreamHeader_t) + p_header->num_bytes))
+    {
+        // Frame complete, hand it to the task and start filling the other one
+        frame_crc[rx_frame] = crc16Finish(rx_crc);
+        frame_full[rx_frame] = true;
+        rx_frame = (rx_frame + 1) % EEPROM_STREAM_NUM_FRAMES;
+        rx_pos = 0;
+        rx_crc = crc16Start();
+        coroSignalFromISR(&stream_co, STREAM_EVENT_RX_FRAME, pxHigherPriorityTaskWoken);
+    }
+
+    return true;
+}
+
+/* *************************   Private Functions   ************************ */
+
+// Runs the session whose state has just been set, the port is given back if it can't start
+static bool eepromStreamStartSession(coroFn_t fn)
+{
+    bool started = coroStart(&stream_co, fn, NULL);
+    if(!started)
+    {
+        stream_state = E_STREAM_IDLE;
+    }
+
+    return started;
+}
+
+// Streams frames out until the end of the part. Each frame is read from the EEPROM while the
+// previous one is still being clocked out by the UART DMA, so the link never waits on SPI.
+static void eepromStreamExport(coroutine_t *p_co)
+{
+    uint32_t events = 0;
+
+    CORO_BEGIN(p_co);
+
+    tx_frame = 0;
+    eepromStreamFillFrame(&frames[tx_frame], stream_offset);
+
+    for(;;)
+    {
+        const eepromStreamFrame_t *p_tx = &frames[tx_frame];
+        UART_SendDMA(stream_uart, (uint8_t *)p_tx, sizeof(eepromStreamHeader_t) + p_tx->header.num_bytes);
+
+        tx_end_of_stream = (p_tx->header.num_bytes == 0);
+        if(!tx_end_of_stream)
+        {
+            // Fill the other frame while this one is on the wire
+            stream_offset += p_tx->header.num_bytes;
+            tx_frame = (tx_frame + 1) % EEPROM_STREAM_NUM_FRAMES;
+            eepromStreamFillFrame(&frames[tx_frame], stream_offset);
+        }
+
+        // Wait for the DMA to release the frame before it can be refilled
+        CORO_WAIT_EVENTS(p_co, STREAM_EVENT_TX_DONE, &events, portMAX_DELAY);
+
+        if(tx_end_of_stream)
+        {
+            break;
+        }
+    }
+
+    stream_state = E_STREAM_IDLE;
+
+    CORO_END(p_co);
+}
+
+// Writes frames to the EEPROM in order as the receive interrupt completes them, acknowledging each,
+// until the end of stream frame or until the host goes quiet. The session waits out each page's
+// write cycle here, so the coroutine task is free for the other coroutines in the meantime.
+static void eepromStreamImport(coroutine_t *p_co)
+{
+    uint32_t events = 0;
+
+    CORO_BEGIN(p_co);
+
+    while(stream_state == E_STREAM_IMPORT)
+    {
+        CORO_WAIT_EVENTS(p_co, STREAM_EVENT_RX_FRAME, &events, pdMS_TO_TICKS(EEPROM_STREAM_IMPORT_TIMEOUT_MS));
+        if(CORO_TIMED_OUT(p_co))
+        {
+            stream_state = E_STREAM_IDLE;
+        }
+        else
+        {
+            while(frame_full[write_frame])
+            {
+                write_result = eepromStreamStartFrame();
+                while(write_result == E_EEPROM_WRITE_BUSY)
+                {
+                    CORO_DELAY(p_co, EEPROM_STREAM_WRITE_POLL_TICKS);
+                    write_result = eepromWriteStep(&write_job);
+                }
+
+                eepromStreamFinishFrame(write_result);
+            }
+        }
+    }
+
+    CORO_END(p_co);
+}
+
+// Checks the next received frame and starts writing it. Returns E_EEPROM_WRITE_FAILED for a frame
+// to be NAKed, and E_EEPROM_WRITE_DONE straight away for the end of stream frame.
+static eepromWriteResult_t eepromStreamStartFrame(void)
+{
+    eepromStreamFrame_t *p_frame = &frames[write_frame];
+    uint16_t num_bytes = p_frame->header.num_bytes;
+
+    bool valid = (p_frame->header.crc == frame_crc[write_frame]) &&
+                 (p_frame->header.offset == stream_offset) &&
+                 ((stream_offset + num_bytes) <= EEPROM_SIZE_BYTES);
+
+    if(!valid)
+    {
+        return E_EEPROM_WRITE_FAILED;
+    }
+
+    if(num_bytes == 0)
+    {
+        return E_EEPROM_WRITE_DONE;
+    }
+
+    eepromWriteStart(&write_job, stream_offset, p_frame->data, num_bytes);
+    return eepromWriteStep(&write_job);
+}
+
+// Acknowledges the frame once it is written, and gives it back to the receive interrupt
+static void eepromStreamFinishFrame(const eepromWriteResult_t result)
+{
+    uint16_t num_bytes = frames[write_frame].header.num_bytes;
+
+    if((result == E_EEPROM_WRITE_DONE) && (num_bytes == 0))
+    {
+        eepromStreamSendAck("END", stream_offset);
+        stream_state = E_STREAM_IDLE;
+    }
+    else if(result == E_EEPROM_WRITE_DONE)
+    {
+        stream_offset += num_bytes;
+        eepromStreamSendAck("ACK", stream_offset);
+    }
+    else
+    {
+        // Host resumes from the offset in the NAK
+        eepromStreamSendAck("NAK", stream_offset);
+    }
+
+    frame_full[write_frame] = false;
+    write_frame = (write_frame + 1) % EEPROM_STREAM_NUM_FRAMES;
+}
+
+// Reads the next chunk of the EEPROM into a frame, an empty frame past the end of the part
+static void eepromStreamFillFrame(eepromStreamFrame_t *p_frame, const uint32_t offset)
+{
+    uint32_t remaining = EEPROM_SIZE_BYTES - offset;
+    uint16_t num_bytes = (remaining < EEPROM_STREAM_CHUNK_SIZE) ? remaining : EEPROM_STREAM_CHUNK_SIZE;
+
+    p_frame->header.sync = EEPROM_STREAM_SYNC;
+    p_frame->header.num_bytes = num_bytes;
+    p_frame->header.offset = offset;
+    p_frame->header.reserved = 0;
+
+    if(num_bytes != 0)
+    {
+        eepromReadBytes(offset, p_frame->data, num_bytes);
+    }
+
+    p_frame->header.crc = eepromStreamFrameCrc(p_frame);
+}
+
+// CRC of a frame as it is defined on the wire
+static uint16_t eepromStreamFrameCrc(eepromStreamFrame_t *p_frame)
+{
+    eepromStreamHeader_t header = p_frame->header;
+    header.crc = 0;
+
+    uint16_t crc = crc16Update(crc16Start(), (uint8_t *)&header, sizeof(header));
+    return crc16Finish(crc16Update(crc, p_frame->data, header.num_bytes));
+}
+
+static void eepromStreamSendAck(const char *p_type, const uint32_t offset)
+{
+    char ack[EEPROM_STREAM_ACK_MAX_SIZE];
+    snprintf(ack, sizeof(ack), "%s %lu\n", p_type, (unsigned long)offset);
+    UART_Send(stream_uart, ack);
+}
+
+/* *************************  Interrupt Handlers  ************************* */
+
+// An abstraction of the UART transmit DMA complete interrupt for the port being streamed to
+static void UART_TxDmaComplete(void)
+{
+    uint32_t isr_start = rtStatsIsrEnter(tx_dma_isr_stats);
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    coroSignalFromISR(&stream_co, STREAM_EVENT_TX_DONE, &xHigherPriorityTaskWoken);
+
+    rtStatsIsrExit(tx_dma_isr_stats, isr_start);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
@@ -46,14 +46,22 @@
 // Project Includes
 
 // Module Includes
+#include "coroutine.h"
+#include "crc.h"
 #include "eeprom.h"
+#include "eeprom_stream.h"
 #include "modem.h"
 #include "message_handler.h"
+#include "nvm_data.h"
+#include "queue_tuner.h"
+#include "run_time_stats.h"
+#include "spi_bus.h"
 
 /* ***************************   Definitions   **************************** */
 
 #define MODEM_TASK_PRIORITY             3
 #define MSG_HANDLER_TASK_PRIORITY       2
+#define COROUTINE_TASK_PRIORITY         1
 
 /* ****************************   Structures   **************************** */
 
@@ -61,17 +69,47 @@
 
 /* ***********************   File Scope Variables   *********************** */
 
+// The kernel's own tasks, the application's tasks keep their memory in their modules
+static StaticTask_t idle_task_buffer;
+static StackType_t idle_task_stack[configMINIMAL_STACK_SIZE];
+static StaticTask_t timer_task_buffer;
+static StackType_t timer_task_stack[configTIMER_TASK_STACK_DEPTH];
+
 /* *************************   Public  Functions   ************************ */
 
 int main(void)
 {
     // Setup the Hardware and init the tasks
+    rtStatsInit();
+    spiBusInit();
     eepromInit();
+    eepromSetWriteMode(E_EEPROM_WRITE_SKIP_UNCHANGED);
+    nvmDataInit();
+    queueTunerInit();
     modemInit(MODEM_TASK_PRIORITY);
     msgHandlerInit(MSG_HANDLER_TASK_PRIORITY);
+    coroInit(COROUTINE_TASK_PRIORITY);
+    eepromStreamInit();
 
     // Tasks are setup, start the scheduler
     vTaskStartScheduler();
 }
 
+// Called by the kernel as the scheduler starts
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &idle_task_buffer;
+    *ppxIdleTaskStackBuffer = idle_task_stack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &timer_task_buffer;
+    *ppxTimerTaskStackBuffer = timer_task_stack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
 /* *************************   Private Functions   ************************ */
@@ -34,29 +34,63 @@
 /* ***************************    Includes     **************************** */
 
 // Standard Includes
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
 
 // FreeRTOS Includes
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
+#include "message_buffer.h"
 
 // Library Includes
 
 // Project Includes
 #include "eeprom.h"
+#include "eeprom_stream.h"
 #include "modem.h"
+#include "nvm_data.h"
+#include "queue_tuner.h"
+#include "run_time_stats.h"
+#include "spsc_channel.h"
+#include "trace_recorder.h"
 
 // Module Includes
 #include "message_handler.h"
 
 /* ***************************   Definitions   **************************** */
 
-#define MSG_HDLR_MAX_MESSAGES_FROM_SERIAL       10
+// Each serial port has its own channel so each has a single producer
+#define MSG_HDLR_NUM_SERIAL_PORTS               2
 
+// Queue sizes before the queue tuner has learned better ones, and the least it may give them
+#define MSG_HDLR_MAX_MESSAGES_PER_SERIAL_PORT   5
 #define MSG_HDLR_MAX_MESSAGES_FROM_MODEM        5
+#define MSG_HDLR_MIN_MESSAGES                   2
 
-#define TASK_NOTIF_SERIAL_MSG_RX                0x01
-#define TASK_NOTIF_MODEM_MSG_RX                 0x02
+// Messages from the modem are stored with only as many bytes as they use, each behind its length
+#define MSG_HDLR_MODEM_MSG_BYTES                (sizeof(msgStampedMsg_t) + sizeof(size_t))
+
+#define MSG_HDLR_TASK_STACK_SIZE                configMINIMAL_STACK_SIZE
+
+// Index of the task's notification, given by every source of messages and by the queue tuner. Index
+// 0 is left to the kernel.
+#define MSG_HDLR_NOTIFY_WAKE                    1
+
+// Serial messages starting with this are commands for the device itself rather than the modem
+#define MSG_LOCAL_CMD_PREFIX                    '#'
+#define MSG_LOCAL_CMD_DUMP                      "#DUMP"
+#define MSG_LOCAL_CMD_LOAD                      "#LOAD"
+#define MSG_LOCAL_CMD_STATS                     "#STATS"
+#define MSG_LOCAL_CMD_TRACE                     "#TRACE"
+#define MSG_LOCAL_CMD_QSTATS                    "#QSTATS"
+#define MSG_LOCAL_CMD_STACK                     "#STACK"
+
+// Replies to a local command that could not be carried out, sent to the port the command came from
+#define MSG_LOCAL_REPLY_BAD_PORT                "ERR port\n"
+#define MSG_LOCAL_REPLY_BUSY                    "ERR busy\n"
+#define MSG_LOCAL_REPLY_FAILED                  "ERR failed\n"
 
 
 typedef enum
@@ -69,46 +103,143 @@ typedef enum
 
 /* ****************************   Structures   **************************** */
 
+// A message stamped with when it arrived, as messages are kept in the serial channels and the modem
+// message buffer. The buffer only stores the used part of the data.
+typedef struct
+{
+    uint32_t arrival;
+    msgData_t data;
+}msgStampedMsg_t;
+
 /* ***********************   Function Prototypes   ************************ */
 
 static void msgHandlerTask(void *pvParameters);
 static msgDestination_t msgDetermineDestination(const msgData_t *p_msg);
+static uint8_t msgDetermineRecordId(const msgData_t *p_msg);
+static void msgHandleLocalCommand(const int source_uart, const msgData_t *p_msg);
+static void msgSendToPort(const int uart, const char *p_str);
+static void msgHandlerModemMsgUsage(void *p_context, queueTunerUsage_t *p_usage);
+static bool msgHandleOldestMsg(void);
+static void msgHandleSerialMsg(const int port, msgData_t *p_msg);
+static void msgHandleModemMsg(msgData_t *p_msg, const size_t msg_len);
+static bool msgArrivedBefore(const uint32_t arrival, const uint32_t other_arrival);
 
 static void UART1_Receive(void);
 static void UART2_Receive(void)
-static void UART_Receive(msgData_t *p_data, int *p_curr_idx, char incoming_byte);
+static void UART_Receive(spscChannel_t *p_chan, int *p_curr_idx, bool *p_discarding, char incoming_byte);
 
 /* ***********************   File Scope Variables   *********************** */
 
-static QueueHandle_t modem_messages_q = NULL;
+// Only the modem task hands messages in, through msgHandlerModemMsg(), so it has a single producer
+static MessageBufferHandle_t modem_messages_mb = NULL;
+static StaticMessageBuffer_t modem_messages_mb_buffer;
+static size_t modem_messages_size = 0;
+
+// Usage of the modem message buffer, for the queue tuner
+static size_t modem_messages_peak = 0;
+static uint32_t modem_messages_full = 0;
+
+// Messages received on serial ports 1 and 2, written in place by the receive interrupts
+static spscChannel_t serial_channels[MSG_HDLR_NUM_SERIAL_PORTS];
+static const int serial_uarts[MSG_HDLR_NUM_SERIAL_PORTS] = {UART1, UART2};
 
-static QueueHandle_t serial_messages_q = NULL;
+// Every message is stamped from this as it arrives, the task handles the lowest stamp first
+static _Atomic uint32_t msg_arrivals;
 
 static TaskHandle_t message_task = NULL;
+static StaticTask_t message_task_buffer;
+static StackType_t message_task_stack[MSG_HDLR_TASK_STACK_SIZE];
+
+static int uart_isr_stats[MSG_HDLR_NUM_SERIAL_PORTS] = {RT_STATS_ISR_INVALID, RT_STATS_ISR_INVALID};
+
+static int serial_msg_stage = TRACE_REC_STAGE_INVALID;
+static int modem_msg_stage = TRACE_REC_STAGE_INVALID;
+
+// Message being put in the modem message buffer by the modem task, the only one that does
+static msgStampedMsg_t modem_msg_out;
+
+// Message taken out of the modem message buffer by the task, kept off the task's stack and held
+// there until it is the oldest message waiting
+static msgStampedMsg_t modem_msg_in;
+static size_t modem_msg_in_len = 0;
 
 /* *************************   Public  Functions   ************************ */
 
 // Initializes the message handler
 void msgHandlerInit(const int task_priority)
 {
-    // Initialize the queue for handling the incoming message data from the serial interface(s)
-    serial_messages_q = xQueueCreate(MSG_HDLR_MAX_MESSAGES_FROM_SERIAL, sizeof(msgData_t));
-    assert(serial_messages_q != NULL);
+    // Initialize the message buffer for handling messages from the modem
+    uint32_t num_items = queueTunerRegister("Modem msgs", MSG_HDLR_MODEM_MSG_BYTES, MSG_HDLR_MIN_MESSAGES,
+                                            MSG_HDLR_MAX_MESSAGES_FROM_MODEM, msgHandlerModemMsgUsage, NULL);
+    modem_messages_size = num_items * MSG_HDLR_MODEM_MSG_BYTES;
+    // A message buffer keeps one byte of its storage free
+    modem_messages_mb = xMessageBufferCreateStatic(modem_messages_size + 1, queueTunerAlloc(modem_messages_size + 1),
+                                                   &modem_messages_mb_buffer);
+    assert(modem_messages_mb != NULL);
+    traceRecAddSymbol(E_TRACE_CLASS_STREAM, (uint8_t)uxStreamBufferGetStreamBufferNumber(modem_messages_mb),
+                      "Modem msgs");
+
+    message_task = xTaskCreateStatic(msgHandlerTask, "Message Handler", MSG_HDLR_TASK_STACK_SIZE, void,
+                                     task_priority, message_task_stack, &message_task_buffer);
+    assert(message_task != NULL);
 
-    // Initialize the queue for handling messages from the modem
-    modem_messages_q = xQueueCreate(MSG_HDLR_MAX_MESSAGES_FROM_MODEM, sizeof(msgData_t));
-    assert(modem_messages_q != NULL);
+    // Initialize the channels for handling the incoming message data from the serial interfaces
+    static const char *serial_names[MSG_HDLR_NUM_SERIAL_PORTS] = {"Serial 1", "Serial 2"};
+    for(int port = 0; port < MSG_HDLR_NUM_SERIAL_PORTS; port++)
+    {
+        num_items = queueTunerRegister(serial_names[port], sizeof(msgStampedMsg_t), MSG_HDLR_MIN_MESSAGES,
+                                       MSG_HDLR_MAX_MESSAGES_PER_SERIAL_PORT, queueTunerChannelUsage,
+                                       &serial_channels[port]);
+        msgStampedMsg_t *p_storage = queueTunerAlloc(SPSC_CHANNEL_NUM_SLOTS(num_items) * sizeof(msgStampedMsg_t));
+        spscChannelInit(&serial_channels[port], p_storage, sizeof(msgStampedMsg_t),
+                        SPSC_CHANNEL_NUM_SLOTS(num_items), message_task, MSG_HDLR_NOTIFY_WAKE);
+    }
 
-    xTaskCreate(msgHandlerTask, "Message Handler", configMINIMAL_STACK_SIZE, void, task_priority, &message_task);
-    assert(message_task != NULL);
+    // Queue sizes are sampled and learned from in this task, as it owns the EEPROM writes
+    queueTunerStart(message_task, MSG_HDLR_NOTIFY_WAKE);
+
+    uart_isr_stats[0] = rtStatsRegisterIsr("UART1 RX");
+    uart_isr_stats[1] = rtStatsRegisterIsr("UART2 RX");
+
+    serial_msg_stage = traceRecRegisterStage("Serial msg");
+    modem_msg_stage = traceRecRegisterStage("Modem msg");
 }
 
-// Receive a message data from the modem
+// Receive a message data from the modem, only called from the modem task
 void msgHandlerModemMsg(const msgData_t *p_msg_data)
 {
-    // Send the data and notify the task
-    xQueueSend(modem_messages_q, p_msg_data, portMAX_DELAY);
-    xTaskNotify(message_task, TASK_NOTIF_MODEM_MSG_RX, eSetBits);
+    // Only the used part of the message is sent, it is terminated again on the way out
+    size_t msg_len = strnlen(p_msg_data->msg, sizeof(p_msg_data->msg));
+    if(msg_len == 0)
+    {
+        return;
+    }
+
+    size_t num_bytes = offsetof(msgStampedMsg_t, data.msg) + msg_len;
+
+    // Having to wait for space counts as finding the buffer full
+    taskENTER_CRITICAL();
+    if(xMessageBufferSpacesAvailable(modem_messages_mb) < (num_bytes + sizeof(size_t)))
+    {
+        modem_messages_full++;
+    }
+    taskEXIT_CRITICAL();
+
+    // Stamp the message and send it, then notify the task
+    modem_msg_out.arrival = atomic_fetch_add_explicit(&msg_arrivals, 1, memory_order_relaxed);
+    memcpy(modem_msg_out.data.msg, p_msg_data->msg, msg_len);
+    if(xMessageBufferSend(modem_messages_mb, &modem_msg_out, num_bytes, portMAX_DELAY) == num_bytes)
+    {
+        taskENTER_CRITICAL();
+        size_t used = modem_messages_size - xMessageBufferSpacesAvailable(modem_messages_mb);
+        if(used > modem_messages_peak)
+        {
+            modem_messages_peak = used;
+        }
+        taskEXIT_CRITICAL();
+
+        xTaskNotifyGiveIndexed(message_task, MSG_HDLR_NOTIFY_WAKE);
+    }
 }
 
 /* *************************   Private Functions   ************************ */
@@ -119,71 +250,223 @@ static void msgHandlerTask(void *pvParameters)
     UART_Init(UART_1, &config_struct, etc);
     UART_Init(UART_2, &config_struct, etc);
 
-    uint32_t notify_value = 0;
-    msgData_t msg;
     for(;;)
     {
-        // Wait indefintiely for data to come in on either serial interface or from the modem
-        xTaskNotifyWait(0, UINT32_MAX, &notify_value, portMAX_DELAY);
+        // Samples the queues if the queue tuner's period has ended, which also wakes the task
+        queueTunerUpdate();
+
+        // Handle the oldest message waiting, from either serial interface or the modem, and only
+        // block once there are none. The serial channels only notify the task once it has said it
+        // is about to block on them, the modem and the queue tuner notify it every time. Each wake
+        // costs the one kernel call that takes the notification.
+        if(!msgHandleOldestMsg() && spscChannelPrepareToWait(&serial_channels[0]) &&
+           spscChannelPrepareToWait(&serial_channels[1]))
+        {
+            ulTaskNotifyTakeIndexed(MSG_HDLR_NOTIFY_WAKE, pdTRUE, portMAX_DELAY);
+        }
+    }
+}
+
+// Handles whichever message waiting at the head of a serial channel or the modem message buffer
+// arrived first. Returns false if there were none.
+static bool msgHandleOldestMsg(void)
+{
+    // The modem message is held once taken out of the buffer, until it is the oldest
+    if(modem_msg_in_len == 0)
+    {
+        size_t num_bytes = xMessageBufferReceive(modem_messages_mb, &modem_msg_in, sizeof(modem_msg_in), 0);
+        if(num_bytes > offsetof(msgStampedMsg_t, data.msg))
+        {
+            modem_msg_in_len = num_bytes - offsetof(msgStampedMsg_t, data.msg);
+        }
+    }
 
+    msgStampedMsg_t *p_oldest = NULL;
+    int oldest_port = -1;
+    for(int port = 0; port < MSG_HDLR_NUM_SERIAL_PORTS; port++)
+    {
+        msgStampedMsg_t *p_serial = spscChannelReadSlot(&serial_channels[port]);
+        if((p_serial != NULL) && ((p_oldest == NULL) || msgArrivedBefore(p_serial->arrival, p_oldest->arrival)))
+        {
+            p_oldest = p_serial;
+            oldest_port = port;
+        }
+    }
 
-        // Handle messages from Serial Interfaces
-        if((notify_value & TASK_NOTIF_SERIAL_MSG_RX) != 0)
+    if((modem_msg_in_len > 0) && ((p_oldest == NULL) || msgArrivedBefore(modem_msg_in.arrival, p_oldest->arrival)))
+    {
+        if(modem_msg_in_len < sizeof(modem_msg_in.data.msg))
         {
-            while(xQueueReceive(serial_messages_q, &msg, 0) == pdTRUE)
-            {
-                // Send message over to Modem Module
-                modemSendCommand(&msg);
-            }
+            modem_msg_in.data.msg[modem_msg_in_len] = '\0';
         }
 
-        // Handle message data from the modem
-        if((notify_value & TASK_NOTIF_MODEM_MSG_RX) != 0)
+        msgHandleModemMsg(&modem_msg_in.data, modem_msg_in_len);
+        modem_msg_in_len = 0;
+        return true;
+    }
+
+    if(p_oldest != NULL)
+    {
+        msgHandleSerialMsg(oldest_port, &p_oldest->data);
+        spscChannelConsume(&serial_channels[oldest_port]);
+        return true;
+    }
+
+    return false;
+}
+
+// Handles a message from a serial interface, read in place from its channel
+static void msgHandleSerialMsg(const int port, msgData_t *p_msg)
+{
+    traceRecStage(serial_msg_stage, (uint16_t)(port + 1));
+
+    if(p_msg->msg[0] == MSG_LOCAL_CMD_PREFIX)
+    {
+        msgHandleLocalCommand(serial_uarts[port], p_msg);
+    }
+    else
+    {
+        // Send message over to Modem Module
+        modemSendCommand(p_msg);
+    }
+}
+
+// Handles a message from the modem
+static void msgHandleModemMsg(msgData_t *p_msg, const size_t msg_len)
+{
+    // Determine if the data needs to go to one of the serial ports or the EEPROM
+    msgDestination_t dest = msgDetermineDestination(p_msg);
+    traceRecStage(modem_msg_stage, (uint16_t)dest);
+
+    // Send the data to it's proper destination
+    switch(dest)
+    {
+        case E_DEST_UART1:
+            msgSendToPort(UART1, p_msg->msg);
+            break;
+
+        case E_DEST_UART2:
+            msgSendToPort(UART2, p_msg->msg);
+            break;
+
+        case E_DEST_EEPROM:
         {
-            // Handle all the messages coming from the modem
-            while(xQueueReceive(modem_messages_q, &msg, 0) == pdTRUE)
-            {
-                // Determine if the data needs to go to one of the serial ports or the EEPROM
-                msgDestination_t dest = msgDetermineDestination(&msg);
-
-                // Send the data to it's proper destination
-                switch(dest)
-                {
-                    case E_DEST_UART1:
-                        UART_Send(UART1, msg.msg);
-                        break;
-
-                    case E_DEST_UART2:
-                        UART_Send(UART2, msg.msg);
-                        break;
-
-                    case E_DEST_EEPROM:
-                    {
-                        // Determine num bytes to write
-                        int msg_len = strnlen(msg.msg, (sizeof(msg.msg)));
-
-                        // Somehow determine the address at which the EEPROM data belongs
-                        // This might be a function of some kind of NVM data manager module
-                        uint32_t address = nvmDataGetAddr();
-                        eepromWriteBytes(address, msg.msg, msg_len);
-                        break;
-                    }
-
-                    default:
-                        // Shouldn't happen
-                        assert(false);
-                }
-            }
+            // The NVM data manager decides where in the EEPROM the record lives
+            uint8_t record_id = msgDetermineRecordId(p_msg);
+            assert(record_id < NVM_DATA_RECORD_ID_QUEUE_TUNER);
+            nvmDataWriteRecord(record_id, (uint8_t *)p_msg->msg, msg_len);
+            break;
         }
+
+        default:
+            // Shouldn't happen
+            assert(false);
     }
 }
 
+// Stamps are compared by their difference so the order holds as the count wraps
+static bool msgArrivedBefore(const uint32_t arrival, const uint32_t other_arrival)
+{
+    return (int32_t)(arrival - other_arrival) < 0;
+}
+
+// Messages take only the bytes they use, so the peak in messages is rounded up from the peak in bytes
+static void msgHandlerModemMsgUsage(void *p_context, queueTunerUsage_t *p_usage)
+{
+    taskENTER_CRITICAL();
+    p_usage->peak_items = (modem_messages_peak + MSG_HDLR_MODEM_MSG_BYTES - 1) / MSG_HDLR_MODEM_MSG_BYTES;
+    p_usage->num_full = modem_messages_full;
+    taskEXIT_CRITICAL();
+}
 
 static msgDestination_t msgDetermineDestination(const msgData_t *p_msg)
 {
     // Determine where the message would go, based on some critera and return a valid destination
 }
 
+static uint8_t msgDetermineRecordId(const msgData_t *p_msg)
+{
+    // Determine which NVM record the message data is stored as, based on some criteria. The IDs from
+    // NVM_DATA_RECORD_ID_QUEUE_TUNER up are kept for the device's own settings and are never used.
+}
+
+// Handles a command addressed to the device itself
+//  "#DUMP <port> <offset>" streams the EEPROM out of serial port 1 or 2 from the given offset
+//  "#LOAD <port> <offset>" restores the EEPROM from frames received on serial port 1 or 2
+// Both can be resumed after an interruption by reissuing them with the last acknowledged offset.
+//  "#STATS <port>" reports the CPU used by each task and interrupt since the last report
+//  "#TRACE <port>" dumps the trace recorder, decoded offline by tools/trace_decode.py
+//  "#QSTATS <port>" reports the usage of each registered queue since the last report
+//  "#STACK <port>" reports the deepest each task's stack has been
+// A port other than 1 or 2, a port in the middle of a stream or a stream that can't start is
+// answered with an error on the port the command came from.
+static void msgHandleLocalCommand(const int source_uart, const msgData_t *p_msg)
+{
+    char cmd[sizeof(MSG_LOCAL_CMD_QSTATS)];
+    int port = 0;
+    unsigned long offset = 0;
+
+    int num_fields = sscanf(p_msg->msg, "%7s %d %lu", cmd, &port, &offset);
+    if(num_fields < 2)
+    {
+        return;
+    }
+
+    if((port < 1) || (port > MSG_HDLR_NUM_SERIAL_PORTS))
+    {
+        msgSendToPort(source_uart, MSG_LOCAL_REPLY_BAD_PORT);
+        return;
+    }
+
+    int uart = serial_uarts[port - 1];
+    if(eepromStreamIsActive(uart))
+    {
+        msgSendToPort(source_uart, MSG_LOCAL_REPLY_BUSY);
+        return;
+    }
+
+    if((strcmp(cmd, MSG_LOCAL_CMD_DUMP) == 0) && (num_fields == 3))
+    {
+        if(!eepromStreamStartExport(uart, offset))
+        {
+            msgSendToPort(source_uart, MSG_LOCAL_REPLY_FAILED);
+        }
+    }
+    else if((strcmp(cmd, MSG_LOCAL_CMD_LOAD) == 0) && (num_fields == 3))
+    {
+        if(!eepromStreamStartImport(uart, offset))
+        {
+            msgSendToPort(source_uart, MSG_LOCAL_REPLY_FAILED);
+        }
+    }
+    else if(strcmp(cmd, MSG_LOCAL_CMD_STATS) == 0)
+    {
+        rtStatsReport(uart);
+    }
+    else if(strcmp(cmd, MSG_LOCAL_CMD_TRACE) == 0)
+    {
+        traceRecDump(uart);
+    }
+    else if(strcmp(cmd, MSG_LOCAL_CMD_QSTATS) == 0)
+    {
+        rtStatsQueueReport(uart);
+    }
+    else if(strcmp(cmd, MSG_LOCAL_CMD_STACK) == 0)
+    {
+        rtStatsStackReport(uart);
+    }
+}
+
+// Anything sent on a port while it is streaming would be taken by the host as part of the stream,
+// so it is dropped
+static void msgSendToPort(const int uart, const char *p_str)
+{
+    if(!eepromStreamIsActive(uart))
+    {
+        UART_Send(uart, p_str);
+    }
+}
+
 /* *************************  Interrupt Handlers  ************************* */
 
 // An abstraction of a UART Rx interrupt
@@ -191,12 +474,24 @@ static msgDestination_t msgDetermineDestination(const msgData_t *p_msg)
 // UART and write them to a buffer, when the entire message is received send it to the task
 static void UART1_Receive(void)
 {
-    static msgData_t data;
     static int current_pos = 0;
+    static bool discarding = false;
+    uint32_t isr_start = rtStatsIsrEnter(uart_isr_stats[0]);
 
-    // Write the incoming data to the buffer
     char incoming_byte = UART_ReadData(UART1);
-    UART_Receive(&data, &current_pos, incoming_byte);
+
+    // Bytes of an EEPROM restore bypass the message framing
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(eepromStreamRxByteFromISR(UART1, incoming_byte, &xHigherPriorityTaskWoken))
+    {
+        rtStatsIsrExit(uart_isr_stats[0], isr_start);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        return;
+    }
+
+    // Write the incoming data to the channel
+    UART_Receive(&serial_channels[0], &current_pos, &discarding, incoming_byte);
+    rtStatsIsrExit(uart_isr_stats[0], isr_start);
 }
 
 // An abstraction of a UART Rx interrupt
@@ -204,29 +499,57 @@ static void UART1_Receive(void)
 // UART and write them to a buffer, when the entire message is received send it to the task
 static void UART2_Receive(void)
 {
-    static msgData_t data;
     static int current_pos = 0;
+    static bool discarding = false;
+    uint32_t isr_start = rtStatsIsrEnter(uart_isr_stats[1]);
 
-    // Write the incoming data to the buffer
     char incoming_byte = UART_ReadData(UART2);
-    UART_Receive(&data, &current_pos, incoming_byte);
+
+    // Bytes of an EEPROM restore bypass the message framing
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if(eepromStreamRxByteFromISR(UART2, incoming_byte, &xHigherPriorityTaskWoken))
+    {
+        rtStatsIsrExit(uart_isr_stats[1], isr_start);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+        return;
+    }
+
+    // Write the incoming data to the channel
+    UART_Receive(&serial_channels[1], &current_pos, &discarding, incoming_byte);
+    rtStatsIsrExit(uart_isr_stats[1], isr_start);
 }
 
 
 // Process the incoming serial data
-static void UART_Receive(msgData_t *p_data, int *p_curr_idx, char incoming_byte)
+// The message is built directly in the channel's write slot. If the channel is full or the message
+// is too long the whole message is dropped, the rest of it is discarded up to and including its '\n'
+static void UART_Receive(spscChannel_t *p_chan, int *p_curr_idx, bool *p_discarding, char incoming_byte)
 {
-    p_data->msg[(*p_curr_idx)++] = incoming_byte;
+    if(*p_discarding)
+    {
+        *p_discarding = (incoming_byte != '\n');
+        return;
+    }
+
+    msgStampedMsg_t *p_data = spscChannelWriteSlot(p_chan);
+    if((p_data == NULL) || (*p_curr_idx >= MSG_DATA_MAX_SIZE))
+    {
+        spscChannelDropFromISR(p_chan);
+        *p_curr_idx = 0;
+        *p_discarding = (incoming_byte != '\n');
+        return;
+    }
+
+    p_data->data.msg[(*p_curr_idx)++] = incoming_byte;
 
     // Check to see if the message is complete by checking for a '\n'
     if(incoming_byte == '\n')
     {
-        // Message is complete, send to task for processing
+        // Message is complete, stamp it and hand it to the task, which is notified if it is waiting
+        // for it
+        p_data->arrival = atomic_fetch_add_explicit(&msg_arrivals, 1, memory_order_relaxed);
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-        xQueueSendFromISR(serial_messages_q, p_data->msg, &xHigherPriorityTaskWoken);
-
-        // Notify the task that data has been sent to queue
-        xTaskNotifyFromISR(message_task, TASK_NOTIF_SERIAL_MSG_RX, eSetBits, &xHigherPriorityTaskWoken);
+        spscChannelPublishFromISR(p_chan, &xHigherPriorityTaskWoken);
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 
         // Reset position of buffer
@@ -47,6 +47,10 @@
 
 // Project Includes
 #include "message_handler.h"
+#include "queue_tuner.h"
+#include "run_time_stats.h"
+#include "spsc_channel.h"
+#include "trace_recorder.h"
 
 // Module Includes
 #include "modem.h"
@@ -58,11 +62,17 @@
 #define AT_CMD_RESPONSE_STR     "COMMAND_RESPONSE"
 #define AT_STATUS_MSG_STR       "STATUS_MESSAGE"
 
-#define MODEM_DATA_QUEUE_SIZE   5
+// Queue sizes before the queue tuner has learned better ones, and the least it may give them
+#define MODEM_DATA_QUEUE_SIZE       5
+#define MODEM_DATA_QUEUE_MIN_SIZE   2
 
+#define MODEM_TASK_STACK_SIZE       configMINIMAL_STACK_SIZE
 
-#define TASK_NOTIF_DATA_FROM_MODEM  0x01
-#define TASK_NOTIF_DATA_TO_MODEM    0x02
+
+// Indexes of the task's notifications, each source counts its own. Index 0 is left to the kernel.
+#define MODEM_NOTIFY_DATA_FROM_MODEM    1
+#define MODEM_NOTIFY_DATA_TO_MODEM      2
+#define MODEM_NOTIFY_BIT(index)         ((UBaseType_t)1 << (index))
 
 typedef enum
 {
@@ -84,42 +94,70 @@ static void UART3_Receive(void);
 
 /* ***********************   File Scope Variables   *********************** */
 
-static QueueHandle_t data_from_modem_q = NULL;
+// Data from the modem, written in place by the UART receive interrupt
+static spscChannel_t data_from_modem_channel;
 
 static QueueHandle_t data_to_modem_q = NULL;
+static StaticQueue_t data_to_modem_q_buffer;
 
 static TaskHandle_t modem_task = NULL;
+static StaticTask_t modem_task_buffer;
+static StackType_t modem_task_stack[MODEM_TASK_STACK_SIZE];
+
+static int uart_isr_stats = RT_STATS_ISR_INVALID;
+
+static int at_cmd_sent_stage = TRACE_REC_STAGE_INVALID;
+static int at_msg_parsed_stage = TRACE_REC_STAGE_INVALID;
 
 /* *************************   Public  Functions   ************************ */
 
 void modemInit(const int task_priority)
 {
-    // Setup queue for receiving data from modem
-    data_from_modem_q = xQueueCreate(MODEM_DATA_QUEUE_SIZE, sizeof(modemAtCmdData_t));
-    assert(data_from_modem_q != NULL);
-
     // Setup queue for sending commands to modem from external modules
-    data_to_modem_q = xQueueCreate(MODEM_DATA_QUEUE_SIZE, sizeof(modemAtCmdData_t));
-    assert(data_from_modem_q != NULL);
+    uint32_t num_items = queueTunerRegister("Modem TX", sizeof(modemAtCmdData_t), MODEM_DATA_QUEUE_MIN_SIZE,
+                                            MODEM_DATA_QUEUE_SIZE, queueTunerQueueUsage, &data_to_modem_q);
+    data_to_modem_q = xQueueCreateStatic(num_items, sizeof(modemAtCmdData_t),
+                                         queueTunerAlloc(num_items * sizeof(modemAtCmdData_t)),
+                                         &data_to_modem_q_buffer);
+    assert(data_to_modem_q != NULL);
+    vQueueAddToRegistry(data_to_modem_q, "Modem TX");
+    vQueueSetEnqueueTimes(data_to_modem_q, queueTunerAlloc(num_items * sizeof(uint32_t)));
 
     // Create the task for processing incoming data
-    xTaskCreate(modemTask, "Modem Task", configMINIMAL_STACK_SIZE, void, task_priority, &modem_task);
+    modem_task = xTaskCreateStatic(modemTask, "Modem Task", MODEM_TASK_STACK_SIZE, void, task_priority,
+                                   modem_task_stack, &modem_task_buffer);
     assert(modem_task != NULL);
+
+    // Setup channel for receiving data from modem
+    num_items = queueTunerRegister("Modem RX", sizeof(modemAtCmdData_t), MODEM_DATA_QUEUE_MIN_SIZE,
+                                   MODEM_DATA_QUEUE_SIZE, queueTunerChannelUsage, &data_from_modem_channel);
+    modemAtCmdData_t *p_storage = queueTunerAlloc(SPSC_CHANNEL_NUM_SLOTS(num_items) * sizeof(modemAtCmdData_t));
+    spscChannelInit(&data_from_modem_channel, p_storage, sizeof(modemAtCmdData_t),
+                    SPSC_CHANNEL_NUM_SLOTS(num_items), modem_task, MODEM_NOTIFY_DATA_FROM_MODEM);
+
+    uart_isr_stats = rtStatsRegisterIsr("UART3 RX");
+
+    at_cmd_sent_stage = traceRecRegisterStage("AT sent");
+    at_msg_parsed_stage = traceRecRegisterStage("AT parsed");
 }
 
 // Interface to send data to the modem
 // Generates and AT Data command and appends the data
 void modemSendCommand(msgData_t *p_data_msg)
 {
+    // Reserve a slot in the queue and build the AT command directly in it, saves copying the
+    // command through the stack
+    modemAtCmdData_t *p_data = NULL;
+    xQueueReserve(data_to_modem_q, (void **)&p_data, portMAX_DELAY);
+
     // Convert the data to an AT command by appending the data to the AT command
-    modemAtCmdData_t data;
-    snprintf(data.modem_at_cmd_data, sizeof(data.modem_at_cmd_data) "AT+COMMAND %s", p_data_msg->msg);
+    snprintf(p_data->modem_at_cmd_data, sizeof(p_data->modem_at_cmd_data), "AT+COMMAND %s", p_data_msg->msg);
 
-    // Send the data to the queue
-    xQueueSend(data_to_modem_q, &data, portMAX_DELAY);
+    // Make the command visible to the modem task
+    vQueueCommit(data_to_modem_q);
 
-    // Send a notification to wake the task
-    xTaskNotify(modem_task, TASK_NOTIF_DATA_TO_MODEM, eSetBits);
+    // Send a notification to wake the task, one per command
+    xTaskNotifyGiveIndexed(modem_task, MODEM_NOTIFY_DATA_TO_MODEM);
 }
 
 /* *************************   Private Functions   ************************ */
@@ -131,56 +169,71 @@ static void modemTask(void *pvParameters)
     // Initialize the Modem
     modemHardwareInit();
 
-    uint32_t notify_value = 0;
-    modemAtCmdData_t msg;
+    modemAtCmdData_t *p_msg = NULL;
     for(;;)
     {
-        // Wait forever for a notification and return to wait state after processing data
-        xTaskNotifyWait(0, UINT32_MAX, &notify_value, portMAX_DELAY);
-
-        if((notify_value & TASK_NOTIF_DATA_FROM_MODEM) != 0)
+        // Wait forever for either notification and return to wait state after processing data. If
+        // data from the modem arrived since the channel was last emptied, don't wait.
+        bool modem_idle = spscChannelPrepareToWait(&data_from_modem_channel);
+        UBaseType_t pending = uxTaskNotifyWaitAny(MODEM_NOTIFY_BIT(MODEM_NOTIFY_DATA_FROM_MODEM) |
+                                                  MODEM_NOTIFY_BIT(MODEM_NOTIFY_DATA_TO_MODEM),
+                                                  modem_idle ? portMAX_DELAY : 0);
+
+        if((pending & MODEM_NOTIFY_BIT(MODEM_NOTIFY_DATA_FROM_MODEM)) != 0)
         {
-            while(xQueueReceive(data_from_modem_q, &msg, 0) == pdTRUE)
-            {
-                // Determine if the AT command coming from the modem is DATA or is a STATUS message
-                modemAtMsgType_t type = modemDetermineMsgType(&msg);
+            ulTaskNotifyTakeIndexed(MODEM_NOTIFY_DATA_FROM_MODEM, pdTRUE, 0);
+        }
 
-                switch (type)
-                {
+        // The channel only notifies the task when it is about to block, so always check it. Messages
+        // are parsed in place in the channel storage, the slot is freed once done.
+        while((p_msg = spscChannelReadSlot(&data_from_modem_channel)) != NULL)
+        {
+            // Determine if the AT command coming from the modem is DATA or is a STATUS message
+            modemAtMsgType_t type = modemDetermineMsgType(p_msg);
+            traceRecStage(at_msg_parsed_stage, (uint16_t)type);
 
-                // If STATUS, handle internally
-                case E_MSGTYPE_STATUS_MSG:
-                    // TODO: Call status message handler to handle the status message
+            switch (type)
+            {
 
-                    break;
+            // If STATUS, handle internally
+            case E_MSGTYPE_STATUS_MSG:
+                // TODO: Call status message handler to handle the status message
 
-                // If Command Response, send to message handler
-                case E_MSGTYPE_COMMAND_RESPONSE:
-                    {
-                        // Create a message for the message handler
-                        msgData_t data_message;
+                break;
 
-                        // Copy the data into the message
-                        modemBuildDataMessageFromAtData(msg.modem_at_cmd_data, &data_message);
+            // If Command Response, send to message handler
+            case E_MSGTYPE_COMMAND_RESPONSE:
+                {
+                    // Create a message for the message handler
+                    msgData_t data_message;
 
-                        // Return a response to the message handler
-                        msgHandlerModemMsg(&data_message);
-                    }
-                    break;
+                    // Copy the data into the message
+                    modemBuildDataMessageFromAtData(p_msg->modem_at_cmd_data, &data_message);
 
-                default:
-                    // An AT string was received of unknown type
-                    break;
+                    // Return a response to the message handler
+                    msgHandlerModemMsg(&data_message);
                 }
+                break;
+
+            default:
+                // An AT string was received of unknown type
+                break;
             }
+
+            spscChannelConsume(&data_from_modem_channel);
         }
 
-        if((notify_value & TASK_NOTIF_DATA_TO_MODEM) != 0)
+        if((pending & MODEM_NOTIFY_BIT(MODEM_NOTIFY_DATA_TO_MODEM)) != 0)
         {
-            while(xQueueReceive(data_to_modem_q, &msg, 0) == pdTRUE)
+            // The count is taken before the queue is emptied, so a command committed meanwhile is
+            // either sent now or leaves the notification pending, never neither
+            ulTaskNotifyTakeIndexed(MODEM_NOTIFY_DATA_TO_MODEM, pdTRUE, 0);
+            while(xQueueAcquire(data_to_modem_q, (void **)&p_msg, 0) == pdTRUE)
             {
                 // Data received from external source, send to modem
-                UART_Send(UART_3, msg.modem_at_cmd_data);
+                UART_Send(UART_3, p_msg->modem_at_cmd_data);
+                traceRecStage(at_cmd_sent_stage, (uint16_t)strlen(p_msg->modem_at_cmd_data));
+                vQueueRelease(data_to_modem_q);
             }
         }
     }
@@ -236,27 +289,54 @@ static void modemHardwareInit(void)
 
 
 // An abstraction of a UART receive interrupt
+// The message is written straight into the channel's write slot as it arrives, so a complete
+// message only has to be published rather than copied
 static void UART3_Receive(void)
 {
-    static modemAtCmdData_t data;
     static int current_pos = 0;
-x
+    static bool discarding = false;
+    uint8_t incoming_byte;
+    uint32_t isr_start = rtStatsIsrEnter(uart_isr_stats);
+
     // Read data from UART and store to buffer
     UART_Read(UART3, &incoming_byte);
-    data.modem_at_cmd_data[current_pos++] = incoming_byte;
+
+    // Once a byte of a message has been lost the rest of it is thrown away, up to and including its
+    // '\n', rather than handing on a truncated message
+    if(discarding)
+    {
+        discarding = (incoming_byte != '\n');
+        rtStatsIsrExit(uart_isr_stats, isr_start);
+        return;
+    }
+
+    // A byte is lost if the channel is full or the message has outgrown the slot, the slot needs
+    // room for the terminator
+    modemAtCmdData_t *p_data = spscChannelWriteSlot(&data_from_modem_channel);
+    if((p_data == NULL) || (current_pos >= (MODEM_AT_CMD_MAX_SIZE - 1)))
+    {
+        spscChannelDropFromISR(&data_from_modem_channel);
+        current_pos = 0;
+        discarding = (incoming_byte != '\n');
+        rtStatsIsrExit(uart_isr_stats, isr_start);
+        return;
+    }
+
+    p_data->modem_at_cmd_data[current_pos++] = incoming_byte;
 
     // Check to see if the message is complete by checking for a '\n'
     if(incoming_byte == '\n')
     {
-        // Message is complete, send to task for processing
-        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-        xQueueSendFromISR(data_from_modem_q, &data, &xHigherPriorityTaskWoken);
+        p_data->modem_at_cmd_data[current_pos] = '\0';
 
-        // Notify the task that data has been sent to queue
-        xTaskNotifyFromISR(modem_task, TASK_NOTIF_DATA_FROM_MODEM, eSetBits, &xHigherPriorityTaskWoken);
+        // Message is complete, hand it to the task, which is notified if it is waiting for it
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        spscChannelPublishFromISR(&data_from_modem_channel, &xHigherPriorityTaskWoken);
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 
         // Reset position of buffer
         current_pos = 0;
     }
+
+    rtStatsIsrExit(uart_isr_stats, isr_start);
 }
@@ -0,0 +1,400 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  nvm_data.c
+//
+//  NVM Data Manager
+//
+//  Module description in nvm_data.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// FreeRTOS Includes
+
+// Library Includes
+
+// Project Includes
+#include "crc.h"
+#include "eeprom.h"
+
+// Module Includes
+#include "nvm_data.h"
+
+/* ***************************   Definitions   **************************** */
+
+// Checkpoint region is at the start of the EEPROM, two slots written alternately so a power loss
+// during a checkpoint write always leaves the previous one intact
+#define NVM_CHECKPOINT_SLOT_SIZE        EEPROM_PAGE_SIZE
+#define NVM_CHECKPOINT_NUM_SLOTS        2
+#define NVM_CHECKPOINT_REGION_ADDR      0
+#define NVM_CHECKPOINT_MAGIC            0x4E564D43  // "NVMC"
+
+// Log region fills the rest of the EEPROM
+#define NVM_LOG_SLOT_SIZE               32
+#define NVM_LOG_REGION_ADDR             (NVM_CHECKPOINT_REGION_ADDR + \
+                                         (NVM_CHECKPOINT_SLOT_SIZE * NVM_CHECKPOINT_NUM_SLOTS))
+#define NVM_LOG_NUM_SLOTS               ((EEPROM_SIZE_BYTES - NVM_LOG_REGION_ADDR) / NVM_LOG_SLOT_SIZE)
+
+// Index value for a record ID that has never been written
+#define NVM_SLOT_NONE                   0xFFFF
+
+// Sequence numbers of an erased part (all 0xFF) and zero are never issued
+#define NVM_SEQ_INVALID                 0xFFFFFFFF
+#define NVM_SEQ_FIRST                   1
+
+/* ****************************   Structures   **************************** */
+
+// A single record in the log, sized to exactly one log slot
+typedef struct
+{
+    uint32_t seq;                                   // Monotonic write sequence number
+    uint8_t record_id;
+    uint8_t num_bytes;
+    uint16_t crc;                                   // CRC-16 of every field above and the data
+    uint8_t data[NVM_DATA_RECORD_MAX_SIZE];
+}nvmLogRecord_t;
+
+// A snapshot of the RAM index
+typedef struct
+{
+    uint32_t magic;
+    uint32_t checkpoint_seq;                        // Picks the newer of the two checkpoint slots
+    uint32_t next_record_seq;                       // Sequence of the first record not in the index
+    uint16_t head_slot;                             // Slot where next_record_seq will be written
+    uint16_t index[NVM_DATA_MAX_RECORD_IDS];
+    uint16_t crc;                                   // CRC-16 of every field above
+}nvmCheckpoint_t;
+
+_Static_assert(sizeof(nvmLogRecord_t) == NVM_LOG_SLOT_SIZE, "Log record must fill one slot");
+_Static_assert(sizeof(nvmCheckpoint_t) <= NVM_CHECKPOINT_SLOT_SIZE, "Checkpoint too large for slot");
+_Static_assert(NVM_LOG_NUM_SLOTS < NVM_SLOT_NONE, "Log slot numbers must fit the index");
+_Static_assert(NVM_LOG_NUM_SLOTS > NVM_DATA_MAX_RECORD_IDS, "Log must hold every record ID");
+
+/* ***********************   Function Prototypes   ************************ */
+
+static bool nvmRebuildFromCheckpoint(void);
+static void nvmRebuildFromFullScan(void);
+static bool nvmReadCheckpoint(const unsigned int ckpt_slot, nvmCheckpoint_t *p_ckpt);
+static bool nvmWriteCheckpoint(void);
+static bool nvmReadLogSlot(const uint16_t slot, nvmLogRecord_t *p_record);
+static bool nvmAppendRecord(nvmLogRecord_t *p_record);
+static bool nvmReclaimHeadSlot(const uint8_t record_id);
+
+/* ***********************   File Scope Variables   *********************** */
+
+// Slot holding the newest copy of each record ID
+static uint16_t record_index[NVM_DATA_MAX_RECORD_IDS];
+
+// Next slot to be written and the sequence number it will be given
+static uint16_t head_slot = 0;
+static uint32_t next_record_seq = NVM_SEQ_FIRST;
+
+static uint32_t checkpoint_seq = 0;
+static unsigned int writes_since_checkpoint = 0;
+
+static nvmDataBootStats_t boot_stats;
+
+/* *************************   Public  Functions   ************************ */
+
+// Rebuilds the record index from the EEPROM, must be called after eepromInit()
+void nvmDataInit(void)
+{
+    memset(&boot_stats, 0, sizeof(boot_stats));
+
+    // Normal boot only replays the log written after the last checkpoint. Without a valid
+    // checkpoint (first boot or both slots corrupt) every slot has to be read.
+    if(!nvmRebuildFromCheckpoint())
+    {
+        nvmRebuildFromFullScan();
+    }
+
+    // Checkpoint the rebuilt index so the next boot does not replay the same records again
+    if((!boot_stats.checkpoint_used) || (writes_since_checkpoint != 0))
+    {
+        nvmWriteCheckpoint();
+    }
+}
+
+// Writes a new copy of a record, superseding any previous copy
+bool nvmDataWriteRecord(const uint8_t record_id, const uint8_t *p_data, const unsigned int num_bytes)
+{
+    if((record_id >= NVM_DATA_MAX_RECORD_IDS) || (num_bytes > NVM_DATA_RECORD_MAX_SIZE))
+    {
+        return false;
+    }
+
+    // Appending always lands on a fresh slot, so the driver can't spot a rewrite of the same
+    // value. Compare against the newest copy here and skip the write cycle entirely.
+    nvmLogRecord_t record;
+    if((record_index[record_id] != NVM_SLOT_NONE) &&
+       nvmReadLogSlot(record_index[record_id], &record) && (record.record_id == record_id) &&
+       (record.num_bytes == num_bytes) && (memcmp(record.data, p_data, num_bytes) == 0))
+    {
+        return true;
+    }
+
+    memset(&record, 0xFF, sizeof(record));
+    record.record_id = record_id;
+    record.num_bytes = (uint8_t)num_bytes;
+    memcpy(record.data, p_data, num_bytes);
+
+    // Make sure appending does not overwrite the only copy of some other record
+    if(!nvmReclaimHeadSlot(record_id))
+    {
+        return false;
+    }
+
+    return nvmAppendRecord(&record);
+}
+
+// Reads the newest copy of a record
+bool nvmDataReadRecord(const uint8_t record_id, uint8_t *p_data, const unsigned int max_bytes,
+                       unsigned int *p_num_bytes)
+{
+    if((record_id >= NVM_DATA_MAX_RECORD_IDS) || (record_index[record_id] == NVM_SLOT_NONE))
+    {
+        return false;
+    }
+
+    nvmLogRecord_t record;
+    if(!nvmReadLogSlot(record_index[record_id], &record) || (record.record_id != record_id))
+    {
+        return false;
+    }
+
+    unsigned int num_bytes = (record.num_bytes < max_bytes) ? record.num_bytes : max_bytes;
+    memcpy(p_data, record.data, num_bytes);
+    *p_num_bytes = num_bytes;
+
+    return true;
+}
+
+// Returns how much of the EEPROM had to be read to rebuild the index at boot. Every log slot
+// scanned is one EEPROM read, so this is the cost nvmDataInit() adds before the scheduler starts.
+void nvmDataGetBootStats(nvmDataBootStats_t *p_stats)
+{
+    *p_stats = boot_stats;
+}
+
+/* *************************   Private Functions   ************************ */
+
+// Loads the newest valid checkpoint and replays the log written after it
+static bool nvmRebuildFromCheckpoint(void)
+{
+    nvmCheckpoint_t ckpt;
+    nvmCheckpoint_t newest = {0};
+    bool found = false;
+
+    for(unsigned int idx = 0; idx < NVM_CHECKPOINT_NUM_SLOTS; idx++)
+    {
+        if(nvmReadCheckpoint(idx, &ckpt) && ((!found) || (ckpt.checkpoint_seq > newest.checkpoint_seq)))
+        {
+            newest = ckpt;
+            found = true;
+        }
+    }
+
+    if(!found)
+    {
+        return false;
+    }
+
+    memcpy(record_index, newest.index, sizeof(record_index));
+    head_slot = newest.head_slot;
+    next_record_seq = newest.next_record_seq;
+    checkpoint_seq = newest.checkpoint_seq;
+    boot_stats.checkpoint_used = true;
+
+    // Records are written in slot order, so the tail is every slot from the checkpointed head
+    // that holds the next expected sequence number. The first slot that does not is older data.
+    nvmLogRecord_t record;
+    for(unsigned int count = 0; count < NVM_LOG_NUM_SLOTS; count++)
+    {
+        boot_stats.slots_scanned++;
+        if(!nvmReadLogSlot(head_slot, &record) || (record.seq != next_record_seq))
+        {
+            break;
+        }
+
+        record_index[record.record_id] = head_slot;
+        head_slot = (head_slot + 1) % NVM_LOG_NUM_SLOTS;
+        next_record_seq++;
+        writes_since_checkpoint++;
+    }
+
+    return true;
+}
+
+// Rebuilds the index by reading every slot in the log, keeping the newest copy of each record
+static void nvmRebuildFromFullScan(void)
+{
+    uint32_t index_seq[NVM_DATA_MAX_RECORD_IDS];
+    uint32_t newest_seq = 0;
+
+    memset(record_index, 0xFF, sizeof(record_index));
+    memset(index_seq, 0, sizeof(index_seq));
+    head_slot = 0;
+    next_record_seq = NVM_SEQ_FIRST;
+
+    nvmLogRecord_t record;
+    for(uint16_t slot = 0; slot < NVM_LOG_NUM_SLOTS; slot++)
+    {
+        boot_stats.slots_scanned++;
+        if(!nvmReadLogSlot(slot, &record))
+        {
+            continue;
+        }
+
+        if(record.seq > index_seq[record.record_id])
+        {
+            index_seq[record.record_id] = record.seq;
+            record_index[record.record_id] = slot;
+        }
+
+        // The slot after the newest record is the oldest, which is where writing continues
+        if(record.seq > newest_seq)
+        {
+            newest_seq = record.seq;
+            head_slot = (slot + 1) % NVM_LOG_NUM_SLOTS;
+            next_record_seq = record.seq + 1;
+        }
+    }
+}
+
+// Reads and validates one of the checkpoint slots
+static bool nvmReadCheckpoint(const unsigned int ckpt_slot, nvmCheckpoint_t *p_ckpt)
+{
+    uint32_t addr = NVM_CHECKPOINT_REGION_ADDR + (ckpt_slot * NVM_CHECKPOINT_SLOT_SIZE);
+    if(!eepromReadBytes(addr, (uint8_t *)p_ckpt, sizeof(*p_ckpt)))
+    {
+        return false;
+    }
+
+    return (p_ckpt->magic == NVM_CHECKPOINT_MAGIC) &&
+           (p_ckpt->crc == crc16Calc((uint8_t *)p_ckpt, offsetof(nvmCheckpoint_t, crc))) &&
+           (p_ckpt->head_slot < NVM_LOG_NUM_SLOTS);
+}
+
+// Writes the RAM index into the older of the two checkpoint slots
+static bool nvmWriteCheckpoint(void)
+{
+    nvmCheckpoint_t ckpt;
+    memset(&ckpt, 0xFF, sizeof(ckpt));
+
+    ckpt.magic = NVM_CHECKPOINT_MAGIC;
+    ckpt.checkpoint_seq = checkpoint_seq + 1;
+    ckpt.next_record_seq = next_record_seq;
+    ckpt.head_slot = head_slot;
+    memcpy(ckpt.index, record_index, sizeof(ckpt.index));
+    ckpt.crc = crc16Calc((uint8_t *)&ckpt, offsetof(nvmCheckpoint_t, crc));
+
+    uint32_t addr = NVM_CHECKPOINT_REGION_ADDR +
+                    ((ckpt.checkpoint_seq % NVM_CHECKPOINT_NUM_SLOTS) * NVM_CHECKPOINT_SLOT_SIZE);
+    if(!eepromWriteBytes(addr, (uint8_t *)&ckpt, sizeof(ckpt)))
+    {
+        return false;
+    }
+
+    checkpoint_seq = ckpt.checkpoint_seq;
+    writes_since_checkpoint = 0;
+    return true;
+}
+
+// Reads and validates the record in a log slot
+static bool nvmReadLogSlot(const uint16_t slot, nvmLogRecord_t *p_record)
+{
+    uint32_t addr = NVM_LOG_REGION_ADDR + ((uint32_t)slot * NVM_LOG_SLOT_SIZE);
+    if(!eepromReadBytes(addr, (uint8_t *)p_record, sizeof(*p_record)))
+    {
+        return false;
+    }
+
+    // CRC was calculated with its own field zeroed
+    uint16_t stored_crc = p_record->crc;
+    p_record->crc = 0;
+    bool crc_ok = (stored_crc == crc16Calc((uint8_t *)p_record, sizeof(*p_record)));
+    p_record->crc = stored_crc;
+
+    return crc_ok && (p_record->seq != NVM_SEQ_INVALID) && (p_record->seq >= NVM_SEQ_FIRST) &&
+           (p_record->record_id < NVM_DATA_MAX_RECORD_IDS) &&
+           (p_record->num_bytes <= NVM_DATA_RECORD_MAX_SIZE);
+}
+
+// Writes a record at the head of the log and updates the index
+static bool nvmAppendRecord(nvmLogRecord_t *p_record)
+{
+    p_record->seq = next_record_seq;
+    p_record->crc = 0;
+    p_record->crc = crc16Calc((uint8_t *)p_record, sizeof(*p_record));
+
+    uint32_t addr = NVM_LOG_REGION_ADDR + ((uint32_t)head_slot * NVM_LOG_SLOT_SIZE);
+    if(!eepromWriteBytes(addr, (uint8_t *)p_record, sizeof(*p_record)))
+    {
+        return false;
+    }
+
+    record_index[p_record->record_id] = head_slot;
+    head_slot = (head_slot + 1) % NVM_LOG_NUM_SLOTS;
+    next_record_seq++;
+
+    if(++writes_since_checkpoint >= NVM_DATA_CHECKPOINT_INTERVAL)
+    {
+        nvmWriteCheckpoint();
+    }
+
+    return true;
+}
+
+// The head slot holds the oldest record in the log. If that is still the newest copy of some
+// record it is copied forward first, which is bounded by the number of record IDs.
+static bool nvmReclaimHeadSlot(const uint8_t record_id)
+{
+    nvmLogRecord_t record;
+    for(unsigned int count = 0; count < NVM_DATA_MAX_RECORD_IDS; count++)
+    {
+        if(!nvmReadLogSlot(head_slot, &record) ||
+           (record_index[record.record_id] != head_slot) ||
+           (record.record_id == record_id))
+        {
+            // Slot is empty, stale, or about to be superseded anyway
+            return true;
+        }
+
+        if(!nvmAppendRecord(&record))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
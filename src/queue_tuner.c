@@ -0,0 +1,403 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  queue_tuner.c
+//
+//  Queue Depth Tuner
+//
+//  Module description in queue_tuner.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+// Library Includes
+
+// Project Includes
+#include "nvm_data.h"
+#include "spsc_channel.h"
+
+// Module Includes
+#include "queue_tuner.h"
+
+/* ***************************   Definitions   **************************** */
+
+// Sizes are saved as 8 and 16 bit values to fit a single record
+#define QUEUE_TUNER_MAX_ITEMS           UINT8_MAX
+#define QUEUE_TUNER_MAX_ITEM_BYTES      UINT16_MAX
+
+_Static_assert(QUEUE_TUNER_BUDGET_BYTES <= UINT16_MAX, "Queue tuner budget does not fit the record");
+
+#define QUEUE_TUNER_ARENA_BYTES         (QUEUE_TUNER_BUDGET_BYTES + QUEUE_TUNER_ARENA_SPARE_BYTES)
+
+// Every block handed out keeps the kernel's alignment
+#define QUEUE_TUNER_ALIGN(num_bytes)    (((num_bytes) + (portBYTE_ALIGNMENT - 1)) & ~(uint32_t)(portBYTE_ALIGNMENT - 1))
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    const char *p_name;
+    uint32_t item_bytes;
+    uint32_t min_items;
+    uint32_t num_items;             // Items the queue was created with
+    uint32_t target_items;          // Items the queue will be created with on the next boot
+    queueTunerUsageFn_t usage_fn;
+    void *p_context;
+    uint32_t peak_items;            // Highest high-water mark sampled since boot
+    uint32_t num_full;              // Times the queue was found full since boot
+    uint32_t last_num_full;         // Count as last sampled, to take the new ones from
+}queueTunerQueue_t;
+
+// Sizing saved to the EEPROM, a queue only uses it if the budget and its item size are unchanged
+typedef struct
+{
+    uint16_t budget_bytes;
+    uint16_t item_bytes[QUEUE_TUNER_MAX_QUEUES];
+    uint8_t num_items[QUEUE_TUNER_MAX_QUEUES];
+}queueTunerRecord_t;
+
+_Static_assert(sizeof(queueTunerRecord_t) <= NVM_DATA_RECORD_MAX_SIZE, "Queue tuner record is too large");
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void queueTunerSample(queueTunerQueue_t *p_queue);
+static void queueTunerAddUsage(queueTunerQueue_t *p_queue, const queueTunerUsage_t *p_usage);
+#if QUEUE_TUNER_LEARN
+static void queueTunerSave(void);
+static void queueTunerTimerCallback(TimerHandle_t timer);
+#endif
+
+/* ***********************   File Scope Variables   *********************** */
+
+static queueTunerQueue_t queues[QUEUE_TUNER_MAX_QUEUES];
+static int num_queues = 0;
+
+// Bytes of the budget given to the queues as they were created
+static uint32_t budget_used = 0;
+
+// Storage for the queues, sized at build time and handed out as they are created
+static uint8_t arena[QUEUE_TUNER_ARENA_BYTES] __attribute__((aligned(portBYTE_ALIGNMENT)));
+static uint32_t arena_used = 0;
+
+// Sizing as last read from or written to the EEPROM
+static queueTunerRecord_t saved_record;
+static bool saved_valid = false;
+
+static uint32_t num_samples = 0;
+
+static TaskHandle_t notify_task = NULL;
+static UBaseType_t notify_task_index = 0;
+
+// Set by the timer each period, cleared by the update it asks for
+static atomic_bool update_due;
+
+#if QUEUE_TUNER_LEARN
+static StaticTimer_t update_timer_buffer;
+#endif
+
+#if (configUSE_QUEUE_STATS == 1)
+// Kept off the stack of the task doing the update
+static QueueStats_t queue_stats;
+#endif
+
+/* *************************   Public  Functions   ************************ */
+
+// Reads back the sizing learned on previous runs, must be called after nvmDataInit() and before
+// any queue is registered
+void queueTunerInit(void)
+{
+    unsigned int num_bytes = 0;
+
+    memset(&saved_record, 0, sizeof(saved_record));
+    saved_valid = nvmDataReadRecord(NVM_DATA_RECORD_ID_QUEUE_TUNER, (uint8_t *)&saved_record,
+                                    sizeof(saved_record), &num_bytes) &&
+                  (num_bytes == sizeof(saved_record)) &&
+                  (saved_record.budget_bytes == QUEUE_TUNER_BUDGET_BYTES);
+}
+
+// Adds a queue to the budget and returns the number of items to create it with. Queues must be
+// registered in the same order on every boot, before the scheduler is started. Once the table is
+// full further queues are left at their default size.
+uint32_t queueTunerRegister(const char *p_name, const uint32_t item_bytes, const uint32_t min_items,
+                            const uint32_t default_items, queueTunerUsageFn_t usage_fn, void *p_context)
+{
+    assert((min_items > 0) && (min_items <= default_items) && (default_items <= QUEUE_TUNER_MAX_ITEMS));
+    assert((item_bytes > 0) && (item_bytes <= QUEUE_TUNER_MAX_ITEM_BYTES));
+
+    if(num_queues >= QUEUE_TUNER_MAX_QUEUES)
+    {
+        return default_items;
+    }
+
+    uint32_t num_items = default_items;
+
+#if QUEUE_TUNER_LEARN
+    if(saved_valid && (saved_record.item_bytes[num_queues] == item_bytes) &&
+       (saved_record.num_items[num_queues] >= min_items))
+    {
+        num_items = saved_record.num_items[num_queues];
+    }
+#endif
+
+    // Sizing learned alongside a different set of queues may not leave this one enough
+    uint32_t budget_left = QUEUE_TUNER_BUDGET_BYTES - budget_used;
+    if((num_items * item_bytes) > budget_left)
+    {
+        num_items = budget_left / item_bytes;
+    }
+    if(num_items < min_items)
+    {
+        num_items = min_items;
+    }
+
+    // The budget must at least cover every queue at its minimum size
+    assert((num_items * item_bytes) <= budget_left);
+
+    queueTunerQueue_t *p_queue = &queues[num_queues];
+    memset(p_queue, 0, sizeof(*p_queue));
+    p_queue->p_name = p_name;
+    p_queue->item_bytes = item_bytes;
+    p_queue->min_items = min_items;
+    p_queue->num_items = num_items;
+    p_queue->target_items = num_items;
+    p_queue->usage_fn = usage_fn;
+    p_queue->p_context = p_context;
+
+    budget_used += num_items * item_bytes;
+    num_queues++;
+
+    return num_items;
+}
+
+// Takes storage for a registered queue from the arena. Nothing is ever given back, queues live for
+// as long as the application does.
+void *queueTunerAlloc(const uint32_t num_bytes)
+{
+    uint32_t block_bytes = QUEUE_TUNER_ALIGN(num_bytes);
+
+    // The spare bytes are too few for what the queues need beyond the budget
+    assert(block_bytes <= (QUEUE_TUNER_ARENA_BYTES - arena_used));
+
+    void *p_block = &arena[arena_used];
+    arena_used += block_bytes;
+    return p_block;
+}
+
+// Starts sampling the queues, the task's indexed notification is given each period and it must
+// then call queueTunerUpdate()
+void queueTunerStart(TaskHandle_t update_task, const UBaseType_t notify_index)
+{
+    notify_task = update_task;
+    notify_task_index = notify_index;
+
+#if QUEUE_TUNER_LEARN
+    TimerHandle_t timer = xTimerCreateStatic("Q Tuner", pdMS_TO_TICKS(QUEUE_TUNER_PERIOD_MS), pdTRUE, NULL,
+                                             queueTunerTimerCallback, &update_timer_buffer);
+    assert(timer != NULL);
+    xTimerStart(timer, 0);
+#endif
+}
+
+// Samples every queue and works out the sizing for the next boot, saving it if it changed. Called
+// from the task given to queueTunerStart() rather than the timer, as it may write to the EEPROM.
+// Does nothing unless a period has ended since it last ran, so a task that shares the notification
+// with other events can call it whenever it wakes.
+void queueTunerUpdate(void)
+{
+    if(!atomic_exchange_explicit(&update_due, false, memory_order_relaxed))
+    {
+        return;
+    }
+
+    for(int idx = 0; idx < num_queues; idx++)
+    {
+        queueTunerSample(&queues[idx]);
+    }
+    num_samples++;
+
+    // Every queue starts from the size it has now, a queue that never filled up gives an item back
+    // once it has had time to show it doesn't need it
+    uint32_t total_bytes = 0;
+    for(int idx = 0; idx < num_queues; idx++)
+    {
+        queueTunerQueue_t *p_queue = &queues[idx];
+        p_queue->target_items = p_queue->num_items;
+
+        if((p_queue->num_full == 0) && (num_samples >= QUEUE_TUNER_SETTLE_SAMPLES) &&
+           ((p_queue->peak_items + QUEUE_TUNER_SPARE_ITEMS) < p_queue->num_items) &&
+           (p_queue->num_items > p_queue->min_items))
+        {
+            p_queue->target_items--;
+        }
+
+        total_bytes += p_queue->target_items * p_queue->item_bytes;
+    }
+
+    // A queue that filled up gets another item if it fits, the ones that filled up most often first
+    for(;;)
+    {
+        queueTunerQueue_t *p_grow = NULL;
+        for(int idx = 0; idx < num_queues; idx++)
+        {
+            queueTunerQueue_t *p_queue = &queues[idx];
+            if((p_queue->num_full > 0) && (p_queue->target_items == p_queue->num_items) &&
+               (p_queue->target_items < QUEUE_TUNER_MAX_ITEMS) &&
+               ((total_bytes + p_queue->item_bytes) <= QUEUE_TUNER_BUDGET_BYTES) &&
+               ((p_grow == NULL) || (p_queue->num_full > p_grow->num_full)))
+            {
+                p_grow = p_queue;
+            }
+        }
+
+        if(p_grow == NULL)
+        {
+            break;
+        }
+
+        p_grow->target_items++;
+        total_bytes += p_grow->item_bytes;
+    }
+
+#if QUEUE_TUNER_LEARN
+    queueTunerSave();
+#endif
+}
+
+void queueTunerChannelUsage(void *p_context, queueTunerUsage_t *p_usage)
+{
+    const spscChannel_t *p_chan = (const spscChannel_t *)p_context;
+
+    p_usage->peak_items = p_chan->peak_items;
+    p_usage->num_full = p_chan->num_dropped;
+}
+
+#if (configUSE_QUEUE_STATS == 1)
+// A task that had to block counts as finding the queue full, whether or not it then got in
+void queueTunerQueueUsage(void *p_context, queueTunerUsage_t *p_usage)
+{
+    vQueueGetStats(*(QueueHandle_t *)p_context, &queue_stats, pdFALSE);
+
+    p_usage->peak_items = queue_stats.uxPeakMessagesWaiting;
+    p_usage->num_full = queue_stats.ulSendWaits + queue_stats.ulSendFailed + queue_stats.ulSendFailedFromISR;
+}
+
+// Takes the last sample of a kernel queue from the statistics it had as they were reset, so nothing
+// found full since the previous sample is lost and the next sample counts from zero. Must be called
+// from the task given to queueTunerStart().
+void queueTunerQueueStatsReset(QueueHandle_t queue, const QueueStats_t *p_stats)
+{
+    for(int idx = 0; idx < num_queues; idx++)
+    {
+        queueTunerQueue_t *p_queue = &queues[idx];
+        if((p_queue->usage_fn == queueTunerQueueUsage) && (*(QueueHandle_t *)p_queue->p_context == queue))
+        {
+            queueTunerUsage_t usage;
+            usage.peak_items = p_stats->uxPeakMessagesWaiting;
+            usage.num_full = p_stats->ulSendWaits + p_stats->ulSendFailed + p_stats->ulSendFailedFromISR;
+
+            queueTunerAddUsage(p_queue, &usage);
+            p_queue->last_num_full = 0;
+        }
+    }
+}
+#endif
+
+/* *************************   Private Functions   ************************ */
+
+static void queueTunerSample(queueTunerQueue_t *p_queue)
+{
+    queueTunerUsage_t usage;
+    p_queue->usage_fn(p_queue->p_context, &usage);
+
+    queueTunerAddUsage(p_queue, &usage);
+}
+
+static void queueTunerAddUsage(queueTunerQueue_t *p_queue, const queueTunerUsage_t *p_usage)
+{
+    if(p_usage->peak_items > p_queue->peak_items)
+    {
+        p_queue->peak_items = p_usage->peak_items;
+    }
+
+    // A count lower than last time has been reset since, so all of it is new. A reset the tuner
+    // isn't told about can still lose what was counted before it.
+    if(p_usage->num_full >= p_queue->last_num_full)
+    {
+        p_queue->num_full += p_usage->num_full - p_queue->last_num_full;
+    }
+    else
+    {
+        p_queue->num_full += p_usage->num_full;
+    }
+    p_queue->last_num_full = p_usage->num_full;
+}
+
+#if QUEUE_TUNER_LEARN
+// Writes the sizing for the next boot, only when it differs from what is already saved
+static void queueTunerSave(void)
+{
+    queueTunerRecord_t record;
+    memset(&record, 0, sizeof(record));
+
+    record.budget_bytes = QUEUE_TUNER_BUDGET_BYTES;
+    for(int idx = 0; idx < num_queues; idx++)
+    {
+        record.item_bytes[idx] = (uint16_t)queues[idx].item_bytes;
+        record.num_items[idx] = (uint8_t)queues[idx].target_items;
+    }
+
+    if(saved_valid && (memcmp(&record, &saved_record, sizeof(record)) == 0))
+    {
+        return;
+    }
+
+    if(nvmDataWriteRecord(NVM_DATA_RECORD_ID_QUEUE_TUNER, (const uint8_t *)&record, sizeof(record)))
+    {
+        saved_record = record;
+        saved_valid = true;
+    }
+}
+
+static void queueTunerTimerCallback(TimerHandle_t timer)
+{
+    (void)timer;
+    atomic_store_explicit(&update_due, true, memory_order_relaxed);
+    xTaskNotifyGiveIndexed(notify_task, notify_task_index);
+}
+#endif
@@ -0,0 +1,454 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  run_time_stats.c
+//
+//  Run Time Stats
+//
+//  Module description in run_time_stats.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#if !defined(__arm__)
+#include <time.h>
+#endif
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "queue.h"
+#include "semphr.h"
+
+// Library Includes
+
+// Project Includes
+#include "trace_recorder.h"
+#include "queue_tuner.h"
+
+// Module Includes
+#include "run_time_stats.h"
+
+/* ***************************   Definitions   **************************** */
+
+#if defined(__arm__)
+// Cortex-M debug and trace registers, the cycle counter only runs once trace is enabled
+#define RT_STATS_DEMCR                  (*(volatile uint32_t *)0xE000EDFCUL)
+#define RT_STATS_DEMCR_TRCENA           (1UL << 24)
+#define RT_STATS_DWT_CTRL               (*(volatile uint32_t *)0xE0001000UL)
+#define RT_STATS_DWT_CTRL_CYCCNTENA     (1UL << 0)
+#define RT_STATS_DWT_CYCCNT             (*(volatile uint32_t *)0xE0001004UL)
+
+#define RT_STATS_READ_COUNTER()         (RT_STATS_DWT_CYCCNT)
+#else
+// Host builds count nanoseconds of the monotonic clock, which is already 64 bits wide
+#define RT_STATS_READ_COUNTER()         ((uint32_t)rtStatsHostClock())
+#endif
+
+// The 32 bit cycle counter is sampled at least this often so every wrap is seen. It wraps every
+// 35 seconds at 120MHz. Switching to the timer task also keeps the gaps between trace events
+// shorter than a wrap.
+#define RT_STATS_EXTEND_PERIOD_MS       10000
+
+// Longest report line is a queue's, name, depth, items sent and the send failures
+#define RT_STATS_LINE_SIZE              56
+
+/* ****************************   Structures   **************************** */
+
+// A task's counters at the time of the previous report
+typedef struct
+{
+    UBaseType_t task_number;
+    uint64_t run_time;
+    uint32_t switch_count;
+}rtStatsTaskSnapshot_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void rtStatsExtendCallback(TimerHandle_t timer);
+static const rtStatsTaskSnapshot_t *rtStatsFindSnapshot(const UBaseType_t task_number);
+static uint32_t rtStatsPerMille(const uint64_t part, const uint64_t whole);
+static uint32_t rtStatsCountsToUs(const uint64_t counts);
+#if !defined(__arm__)
+static uint64_t rtStatsHostClock(void);
+#endif
+
+/* ***********************   File Scope Variables   *********************** */
+
+#if defined(__arm__)
+// Upper 32 bits of the cycle counter and its value when last sampled
+static uint32_t counter_high = 0;
+static uint32_t counter_last = 0;
+#else
+// Monotonic clock reading the counter starts from, like the cycle counter it starts from zero
+static uint64_t host_clock_start = 0;
+#endif
+
+static StaticTimer_t extend_timer_buffer;
+
+// Only written by the interrupt being timed, apart from max_time which each report resets
+static rtStatsIsrStats_t isr_stats[RT_STATS_MAX_ISRS];
+static int num_isrs = 0;
+
+// State of the previous report, each report covers the time since then
+static uint64_t report_time = 0;
+static rtStatsTaskSnapshot_t task_snapshots[RT_STATS_MAX_TASKS];
+static UBaseType_t num_task_snapshots = 0;
+static rtStatsIsrStats_t isr_snapshots[RT_STATS_MAX_ISRS];
+
+// Kept off the stack of the task making the report
+static TaskStatus_t task_status[RT_STATS_MAX_TASKS];
+static QueueStats_t queue_stats;
+static char line[RT_STATS_LINE_SIZE];
+
+/* *************************   Public  Functions   ************************ */
+
+// Sets up sampling of the cycle counter, must be called before the scheduler is started
+void rtStatsInit(void)
+{
+    TimerHandle_t extend_timer = xTimerCreateStatic("RT Stats", pdMS_TO_TICKS(RT_STATS_EXTEND_PERIOD_MS),
+                                                    pdTRUE, NULL, rtStatsExtendCallback, &extend_timer_buffer);
+    assert(extend_timer != NULL);
+    xTimerStart(extend_timer, 0);
+}
+
+// Starts the run time counter, called by the kernel as the scheduler starts
+void rtStatsStartCounter(void)
+{
+#if defined(__arm__)
+    RT_STATS_DEMCR |= RT_STATS_DEMCR_TRCENA;
+    RT_STATS_DWT_CYCCNT = 0;
+    RT_STATS_DWT_CTRL |= RT_STATS_DWT_CTRL_CYCCNTENA;
+#else
+    host_clock_start = rtStatsHostClock();
+#endif
+}
+
+// The run time counter behind the kernel's run time stats. Safe to call from an interrupt.
+uint64_t rtStatsGetCounter(void)
+{
+#if defined(__arm__)
+    UBaseType_t saved_mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    uint32_t now = RT_STATS_READ_COUNTER();
+    if(now < counter_last)
+    {
+        counter_high++;
+    }
+    counter_last = now;
+    uint64_t counter = ((uint64_t)counter_high << 32) | now;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(saved_mask);
+    return counter;
+#else
+    return rtStatsHostClock();
+#endif
+}
+
+// The low 32 bits of the run time counter, wraps. Cheap enough to timestamp every trace event.
+uint32_t rtStatsReadCounter(void)
+{
+    return RT_STATS_READ_COUNTER();
+}
+
+// Counts per second of the run time counter
+uint32_t rtStatsCounterHz(void)
+{
+#if defined(__arm__)
+    return configCPU_CLOCK_HZ;
+#else
+    return 1000000000UL;
+#endif
+}
+
+// Adds an interrupt to be timed, must be called before the scheduler is started
+int rtStatsRegisterIsr(const char *p_name)
+{
+    if(num_isrs >= RT_STATS_MAX_ISRS)
+    {
+        return RT_STATS_ISR_INVALID;
+    }
+
+    rtStatsIsrStats_t *p_isr = &isr_stats[num_isrs];
+    memset(p_isr, 0, sizeof(*p_isr));
+    p_isr->p_name = p_name;
+    traceRecAddSymbol(E_TRACE_CLASS_ISR, (uint8_t)num_isrs, p_name);
+
+    return num_isrs++;
+}
+
+// Called first thing in a timed interrupt, the value returned is handed to rtStatsIsrExit()
+uint32_t rtStatsIsrEnter(const int isr)
+{
+    if((isr >= 0) && (isr < num_isrs))
+    {
+        traceRecEvent(E_TRACE_EVT_ISR_ENTER, (uint8_t)isr, 0);
+    }
+
+    return RT_STATS_READ_COUNTER();
+}
+
+// Called last thing in a timed interrupt. Time spent in a nested, higher priority interrupt is
+// counted against both.
+void rtStatsIsrExit(const int isr, const uint32_t start)
+{
+    if((isr < 0) || (isr >= num_isrs))
+    {
+        return;
+    }
+
+    uint32_t elapsed = RT_STATS_READ_COUNTER() - start;
+    traceRecEvent(E_TRACE_EVT_ISR_EXIT, (uint8_t)isr, 0);
+
+    rtStatsIsrStats_t *p_isr = &isr_stats[isr];
+    p_isr->num_calls++;
+    p_isr->total_time += elapsed;
+    if(elapsed > p_isr->max_time)
+    {
+        p_isr->max_time = elapsed;
+    }
+}
+
+// Copies out the totals of an interrupt since the scheduler started, max_time is since the last
+// report
+bool rtStatsGetIsrStats(const int isr, rtStatsIsrStats_t *p_stats)
+{
+    if((isr < 0) || (isr >= num_isrs))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *p_stats = isr_stats[isr];
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+// Writes the CPU used by each task and interrupt since the last report out of a serial port.
+// Time spent in interrupts is also counted against the task that was interrupted.
+//  STATS <interval> ms
+//  <task>  <cpu>%  <times switched in>
+//  <isr>   <cpu>%  <times run>  <longest run> us
+void rtStatsReport(const int uart)
+{
+    uint64_t now = 0;
+    UBaseType_t num_tasks = uxTaskGetSystemState(task_status, RT_STATS_MAX_TASKS, &now);
+    if(num_tasks == 0)
+    {
+        UART_Send(uart, "STATS too many tasks\n");
+        return;
+    }
+
+    uint64_t interval = now - report_time;
+    report_time = now;
+
+    snprintf(line, sizeof(line), "STATS %lu ms\n", (unsigned long)((interval * 1000) / rtStatsCounterHz()));
+    UART_Send(uart, line);
+
+    for(UBaseType_t idx = 0; idx < num_tasks; idx++)
+    {
+        const TaskStatus_t *p_task = &task_status[idx];
+        uint64_t run_time = p_task->ulRunTimeCounter;
+        uint32_t switch_count = p_task->ulSwitchInCount;
+
+        // A task created since the last report is reported from its creation
+        const rtStatsTaskSnapshot_t *p_prev = rtStatsFindSnapshot(p_task->xTaskNumber);
+        if(p_prev != NULL)
+        {
+            run_time -= p_prev->run_time;
+            switch_count -= p_prev->switch_count;
+        }
+
+        uint32_t per_mille = rtStatsPerMille(run_time, interval);
+        snprintf(line, sizeof(line), "%-10s %3lu.%lu%% %10lu\n", p_task->pcTaskName,
+                 (unsigned long)(per_mille / 10), (unsigned long)(per_mille % 10),
+                 (unsigned long)switch_count);
+        UART_Send(uart, line);
+    }
+
+    // Deleted tasks drop out of the snapshots here
+    for(UBaseType_t idx = 0; idx < num_tasks; idx++)
+    {
+        task_snapshots[idx].task_number = task_status[idx].xTaskNumber;
+        task_snapshots[idx].run_time = task_status[idx].ulRunTimeCounter;
+        task_snapshots[idx].switch_count = task_status[idx].ulSwitchInCount;
+    }
+    num_task_snapshots = num_tasks;
+
+    for(int isr = 0; isr < num_isrs; isr++)
+    {
+        rtStatsIsrStats_t stats;
+        taskENTER_CRITICAL();
+        stats = isr_stats[isr];
+        isr_stats[isr].max_time = 0;
+        taskEXIT_CRITICAL();
+
+        uint32_t per_mille = rtStatsPerMille(stats.total_time - isr_snapshots[isr].total_time, interval);
+        uint32_t max_us = rtStatsCountsToUs(stats.max_time);
+        snprintf(line, sizeof(line), "%-10s %3lu.%lu%% %10lu %6lu us\n", stats.p_name,
+                 (unsigned long)(per_mille / 10), (unsigned long)(per_mille % 10),
+                 (unsigned long)(stats.num_calls - isr_snapshots[isr].num_calls), (unsigned long)max_us);
+        UART_Send(uart, line);
+
+        isr_snapshots[isr] = stats;
+    }
+}
+
+// Writes the usage of each queue in the queue registry since the last report out of a serial port,
+// to size the queues from. Latency is from an item being sent to it being received, each histogram
+// bucket after the first is twice as wide as the one before, see FreeRTOSConfig.h. The queue tuner
+// is given each queue's statistics as they are reset, so this is called from the task that updates it.
+//  QSTATS
+//  <queue>  <peak>/<length>  <items sent>  <send fails>  <send fails from interrupts>
+//  <queue>  blk <sends blocked>  <average block> us  <longest block> us
+//  <queue>  lat <longest latency> us  <items in each bucket> ...
+void rtStatsQueueReport(const int uart)
+{
+    UART_Send(uart, "QSTATS\n");
+
+    for(UBaseType_t idx = 0; idx < configQUEUE_REGISTRY_SIZE; idx++)
+    {
+        const char *p_name = NULL;
+        QueueHandle_t queue = xQueueGetRegistryEntry(idx, &p_name);
+        if(queue == NULL)
+        {
+            continue;
+        }
+
+        vQueueGetStats(queue, &queue_stats, pdTRUE);
+        queueTunerQueueStatsReset(queue, &queue_stats);
+
+        snprintf(line, sizeof(line), "%-10s %3lu/%-3lu %10lu %6lu %6lu\n", p_name,
+                 (unsigned long)queue_stats.uxPeakMessagesWaiting, (unsigned long)queue_stats.uxLength,
+                 (unsigned long)queue_stats.ulItemsSent, (unsigned long)queue_stats.ulSendFailed,
+                 (unsigned long)queue_stats.ulSendFailedFromISR);
+        UART_Send(uart, line);
+
+        if(queue_stats.ulSendWaits != 0)
+        {
+            snprintf(line, sizeof(line), "%-10s blk %6lu %8lu us %8lu us\n", p_name,
+                     (unsigned long)queue_stats.ulSendWaits,
+                     (unsigned long)rtStatsCountsToUs(queue_stats.ulSendWaitTime / queue_stats.ulSendWaits),
+                     (unsigned long)rtStatsCountsToUs(queue_stats.ulSendWaitTimeMax));
+            UART_Send(uart, line);
+        }
+
+        // Semaphores and statically allocated queues have no latency to report
+        uint32_t num_timed = 0;
+        for(int bucket = 0; bucket < configQUEUE_STATS_HISTOGRAM_BUCKETS; bucket++)
+        {
+            num_timed += queue_stats.ulLatencyHistogram[bucket];
+        }
+
+        if(num_timed != 0)
+        {
+            snprintf(line, sizeof(line), "%-10s lat %8lu us", p_name,
+                     (unsigned long)rtStatsCountsToUs(queue_stats.ulLatencyMax));
+            UART_Send(uart, line);
+
+            for(int bucket = 0; bucket < configQUEUE_STATS_HISTOGRAM_BUCKETS; bucket++)
+            {
+                snprintf(line, sizeof(line), " %lu", (unsigned long)queue_stats.ulLatencyHistogram[bucket]);
+                UART_Send(uart, line);
+            }
+            UART_Send(uart, "\n");
+        }
+    }
+}
+
+// Writes how much of its stack each task has used since it was created out of a serial port, the
+// deepest the stack has been rather than what is in use now. Compared with tools/stack_report.py
+// to size the stacks from.
+//  SSTATS
+//  <task>  <words used>/<stack size in words>
+void rtStatsStackReport(const int uart)
+{
+    UBaseType_t num_tasks = uxTaskGetSystemState(task_status, RT_STATS_MAX_TASKS, NULL);
+    if(num_tasks == 0)
+    {
+        UART_Send(uart, "SSTATS too many tasks\n");
+        return;
+    }
+
+    UART_Send(uart, "SSTATS\n");
+
+    for(UBaseType_t idx = 0; idx < num_tasks; idx++)
+    {
+        const TaskStatus_t *p_task = &task_status[idx];
+        snprintf(line, sizeof(line), "%-10s %5lu/%lu words\n", p_task->pcTaskName,
+                 (unsigned long)(p_task->usStackDepth - p_task->usStackHighWaterMark),
+                 (unsigned long)p_task->usStackDepth);
+        UART_Send(uart, line);
+    }
+}
+
+/* *************************   Private Functions   ************************ */
+
+// Runs in the timer task, only so the cycle counter is sampled often enough
+static void rtStatsExtendCallback(TimerHandle_t timer)
+{
+    (void)timer;
+    (void)rtStatsGetCounter();
+}
+
+static const rtStatsTaskSnapshot_t *rtStatsFindSnapshot(const UBaseType_t task_number)
+{
+    for(UBaseType_t idx = 0; idx < num_task_snapshots; idx++)
+    {
+        if(task_snapshots[idx].task_number == task_number)
+        {
+            return &task_snapshots[idx];
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t rtStatsPerMille(const uint64_t part, const uint64_t whole)
+{
+    return (whole == 0) ? 0 : (uint32_t)((part * 1000) / whole);
+}
+
+static uint32_t rtStatsCountsToUs(const uint64_t counts)
+{
+    return (uint32_t)((counts * 1000000) / rtStatsCounterHz());
+}
+
+#if !defined(__arm__)
+static uint64_t rtStatsHostClock(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec - host_clock_start;
+}
+#endif
@@ -0,0 +1,256 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  spi_bus.c
+//
+//  SPI Bus Arbiter
+//
+//  Module description in spi_bus.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+// Library Includes
+
+// Project Includes
+#include "run_time_stats.h"
+
+// Module Includes
+#include "spi_bus.h"
+
+/* ***************************   Definitions   **************************** */
+
+// Time base for the bus statistics, extended to 64 bits as a wait for the bus has no upper bound
+#define SPI_BUS_TIMESTAMP()             rtStatsGetCounter()
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    int chip_select;
+    uint64_t acquired_at;
+    spiBusClientStats_t stats;
+}spiBusClient_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static bool spiBusSchedulerRunning(void);
+
+static void SPI_DmaComplete(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static spiBusClient_t clients[SPI_BUS_MAX_CLIENTS];
+static int num_clients = 0;
+
+// Held by the client that owns the bus, tasks waiting on it are queued by priority
+static SemaphoreHandle_t bus_mutex = NULL;
+static StaticSemaphore_t bus_mutex_buffer;
+
+// Given by the DMA complete interrupt, only ever taken by the bus owner
+static SemaphoreHandle_t dma_done_sem = NULL;
+static StaticSemaphore_t dma_done_sem_buffer;
+
+static int bus_owner = SPI_BUS_CLIENT_INVALID;
+
+// The peripheral keeps the last client's configuration, so back to back batches from the same
+// client don't reprogram it
+static int configured_client = SPI_BUS_CLIENT_INVALID;
+
+static int dma_isr_stats = RT_STATS_ISR_INVALID;
+
+/* *************************   Public  Functions   ************************ */
+
+void spiBusInit(void)
+{
+    SPI_Init();
+
+    bus_mutex = xSemaphoreCreateMutexStatic(&bus_mutex_buffer);
+    assert(bus_mutex != NULL);
+
+    dma_done_sem = xSemaphoreCreateBinaryStatic(&dma_done_sem_buffer);
+    assert(dma_done_sem != NULL);
+
+    // Named in the queue registry so they show up in traces
+    vQueueAddToRegistry(bus_mutex, "SPI bus");
+    vQueueAddToRegistry(dma_done_sem, "SPI DMA");
+
+    dma_isr_stats = rtStatsRegisterIsr("SPI DMA");
+}
+
+// Adds a driver to the bus, must be called before the scheduler is started
+int spiBusRegisterClient(const char *p_name, const int chip_select)
+{
+    if(num_clients >= SPI_BUS_MAX_CLIENTS)
+    {
+        return SPI_BUS_CLIENT_INVALID;
+    }
+
+    spiBusClient_t *p_client = &clients[num_clients];
+    memset(p_client, 0, sizeof(*p_client));
+    p_client->chip_select = chip_select;
+    p_client->stats.p_name = p_name;
+
+    return num_clients++;
+}
+
+// Takes ownership of the bus. Every transfer until spiBusRelease() runs as one batch without
+// another client getting in between, the client groups its transfers by holding the bus across them.
+bool spiBusAcquire(const int client, const TickType_t timeout)
+{
+    spiBusClient_t *p_client = &clients[client];
+    uint64_t wait_start = SPI_BUS_TIMESTAMP();
+
+    // Before the scheduler runs there is only one thread of execution, so nothing to arbitrate
+    if(spiBusSchedulerRunning() && (xSemaphoreTake(bus_mutex, timeout) != pdTRUE))
+    {
+        return false;
+    }
+
+    p_client->acquired_at = SPI_BUS_TIMESTAMP();
+    uint64_t wait_time = p_client->acquired_at - wait_start;
+    p_client->stats.num_batches++;
+    p_client->stats.wait_time += wait_time;
+    if(wait_time > p_client->stats.max_wait_time)
+    {
+        p_client->stats.max_wait_time = wait_time;
+    }
+
+    if(configured_client != client)
+    {
+        SPI_Configure(p_client->chip_select);
+        configured_client = client;
+    }
+
+    bus_owner = client;
+    return true;
+}
+
+void spiBusRelease(const int client)
+{
+    configASSERT(bus_owner == client);
+
+    spiBusClient_t *p_client = &clients[client];
+    p_client->stats.bus_time += SPI_BUS_TIMESTAMP() - p_client->acquired_at;
+    bus_owner = SPI_BUS_CLIENT_INVALID;
+
+    if(spiBusSchedulerRunning())
+    {
+        xSemaphoreGive(bus_mutex);
+    }
+}
+
+// Drives the client's chip select line, the bus must be held
+void spiBusSelect(const int client, const bool selected)
+{
+    configASSERT(bus_owner == client);
+    SPI_ChipSelect(clients[client].chip_select, selected);
+}
+
+void spiBusWrite(const int client, const uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    configASSERT(bus_owner == client);
+    clients[client].stats.num_bytes += num_bytes;
+
+    // DMA frees the CPU for other tasks while the bytes are clocked out
+    if((num_bytes >= SPI_BUS_DMA_THRESHOLD) && spiBusSchedulerRunning())
+    {
+        SPI_WriteDMA(p_bytes, num_bytes);
+        xSemaphoreTake(dma_done_sem, portMAX_DELAY);
+    }
+    else
+    {
+        SPI_Write(p_bytes, num_bytes);
+    }
+}
+
+void spiBusRead(const int client, uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    configASSERT(bus_owner == client);
+    clients[client].stats.num_bytes += num_bytes;
+
+    if((num_bytes >= SPI_BUS_DMA_THRESHOLD) && spiBusSchedulerRunning())
+    {
+        SPI_ReadDMA(p_bytes, num_bytes);
+        xSemaphoreTake(dma_done_sem, portMAX_DELAY);
+    }
+    else
+    {
+        SPI_Read(p_bytes, num_bytes);
+    }
+}
+
+int spiBusGetNumClients(void)
+{
+    return num_clients;
+}
+
+// Copies out the bus usage of a client. Comparing wait_time against the other clients' bus_time
+// shows which driver is holding up which.
+bool spiBusGetClientStats(const int client, spiBusClientStats_t *p_stats)
+{
+    if((client < 0) || (client >= num_clients))
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    *p_stats = clients[client].stats;
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/* *************************   Private Functions   ************************ */
+
+static bool spiBusSchedulerRunning(void)
+{
+    return (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED);
+}
+
+/* *************************  Interrupt Handlers  ************************* */
+
+// An abstraction of the SPI DMA transfer complete interrupt
+static void SPI_DmaComplete(void)
+{
+    uint32_t isr_start = rtStatsIsrEnter(dma_isr_stats);
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(dma_done_sem, &xHigherPriorityTaskWoken);
+
+    rtStatsIsrExit(dma_isr_stats, isr_start);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
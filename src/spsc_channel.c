@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  spsc_channel.c
+//
+//  SPSC Channel
+//
+//  Module description in spsc_channel.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Library Includes
+
+// Project Includes
+
+// Module Includes
+#include "spsc_channel.h"
+
+/* ***************************   Definitions   **************************** */
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static uint32_t spscChannelNextIdx(const spscChannel_t *p_chan, const uint32_t idx);
+
+/* ***********************   File Scope Variables   *********************** */
+
+/* *************************   Public  Functions   ************************ */
+
+// Storage must hold num_slots items of item_size bytes, see SPSC_CHANNEL_NUM_SLOTS()
+void spscChannelInit(spscChannel_t *p_chan, void *p_storage, const uint32_t item_size,
+                     const uint32_t num_slots, TaskHandle_t consumer_task, const UBaseType_t notify_index)
+{
+    assert(num_slots >= 2);
+
+    memset(p_chan, 0, sizeof(*p_chan));
+    p_chan->p_storage = (uint8_t *)p_storage;
+    p_chan->item_size = item_size;
+    p_chan->num_slots = num_slots;
+    p_chan->consumer_task = consumer_task;
+    p_chan->notify_index = notify_index;
+    atomic_init(&p_chan->write_idx, 0);
+    atomic_init(&p_chan->read_idx, 0);
+    atomic_init(&p_chan->consumer_waiting, false);
+}
+
+// Returns the slot the next item should be written to, or NULL if the channel is full. The same
+// slot is returned until it is published, so an item can be built up over several interrupts.
+void *spscChannelWriteSlot(spscChannel_t *p_chan)
+{
+    // Acquire pairs with the release in spscChannelConsume(), the consumer is done with the slot
+    uint32_t write_idx = atomic_load_explicit(&p_chan->write_idx, memory_order_relaxed);
+    if(spscChannelNextIdx(p_chan, write_idx) == atomic_load_explicit(&p_chan->read_idx, memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    return &p_chan->p_storage[write_idx * p_chan->item_size];
+}
+
+// Hands the item in the write slot over to the consumer
+void spscChannelPublishFromISR(spscChannel_t *p_chan, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    // Release so the item is in memory before the consumer can see the new index
+    uint32_t write_idx = spscChannelNextIdx(p_chan, atomic_load_explicit(&p_chan->write_idx, memory_order_relaxed));
+    atomic_store_explicit(&p_chan->write_idx, write_idx, memory_order_release);
+
+    // The consumer may have taken items since, so this can miss a peak but never overstates one
+    uint32_t read_idx = atomic_load_explicit(&p_chan->read_idx, memory_order_relaxed);
+    uint32_t num_items = (write_idx + p_chan->num_slots - read_idx) % p_chan->num_slots;
+    if(num_items > p_chan->peak_items)
+    {
+        p_chan->peak_items = num_items;
+    }
+
+    // The new index must be visible before the flag is read, the mirror of
+    // spscChannelPrepareToWait(). Clearing the flag as it is read means exactly one of the two sides
+    // acts on it.
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_exchange_explicit(&p_chan->consumer_waiting, false, memory_order_relaxed))
+    {
+        vTaskNotifyGiveIndexedFromISR(p_chan->consumer_task, p_chan->notify_index, pxHigherPriorityTaskWoken);
+    }
+}
+
+// Copies a complete item into the channel, returns false and counts a drop if it is full
+bool spscChannelSendFromISR(spscChannel_t *p_chan, const void *p_item, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    void *p_slot = spscChannelWriteSlot(p_chan);
+    if(p_slot == NULL)
+    {
+        spscChannelDropFromISR(p_chan);
+        return false;
+    }
+
+    memcpy(p_slot, p_item, p_chan->item_size);
+    spscChannelPublishFromISR(p_chan, pxHigherPriorityTaskWoken);
+    return true;
+}
+
+// Counts an item the producer could not fit, or threw away for its own reasons, in the statistics
+// the queue tuner samples
+void spscChannelDropFromISR(spscChannel_t *p_chan)
+{
+    p_chan->num_dropped++;
+}
+
+// Returns the oldest item, left in place until spscChannelConsume() is called, or NULL if the
+// channel is empty
+void *spscChannelReadSlot(spscChannel_t *p_chan)
+{
+    // Acquire pairs with the release in spscChannelPublishFromISR(), so the item isn't read before
+    // the index that says it is there
+    uint32_t read_idx = atomic_load_explicit(&p_chan->read_idx, memory_order_relaxed);
+    if(read_idx == atomic_load_explicit(&p_chan->write_idx, memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    return &p_chan->p_storage[read_idx * p_chan->item_size];
+}
+
+// Frees the slot of the item returned by spscChannelReadSlot()
+void spscChannelConsume(spscChannel_t *p_chan)
+{
+    // Release so the item is finished with before the producer is allowed to overwrite it
+    uint32_t read_idx = atomic_load_explicit(&p_chan->read_idx, memory_order_relaxed);
+    atomic_store_explicit(&p_chan->read_idx, spscChannelNextIdx(p_chan, read_idx), memory_order_release);
+}
+
+// Called by the consumer before it blocks on its task notification. Returns true if the channel is
+// empty and the next published item will notify the task. Returns false if an item arrived in the
+// meantime, in which case the task should not block.
+//
+// The flag is set before the index is checked and the producer publishes the index before it
+// checks the flag, each with a full fence in between, so at least one side sees the other. If an
+// item arrives in between, the producer may already have cleared the flag and notified the task,
+// and the task's next wait returns at once, which is harmless because it rechecks the channel.
+bool spscChannelPrepareToWait(spscChannel_t *p_chan)
+{
+    atomic_store_explicit(&p_chan->consumer_waiting, true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint32_t read_idx = atomic_load_explicit(&p_chan->read_idx, memory_order_relaxed);
+    if(read_idx != atomic_load_explicit(&p_chan->write_idx, memory_order_relaxed))
+    {
+        // Only clear the flag if the producer hasn't, it may be mid notification
+        atomic_exchange_explicit(&p_chan->consumer_waiting, false, memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+/* *************************   Private Functions   ************************ */
+
+static uint32_t spscChannelNextIdx(const spscChannel_t *p_chan, const uint32_t idx)
+{
+    return ((idx + 1) == p_chan->num_slots) ? 0 : (idx + 1);
+}
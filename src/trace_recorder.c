@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  trace_recorder.c
+//
+//  Binary Trace Recorder
+//
+//  Module description in trace_recorder.h
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+// FreeRTOS Includes
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Library Includes
+
+// Project Includes
+#include "crc.h"
+#include "run_time_stats.h"
+
+// Module Includes
+#include "trace_recorder.h"
+
+/* ***************************   Definitions   **************************** */
+
+#if (TRACE_REC_NUM_EVENTS & (TRACE_REC_NUM_EVENTS - 1)) != 0
+    #error TRACE_REC_NUM_EVENTS must be a power of 2
+#endif
+
+#define TRACE_REC_HEADER(type, object, value)   ((uint32_t)(type) | ((uint32_t)(object) << 8) | ((uint32_t)(value) << 16))
+
+// Events written per line of a dump
+#define TRACE_REC_EVENTS_PER_LINE       4
+
+// Longest dump line is a full line of events, "EVT" then 16 hex digits per event
+#define TRACE_REC_LINE_SIZE             (4 + (TRACE_REC_EVENTS_PER_LINE * 17) + 2)
+
+/* ****************************   Structures   **************************** */
+
+typedef struct
+{
+    volatile uint32_t timestamp;
+    volatile uint32_t header;           // Type, object and value, zero while being written
+}traceRecRecord_t;
+
+typedef struct
+{
+    traceRecClass_t obj_class;
+    uint8_t object;
+    char name[TRACE_REC_NAME_LEN + 1];
+}traceRecSymbol_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void traceRecSendLine(const int uart, uint32_t *p_crc);
+
+/* ***********************   File Scope Variables   *********************** */
+
+// The kernel records events from the moment the first task is created, so everything here starts
+// out ready without an init call
+static traceRecRecord_t records[TRACE_REC_NUM_EVENTS];
+
+// Total events recorded since the last dump, the low bits pick the slot the next one goes in
+static volatile uint32_t num_recorded = 0;
+
+// Cleared while a dump reads the ring
+static volatile bool recording = true;
+
+static traceRecSymbol_t symbols[TRACE_REC_MAX_SYMBOLS];
+static int num_symbols = 0;
+
+// Numbers handed out to queues and stream buffers, 0 is left for unknown objects
+static uint8_t next_object = 1;
+
+static int num_stages = 0;
+
+// Kept off the stack of the task making the dump
+static char line[TRACE_REC_LINE_SIZE];
+
+/* *************************   Public  Functions   ************************ */
+
+// Adds an event to the ring. Safe to call from any task or interrupt, a slot is claimed with one
+// atomic increment so writers never wait on each other. The header is written last so a dump
+// taken while a writer is part way through sees an empty slot rather than a mismatched record.
+void traceRecEvent(const traceRecEventType_t type, const uint8_t object, const uint16_t value)
+{
+    if(!recording)
+    {
+        return;
+    }
+
+    uint32_t slot = __atomic_fetch_add(&num_recorded, 1, __ATOMIC_RELAXED) & (TRACE_REC_NUM_EVENTS - 1);
+    traceRecRecord_t *p_record = &records[slot];
+
+    p_record->header = 0;
+    p_record->timestamp = rtStatsReadCounter();
+    p_record->header = TRACE_REC_HEADER(type, object, value);
+}
+
+// Numbers a new queue or stream buffer, called by the kernel as they are created
+uint8_t traceRecNewObject(void)
+{
+    uint8_t object = TRACE_REC_OBJECT_UNKNOWN;
+
+    taskENTER_CRITICAL();
+    if(next_object != TRACE_REC_OBJECT_UNKNOWN)
+    {
+        object = next_object++;
+    }
+    taskEXIT_CRITICAL();
+
+    return object;
+}
+
+// Names an object in dumps. Naming an object again replaces its name, once the table is full
+// further names are dropped and the objects appear by number only.
+void traceRecAddSymbol(const traceRecClass_t obj_class, const uint8_t object, const char *p_name)
+{
+    taskENTER_CRITICAL();
+
+    traceRecSymbol_t *p_symbol = NULL;
+    for(int idx = 0; idx < num_symbols; idx++)
+    {
+        if((symbols[idx].obj_class == obj_class) && (symbols[idx].object == object))
+        {
+            p_symbol = &symbols[idx];
+            break;
+        }
+    }
+
+    if((p_symbol == NULL) && (num_symbols < TRACE_REC_MAX_SYMBOLS))
+    {
+        p_symbol = &symbols[num_symbols++];
+    }
+
+    if(p_symbol != NULL)
+    {
+        p_symbol->obj_class = obj_class;
+        p_symbol->object = object;
+        strncpy(p_symbol->name, p_name, TRACE_REC_NAME_LEN);
+        p_symbol->name[TRACE_REC_NAME_LEN] = '\0';
+    }
+
+    taskEXIT_CRITICAL();
+}
+
+// Adds a named point in the application's processing to record with traceRecStage(), must be
+// called before the scheduler is started
+int traceRecRegisterStage(const char *p_name)
+{
+    if(num_stages >= TRACE_REC_MAX_STAGES)
+    {
+        return TRACE_REC_STAGE_INVALID;
+    }
+
+    traceRecAddSymbol(E_TRACE_CLASS_STAGE, (uint8_t)num_stages, p_name);
+    return num_stages++;
+}
+
+// Records that the application reached a stage, the value is whatever helps make sense of it
+void traceRecStage(const int stage, const uint16_t value)
+{
+    if((stage < 0) || (stage >= num_stages))
+    {
+        return;
+    }
+
+    traceRecEvent(E_TRACE_EVT_STAGE, (uint8_t)stage, value);
+}
+
+// Writes the symbols and the recorded events out of a serial port, oldest event first, then starts
+// recording afresh. Nothing is recorded while the dump is in progress.
+//  TRACE <counter hz> <events> <events lost to overwrite>
+//  SYM <class> <object> <name>
+//  EVT <timestamp><header> ...     Up to 4 events a line, each as 16 hex digits
+//  END <crc>                       CRC-32 of every line before it, including the newlines
+void traceRecDump(const int uart)
+{
+    recording = false;
+
+    uint32_t total = num_recorded;
+    uint32_t num_events = (total > TRACE_REC_NUM_EVENTS) ? TRACE_REC_NUM_EVENTS : total;
+    uint32_t crc = crc32Start();
+
+    snprintf(line, sizeof(line), "TRACE %lu %lu %lu\n", (unsigned long)rtStatsCounterHz(),
+             (unsigned long)num_events, (unsigned long)(total - num_events));
+    traceRecSendLine(uart, &crc);
+
+    for(int idx = 0; idx < num_symbols; idx++)
+    {
+        snprintf(line, sizeof(line), "SYM %u %u %s\n", (unsigned int)symbols[idx].obj_class,
+                 (unsigned int)symbols[idx].object, symbols[idx].name);
+        traceRecSendLine(uart, &crc);
+    }
+
+    uint32_t event = total - num_events;
+    while(event != total)
+    {
+        int len = snprintf(line, sizeof(line), "EVT");
+        for(int count = 0; (count < TRACE_REC_EVENTS_PER_LINE) && (event != total); count++, event++)
+        {
+            const traceRecRecord_t *p_record = &records[event & (TRACE_REC_NUM_EVENTS - 1)];
+            len += snprintf(&line[len], sizeof(line) - len, " %08lx%08lx",
+                            (unsigned long)p_record->timestamp, (unsigned long)p_record->header);
+        }
+        snprintf(&line[len], sizeof(line) - len, "\n");
+        traceRecSendLine(uart, &crc);
+    }
+
+    snprintf(line, sizeof(line), "END %08lx\n", (unsigned long)crc32Finish(crc));
+    UART_Send(uart, line);
+
+    num_recorded = 0;
+    recording = true;
+}
+
+/* *************************   Private Functions   ************************ */
+
+static void traceRecSendLine(const int uart, uint32_t *p_crc)
+{
+    *p_crc = crc32Update(*p_crc, (const uint8_t *)line, strlen(line));
+    UART_Send(uart, line);
+}
@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  FreeRTOSConfig.h
+//
+//  Host Benchmark Kernel Configuration
+//
+//  Kernel configuration for the host benchmarks in tools/bench. It follows inc/FreeRTOSConfig.h
+//  where it matters to the code being measured. The option under test can be set from the
+//  command line, for example -DconfigUSE_TIMER_WHEEL=1.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#define configUSE_TICKLESS_IDLE                 2       // Only for vTaskStepTick()
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configCPU_CLOCK_HZ                      1000000UL
+#define configTICK_RATE_HZ                      ((TickType_t)1000)
+#define configMAX_PRIORITIES                    5
+#define configMINIMAL_STACK_SIZE                ((unsigned short)130)
+#define configMAX_TASK_NAME_LEN                 10
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_MUTEXES                       1
+#define configQUEUE_REGISTRY_SIZE               0
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configGENERATE_RUN_TIME_STATS           0
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   4
+#define configUSE_BUCKETED_EVENT_LISTS          1
+
+// The benchmarks create their objects on the host heap, except heap_pool_bench.c which measures
+// the kernel's own heap
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+
+#ifndef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE                   ((size_t)24000)
+#endif
+
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               2
+#define configTIMER_QUEUE_LENGTH                5
+#define configTIMER_TASK_STACK_DEPTH            (configMINIMAL_STACK_SIZE * 2)
+
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL                   0
+#endif
+
+#ifndef configUSE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL            0
+#endif
+
+#ifndef configUSE_EVENT_GROUP_DIRECT_ISR
+#define configUSE_EVENT_GROUP_DIRECT_ISR        0
+#endif
+
+#ifndef configEVENT_GROUP_WAIT_LISTS
+#define configEVENT_GROUP_WAIT_LISTS            1
+#endif
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTimerPendFunctionCall          1
+#define INCLUDE_eTaskGetState                   1
+
+// A failed assert stops the benchmark with the kernel file and line
+void benchAssertFailed(const char *p_file, int line);
+#define configASSERT(x)                         if((x) == 0) { benchAssertFailed(__FILE__, __LINE__); }
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,239 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  crc_bench.c
+//
+//  CRC Benchmark
+//
+//  Runs src/crc.c on the host to compare its table driven CRC-16 and CRC-32 one byte at a time,
+//  the way the receive interrupts feed it, with a whole buffer at a time, CRC_SLICE_BY bytes per
+//  lookup round.
+//
+//  check <iterations>           Checks the standard check values, then that every buffer length
+//                               and alignment gives the same CRC sliced as it does byte by byte.
+//  bench <bytes> <iterations>   Times each way over a buffer of <bytes>, in cycles per byte on
+//                               x86 hosts and ns per byte elsewhere.
+//
+//  Build from the root of the repository, once with each slice width:
+//      gcc -O2 -DCRC_SLICE_BY=8 -Iinc -Isrc tools/bench/crc_bench.c -o crc_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Project Includes, the CRC module is built into this file
+#include "crc.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_MAX_BYTES                 4096
+
+// Longest buffer the check mode compares, at every alignment within a slice
+#define BENCH_CHECK_MAX_BYTES           64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_TIME_UNIT                 "cycles"
+#else
+#define BENCH_TIME_UNIT                 "ns"
+#endif
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static int benchCheck(const long iterations);
+static int benchTime(const int num_bytes, const long iterations);
+static uint16_t benchCrc16Bytewise(const uint8_t *p_bytes, const unsigned int num_bytes);
+static uint32_t benchCrc32Bytewise(const uint8_t *p_bytes, const unsigned int num_bytes);
+static uint64_t benchTimestamp(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+// Extra bytes so a buffer can start at every offset within a slice
+static uint8_t buffer[BENCH_MAX_BYTES + 8];
+
+// Keeps the results live so the compiler can't drop the loops being timed
+static volatile uint32_t sink;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if((argc == 3) && (strcmp(argv[1], "check") == 0))
+    {
+        return benchCheck(atol(argv[2]));
+    }
+
+    if((argc == 4) && (strcmp(argv[1], "bench") == 0))
+    {
+        int num_bytes = atoi(argv[2]);
+        if((num_bytes < 1) || (num_bytes > BENCH_MAX_BYTES))
+        {
+            fprintf(stderr, "bytes must be 1 to %d\n", BENCH_MAX_BYTES);
+            return 2;
+        }
+
+        return benchTime(num_bytes, atol(argv[3]));
+    }
+
+    fprintf(stderr, "usage: %s check <iterations> | bench <bytes> <iterations>\n", argv[0]);
+    return 2;
+}
+
+/* *************************   Private Functions   ************************ */
+
+static int benchCheck(const long iterations)
+{
+    long num_wrong = 0;
+
+    // CRC-16/CCITT-FALSE and CRC-32 of "123456789"
+    const uint8_t check[] = "123456789";
+    if((crc16Calc(check, 9) != 0x29B1) || (crc32Calc(check, 9) != 0xCBF43926))
+    {
+        printf("check values wrong: %04X %08lX\n", crc16Calc(check, 9), (unsigned long)crc32Calc(check, 9));
+        num_wrong++;
+    }
+
+    srand(1);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        for(unsigned int idx = 0; idx < sizeof(buffer); idx++)
+        {
+            buffer[idx] = (uint8_t)rand();
+        }
+
+        for(unsigned int offset = 0; offset < 8; offset++)
+        {
+            for(unsigned int num_bytes = 0; num_bytes <= BENCH_CHECK_MAX_BYTES; num_bytes++)
+            {
+                const uint8_t *p_bytes = &buffer[offset];
+                if((crc16Calc(p_bytes, num_bytes) != benchCrc16Bytewise(p_bytes, num_bytes)) ||
+                   (crc32Calc(p_bytes, num_bytes) != benchCrc32Bytewise(p_bytes, num_bytes)))
+                {
+                    if(num_wrong++ < 5)
+                    {
+                        printf("sliced CRC differs at offset %u, %u bytes\n", offset, num_bytes);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("slice by %d: %ld iterations, %ld wrong\n", CRC_SLICE_BY, iterations, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchTime(const int num_bytes, const long iterations)
+{
+    for(unsigned int idx = 0; idx < sizeof(buffer); idx++)
+    {
+        buffer[idx] = (uint8_t)idx;
+    }
+
+    // Offset by one so the sliced loops don't benefit from an aligned buffer
+    const uint8_t *p_bytes = &buffer[1];
+    double total_bytes = (double)num_bytes * iterations;
+
+    uint64_t start = benchTimestamp();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        sink = benchCrc16Bytewise(p_bytes, num_bytes);
+    }
+    uint64_t crc16_bytewise = benchTimestamp() - start;
+
+    start = benchTimestamp();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        sink = crc16Calc(p_bytes, num_bytes);
+    }
+    uint64_t crc16_sliced = benchTimestamp() - start;
+
+    start = benchTimestamp();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        sink = benchCrc32Bytewise(p_bytes, num_bytes);
+    }
+    uint64_t crc32_bytewise = benchTimestamp() - start;
+
+    start = benchTimestamp();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        sink = crc32Calc(p_bytes, num_bytes);
+    }
+    uint64_t crc32_sliced = benchTimestamp() - start;
+
+    printf("%d bytes, " BENCH_TIME_UNIT " per byte:\n", num_bytes);
+    printf("  crc16 byte by byte %6.2f   slice by %d %6.2f\n", crc16_bytewise / total_bytes, CRC_SLICE_BY,
+           crc16_sliced / total_bytes);
+    printf("  crc32 byte by byte %6.2f   slice by %d %6.2f\n", crc32_bytewise / total_bytes, CRC_SLICE_BY,
+           crc32_sliced / total_bytes);
+    return 0;
+}
+
+// The receive interrupts' way of running a CRC, one call per byte
+static uint16_t benchCrc16Bytewise(const uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    uint16_t crc = crc16Start();
+    for(unsigned int idx = 0; idx < num_bytes; idx++)
+    {
+        crc = crc16UpdateByte(crc, p_bytes[idx]);
+    }
+
+    return crc16Finish(crc);
+}
+
+static uint32_t benchCrc32Bytewise(const uint8_t *p_bytes, const unsigned int num_bytes)
+{
+    uint32_t crc = crc32Start();
+    for(unsigned int idx = 0; idx < num_bytes; idx++)
+    {
+        crc = crc32UpdateByte(crc, p_bytes[idx]);
+    }
+
+    return crc32Finish(crc);
+}
+
+static uint64_t benchTimestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + now.tv_nsec;
+#endif
+}
@@ -0,0 +1,314 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  delayed_wheel_bench.c
+//
+//  Delayed Task Benchmark
+//
+//  Runs libs/FreeRTOS/tasks.c on the host, without ever switching to a task, to compare the
+//  sorted delayed task lists with the delayed task wheel (configUSE_DELAYED_TASK_WHEEL). Tasks are
+//  blocked by calling the kernel's own delayed list functions with each one posing as the running
+//  task, and the tick is advanced by xTaskIncrementTick() or vTaskStepTick().
+//
+//  check <tasks> <iterations>   Blocks tasks for random times, some unblocked early, and fails if
+//                               any task is made ready at a tick other than its wake time, or
+//                               eTaskGetState() doesn't report a delayed task as blocked.
+//  bench <tasks> <iterations>   Times re-blocking a random task while <tasks> are delayed, and
+//                               then the tick interrupt with them all still delayed.
+//
+//  Build from the root of the repository, once with each setting of the wheel:
+//      gcc -O2 -DconfigUSE_DELAYED_TASK_WHEEL=1 -Itools/bench -Ilibs/FreeRTOS/include -Ilibs/FreeRTOS
+//          tools/bench/delayed_wheel_bench.c -o delayed_wheel_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// FreeRTOS Includes, the task and list modules are built into this file so their private
+// functions and data can be used directly
+#include "tasks.c"
+#include "list.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_MAX_TASKS                 2000
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void benchTask(void *pvParameters);
+static void benchCreateTasks(const int num_tasks);
+static void benchBlock(const int idx, const TickType_t ticks);
+static void benchUnblock(const int idx);
+static bool benchIsReady(TCB_t *p_tcb);
+static int benchCheck(const int num_tasks, const long iterations);
+static int benchReblock(const int num_tasks, const long iterations);
+static double benchSeconds(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static TCB_t *tasks[BENCH_MAX_TASKS];
+static TickType_t task_due[BENCH_MAX_TASKS];
+static bool task_blocked[BENCH_MAX_TASKS];
+
+// Stands in as the running task whenever no benchmark task is blocking itself
+static TCB_t *idle_task;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if(argc != 4)
+    {
+        fprintf(stderr, "usage: %s check|bench <tasks> <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    int num_tasks = atoi(argv[2]);
+    long iterations = atol(argv[3]);
+    if((num_tasks < 1) || (num_tasks > BENCH_MAX_TASKS))
+    {
+        fprintf(stderr, "tasks must be 1 to %d\n", BENCH_MAX_TASKS);
+        return 2;
+    }
+
+    printf("delayed task wheel %d: ", configUSE_DELAYED_TASK_WHEEL);
+    benchCreateTasks(num_tasks);
+    return (strcmp(argv[1], "check") == 0) ? benchCheck(num_tasks, iterations) : benchReblock(num_tasks, iterations);
+}
+
+// Port and application functions the kernel calls
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+BaseType_t xTimerCreateTimerTask(void)
+{
+    return pdPASS;
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+static void benchTask(void *pvParameters)
+{
+}
+
+// The tick count starts just short of wrapping, so both sides of it are covered
+static void benchCreateTasks(const int num_tasks)
+{
+    TaskHandle_t handle;
+
+    xTaskCreate(benchTask, "idle", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &handle);
+    idle_task = handle;
+    for(int idx = 0; idx < num_tasks; idx++)
+    {
+        xTaskCreate(benchTask, "bench", configMINIMAL_STACK_SIZE, NULL, 1 + (idx % 3), &handle);
+        tasks[idx] = handle;
+    }
+
+    pxCurrentTCB = idle_task;
+    xNextTaskUnblockTime = portMAX_DELAY;
+    xTickCount = 0xFFFF0000U;
+    #if(configUSE_DELAYED_TASK_WHEEL == 1)
+        xDelayedWheelTime = xTickCount;
+    #endif
+}
+
+static void benchBlock(const int idx, const TickType_t ticks)
+{
+    pxCurrentTCB = tasks[idx];
+    prvAddCurrentTaskToDelayedList(ticks, pdFALSE);
+    pxCurrentTCB = idle_task;
+
+    task_blocked[idx] = true;
+    task_due[idx] = xTickCount + ticks;
+}
+
+// As when a delayed task is woken early by the object it was blocked on
+static void benchUnblock(const int idx)
+{
+    uxListRemove(&tasks[idx]->xStateListItem);
+    prvAddTaskToReadyList(tasks[idx]);
+    task_blocked[idx] = false;
+}
+
+static bool benchIsReady(TCB_t *p_tcb)
+{
+    List_t *p_list = listLIST_ITEM_CONTAINER(&p_tcb->xStateListItem);
+    return (p_list >= &pxReadyTasksLists[0]) && (p_list < &pxReadyTasksLists[configMAX_PRIORITIES]);
+}
+
+static int benchCheck(const int num_tasks, const long iterations)
+{
+    long num_woken = 0;
+    long num_wrong = 0;
+
+    srand(3);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        // Mostly short delays, some long enough to be held in the upper levels of the wheel
+        for(int count = 0; count < 3; count++)
+        {
+            int idx = rand() % num_tasks;
+            if(!task_blocked[idx])
+            {
+                int kind = rand() % 10;
+                TickType_t ticks = (kind < 6) ? 1 + (rand() % 50) : (kind < 9) ? 1 + (rand() % 5000) : 1 + (rand() % 200000);
+                benchBlock(idx, ticks);
+            }
+        }
+
+        if((rand() % 20) == 0)
+        {
+            int idx = rand() % num_tasks;
+            if(task_blocked[idx])
+            {
+                benchUnblock(idx);
+                prvResetNextTaskUnblockTime();
+            }
+        }
+
+        // Sometimes skip ticks the way tickless idle does, which may not pass the next wake time
+        if(((rand() % 10) == 0) && (xNextTaskUnblockTime > (xTickCount + 1)))
+        {
+            TickType_t ticks = rand() % 50;
+            if(ticks > (xNextTaskUnblockTime - xTickCount - 1))
+            {
+                ticks = xNextTaskUnblockTime - xTickCount - 1;
+            }
+            vTaskStepTick(ticks);
+        }
+        else
+        {
+            xTaskIncrementTick();
+        }
+
+        for(int idx = 0; idx < num_tasks; idx++)
+        {
+            if(!task_blocked[idx])
+            {
+                continue;
+            }
+
+            bool is_ready = benchIsReady(tasks[idx]);
+            bool is_late = ((TickType_t)(xTickCount - task_due[idx]) < 0x80000000U) && (xTickCount != task_due[idx]);
+            bool is_blocked = (eTaskGetState(tasks[idx]) == eBlocked);
+            if((is_ready && (task_due[idx] != xTickCount)) || (!is_ready && (is_late || !is_blocked)))
+            {
+                if(num_wrong++ < 5)
+                {
+                    printf("task %d %s at %u, due %u\n", idx, is_ready ? "woke" : "still blocked",
+                           (unsigned)xTickCount, (unsigned)task_due[idx]);
+                }
+                task_blocked[idx] = false;
+            }
+            else if(is_ready)
+            {
+                num_woken++;
+                task_blocked[idx] = false;
+            }
+        }
+    }
+
+    printf("%d tasks, %ld woken, %ld wrong\n", num_tasks, num_woken, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchReblock(const int num_tasks, const long iterations)
+{
+    // Delays long enough that nothing wakes while measuring
+    srand(3);
+    for(int idx = 0; idx < num_tasks; idx++)
+    {
+        benchBlock(idx, 100000 + (rand() % 100000));
+    }
+
+    double start = benchSeconds();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        int idx = rand() % num_tasks;
+        benchUnblock(idx);
+        benchBlock(idx, 100000 + (rand() % 100000));
+    }
+    double middle = benchSeconds();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        xTaskIncrementTick();
+    }
+    double end = benchSeconds();
+
+    printf("%d tasks, re-block %.1f ns, tick %.1f ns\n", num_tasks, (middle - start) * 1e9 / iterations,
+           (end - middle) * 1e9 / iterations);
+    return 0;
+}
+
+static double benchSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec * 1e-9);
+}
@@ -0,0 +1,505 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  event_group_bench.c
+//
+//  Event Group Benchmark
+//
+//  Runs libs/FreeRTOS/event_groups.c on the host, with the task, queue and timer modules and
+//  without ever switching to a task, to check and time setting bits from an interrupt with and
+//  without configUSE_EVENT_GROUP_DIRECT_ISR. Tasks are blocked by placing them in the group's
+//  wait lists with each one posing as the running task, and the timer task's share of a deferred
+//  set is run by processing its command queue.
+//
+//  check <tasks> <iterations>   Blocks tasks on random bits, times some of them out, and sets and
+//                               clears bits from tasks and interrupts, some while a task holds
+//                               the group locked or the timer queue is full. Fails if the tasks
+//                               unblocked, the value each is given or the bits left set differ
+//                               from setting the bits on a single list of every waiting task, if
+//                               a task waits in the wrong list, or if a set that returns pdFAIL
+//                               changed anything.
+//  bench <tasks> <iterations>   Times an interrupt setting the bit that one of <tasks> waiting
+//                               tasks waits for, until that task is on the ready list. A set
+//                               left to the timer task includes its run of the command queue.
+//
+//  Build from the root of the repository, once with each setting of the direct path:
+//      gcc -O2 -DconfigUSE_EVENT_GROUP_DIRECT_ISR=1 -Itools/bench -Ilibs/FreeRTOS/include
+//          -Ilibs/FreeRTOS tools/bench/event_group_bench.c -o event_group_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// FreeRTOS Includes, the kernel modules are built into this file so their private functions and
+// data can be used directly
+#include "tasks.c"
+#include "list.c"
+#include "queue.c"
+#include "timers.c"
+#include "event_groups.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_MAX_TASKS                 200
+
+// Bits the tasks wait for, few enough that waits often share bits
+#define BENCH_CHECK_BITS                12
+#define BENCH_BENCH_BITS                24
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_TIME_UNIT                 "cycles"
+#else
+#define BENCH_TIME_UNIT                 "ns"
+#endif
+
+/* ****************************   Structures   **************************** */
+
+// What a task is waiting for, as the test expects it
+typedef struct
+{
+    bool waiting;
+    EventBits_t bits;
+    bool clear_on_exit;
+    bool wait_for_all;
+}benchWaiter_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void benchTask(void *pvParameters);
+static void benchNoCall(void *pvParameter1, uint32_t ulParameter2);
+static void benchCreateTasks(const int num_tasks);
+static void benchBlock(const int idx, const EventBits_t bits, const bool clear_on_exit, const bool wait_for_all);
+static void benchTimeOut(const int idx);
+static bool benchConditionMet(const benchWaiter_t *p_waiter, const EventBits_t bits);
+static void benchFillTimerQueue(void);
+static long benchCheckSet(const int num_tasks, const EventBits_t bits_to_set, const int how);
+static int benchCheck(const int num_tasks, const long iterations);
+static int benchTime(const int num_tasks, const long iterations);
+static uint64_t benchTimestamp(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static EventGroupHandle_t group;
+
+static TCB_t *tasks[BENCH_MAX_TASKS];
+static benchWaiter_t waiters[BENCH_MAX_TASKS];
+
+// Stands in as the running task whenever no benchmark task is blocking itself
+static TCB_t *idle_task;
+
+static long num_sets_failed;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if(argc != 4)
+    {
+        fprintf(stderr, "usage: %s check|bench <tasks> <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    int num_tasks = atoi(argv[2]);
+    long iterations = atol(argv[3]);
+    if((num_tasks < 1) || (num_tasks > BENCH_MAX_TASKS))
+    {
+        fprintf(stderr, "tasks must be 1 to %d\n", BENCH_MAX_TASKS);
+        return 2;
+    }
+
+    printf("direct ISR %d, %d wait lists: ", configUSE_EVENT_GROUP_DIRECT_ISR, (int)eventNUM_WAIT_LISTS);
+    benchCreateTasks(num_tasks);
+    return (strcmp(argv[1], "check") == 0) ? benchCheck(num_tasks, iterations) : benchTime(num_tasks, iterations);
+}
+
+// Port and application functions the kernel calls
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+static void benchTask(void *pvParameters)
+{
+}
+
+static void benchNoCall(void *pvParameter1, uint32_t ulParameter2)
+{
+}
+
+// Tasks take every priority but the idle task's, so the direct path has a highest one to pick
+static void benchCreateTasks(const int num_tasks)
+{
+    TaskHandle_t handle;
+
+    xTaskCreate(benchTask, "idle", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &handle);
+    idle_task = handle;
+    for(int idx = 0; idx < num_tasks; idx++)
+    {
+        xTaskCreate(benchTask, "bench", configMINIMAL_STACK_SIZE, NULL, 1 + (idx % (configMAX_PRIORITIES - 1)),
+                    &handle);
+        tasks[idx] = handle;
+    }
+
+    // Creates the timer queue, the timer task itself never runs
+    xTimerCreateTimerTask();
+
+    group = xEventGroupCreate();
+    pxCurrentTCB = idle_task;
+    xNextTaskUnblockTime = portMAX_DELAY;
+}
+
+// Blocks a task the way xEventGroupWaitBits() does once it finds its bits are not set
+static void benchBlock(const int idx, const EventBits_t bits, const bool clear_on_exit, const bool wait_for_all)
+{
+    EventBits_t control_bits = (clear_on_exit ? eventCLEAR_EVENTS_ON_EXIT_BIT : 0) |
+                               (wait_for_all ? eventWAIT_FOR_ALL_BITS : 0);
+
+    pxCurrentTCB = tasks[idx];
+    vTaskSuspendAll();
+    prvLockEventGroup(group);
+    prvPlaceOnWaitingList(group, bits, control_bits, portMAX_DELAY);
+    prvUnlockEventGroup(group);
+    (void)xTaskResumeAll();
+    pxCurrentTCB = idle_task;
+
+    waiters[idx].waiting = true;
+    waiters[idx].bits = bits;
+    waiters[idx].clear_on_exit = clear_on_exit;
+    waiters[idx].wait_for_all = wait_for_all;
+}
+
+// As the tick interrupt does when a task's block time expires
+static void benchTimeOut(const int idx)
+{
+    uxListRemove(&tasks[idx]->xStateListItem);
+    uxListRemove(&tasks[idx]->xEventListItem);
+    prvAddTaskToReadyList(tasks[idx]);
+    waiters[idx].waiting = false;
+}
+
+static bool benchConditionMet(const benchWaiter_t *p_waiter, const EventBits_t bits)
+{
+    return p_waiter->wait_for_all ? ((bits & p_waiter->bits) == p_waiter->bits) : ((bits & p_waiter->bits) != 0);
+}
+
+static void benchFillTimerQueue(void)
+{
+    while(xTimerPendFunctionCallFromISR(benchNoCall, NULL, 0, NULL) == pdPASS)
+    {
+    }
+}
+
+// Sets the bits from a task (how 0), an interrupt (1), an interrupt while a task holds the group
+// locked (2) or an interrupt with the timer queue full (3). Any part of the set left to the timer
+// task is run before the results are compared. Returns the number of differences.
+static long benchCheckSet(const int num_tasks, const EventBits_t bits_to_set, const int how)
+{
+    EventBits_t before = group->uxEventBits;
+    EventBits_t after = before | bits_to_set;
+    EventBits_t to_clear = 0;
+    BaseType_t result = pdPASS;
+    long num_wrong = 0;
+
+    if(how == 0)
+    {
+        (void)xEventGroupSetBits(group, bits_to_set);
+    }
+    else
+    {
+        if(how == 2)
+        {
+            prvLockEventGroup(group);
+        }
+        else if(how == 3)
+        {
+            benchFillTimerQueue();
+        }
+
+        BaseType_t woken = pdFALSE;
+        result = xEventGroupSetBitsFromISR(group, bits_to_set, &woken);
+
+        if(how == 2)
+        {
+            prvUnlockEventGroup(group);
+        }
+    }
+
+    // As the timer task would once the interrupt returns
+    prvProcessReceivedCommands();
+
+    // A set the interrupt could not pass on must leave everything as it was
+    if(result == pdFAIL)
+    {
+        after = before;
+        num_sets_failed++;
+    }
+
+    for(int idx = 0; idx < num_tasks; idx++)
+    {
+        if(!waiters[idx].waiting)
+        {
+            continue;
+        }
+
+        bool unblock = benchConditionMet(&waiters[idx], after);
+        bool in_list = (listLIST_ITEM_CONTAINER(&tasks[idx]->xEventListItem) != NULL);
+        TickType_t value = listGET_LIST_ITEM_VALUE(&tasks[idx]->xEventListItem);
+        TickType_t expected = after | eventUNBLOCKED_DUE_TO_BIT_SET | taskEVENT_LIST_ITEM_VALUE_IN_USE;
+
+        if(unblock && (in_list || (value != expected)))
+        {
+            if(num_wrong++ < 5)
+            {
+                printf("task %d %s, value %lX expected %lX\n", idx, in_list ? "still waiting" : "unblocked",
+                       (unsigned long)value, (unsigned long)expected);
+            }
+        }
+        else if(!unblock && !in_list)
+        {
+            if(num_wrong++ < 5)
+            {
+                printf("task %d waiting for %lX unblocked by %lX\n", idx, (unsigned long)waiters[idx].bits,
+                       (unsigned long)after);
+            }
+        }
+
+        // Follows what the kernel did from here on, so one difference isn't counted again
+        waiters[idx].waiting = in_list;
+        if(unblock && !in_list)
+        {
+            if(waiters[idx].clear_on_exit)
+            {
+                to_clear |= waiters[idx].bits;
+            }
+        }
+    }
+
+    if(group->uxEventBits != (after & ~to_clear))
+    {
+        if(num_wrong++ < 5)
+        {
+            printf("bits %lX expected %lX\n", (unsigned long)group->uxEventBits, (unsigned long)(after & ~to_clear));
+        }
+        group->uxEventBits = after & ~to_clear;
+    }
+
+    return num_wrong;
+}
+
+static int benchCheck(const int num_tasks, const long iterations)
+{
+    long num_woken = 0;
+    long num_wrong = 0;
+
+    srand(5);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        // Tasks wait for one to three bits, for any or all of them
+        for(int count = 0; count < 3; count++)
+        {
+            int idx = rand() % num_tasks;
+            if(waiters[idx].waiting)
+            {
+                continue;
+            }
+
+            EventBits_t bits = 0;
+            for(int num_bits = 1 + (rand() % 3); num_bits > 0; num_bits--)
+            {
+                bits |= (EventBits_t)1 << (rand() % BENCH_CHECK_BITS);
+            }
+
+            waiters[idx].bits = bits;
+            waiters[idx].wait_for_all = ((rand() % 2) == 0);
+            if(benchConditionMet(&waiters[idx], group->uxEventBits))
+            {
+                // xEventGroupWaitBits() would return without blocking
+                continue;
+            }
+
+            benchBlock(idx, bits, (rand() % 2) == 0, waiters[idx].wait_for_all);
+
+            // Lowest bit waited for, modulo the number of lists
+            UBaseType_t list = 0;
+            while((bits & ((EventBits_t)1 << list)) == 0)
+            {
+                list++;
+            }
+            if(listLIST_ITEM_CONTAINER(&tasks[idx]->xEventListItem) !=
+               &group->xTasksWaitingForBits[list % eventNUM_WAIT_LISTS])
+            {
+                if(num_wrong++ < 5)
+                {
+                    printf("task %d waiting for %lX in the wrong list\n", idx, (unsigned long)bits);
+                }
+            }
+        }
+
+        if((rand() % 20) == 0)
+        {
+            int idx = rand() % num_tasks;
+            if(waiters[idx].waiting)
+            {
+                benchTimeOut(idx);
+            }
+        }
+
+        if((rand() % 4) == 0)
+        {
+            (void)xEventGroupClearBits(group, (EventBits_t)rand() & ((1U << BENCH_CHECK_BITS) - 1));
+        }
+
+        int waiting_before = 0;
+        for(int idx = 0; idx < num_tasks; idx++)
+        {
+            waiting_before += waiters[idx].waiting ? 1 : 0;
+        }
+
+        int how = rand() % 8;
+        how = (how < 3) ? 0 : (how < 6) ? 1 : (how == 6) ? 2 : 3;
+        num_wrong += benchCheckSet(num_tasks, (EventBits_t)1 << (rand() % BENCH_CHECK_BITS), how);
+
+        int waiting_after = 0;
+        for(int idx = 0; idx < num_tasks; idx++)
+        {
+            waiting_after += waiters[idx].waiting ? 1 : 0;
+        }
+        num_woken += waiting_before - waiting_after;
+    }
+
+    printf("%d tasks, %ld woken, %ld sets failed, %ld wrong\n", num_tasks, num_woken, num_sets_failed, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+// Each task waits for a bit of its own while there are enough bits, for the bench's tasks are
+// meant to be woken one at a time
+static int benchTime(const int num_tasks, const long iterations)
+{
+    for(int idx = 0; idx < num_tasks; idx++)
+    {
+        benchBlock(idx, (EventBits_t)1 << (idx % BENCH_BENCH_BITS), false, false);
+    }
+
+    uint64_t isr_time = 0;
+    uint64_t timer_task_time = 0;
+    long num_deferred = 0;
+
+    srand(5);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        int target = rand() % num_tasks;
+        EventBits_t bit = (EventBits_t)1 << (target % BENCH_BENCH_BITS);
+
+        BaseType_t woken = pdFALSE;
+        uint64_t start = benchTimestamp();
+        (void)xEventGroupSetBitsFromISR(group, bit, &woken);
+        uint64_t middle = benchTimestamp();
+        bool deferred = (uxQueueMessagesWaiting(xTimerQueue) != 0);
+        prvProcessReceivedCommands();
+        uint64_t end = benchTimestamp();
+
+        if(listLIST_ITEM_CONTAINER(&tasks[target]->xEventListItem) != NULL)
+        {
+            printf("task %d not unblocked\n", target);
+            return 1;
+        }
+
+        isr_time += middle - start;
+        if(deferred)
+        {
+            timer_task_time += end - middle;
+            num_deferred++;
+        }
+
+        // Every task waiting for the bit was unblocked, put them back
+        (void)xEventGroupClearBits(group, bit);
+        for(int idx = target % BENCH_BENCH_BITS; idx < num_tasks; idx += BENCH_BENCH_BITS)
+        {
+            benchBlock(idx, bit, false, false);
+        }
+    }
+
+    printf("%d waiting tasks, " BENCH_TIME_UNIT " per set: interrupt %.0f, timer task %.0f, total %.0f, "
+           "%ld of %ld deferred\n", num_tasks, (double)isr_time / iterations, (double)timer_task_time / iterations,
+           (double)(isr_time + timer_task_time) / iterations, num_deferred, iterations);
+    return 0;
+}
+
+static uint64_t benchTimestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + now.tv_nsec;
+#endif
+}
@@ -0,0 +1,430 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  heap_pool_bench.c
+//
+//  Pool Heap Benchmark
+//
+//  Runs libs/FreeRTOS/portable/MemMang/heap_pool.c on the host, to compare its fixed block pools
+//  with a first fit heap that splits and coalesces free blocks in the manner of heap_4.c. Both
+//  heaps are configTOTAL_HEAP_SIZE bytes and are asked for the sizes of the objects the kernel
+//  allocates, each a little under the size of its pool's blocks.
+//
+//  check <blocks> <iterations>  Frees or allocates a block in one of <blocks> slots at random and
+//                               fails if a block overlaps another or is corrupted while it is
+//                               allocated, or the pool statistics don't add up.
+//  bench <blocks> <iterations>  Times the same churn on each heap, the average and 99.9th
+//                               percentile cost of an operation, in cycles on x86 hosts, and how
+//                               many allocations failed.
+//
+//  Build from the root of the repository:
+//      gcc -O2 -Itools/bench -Ilibs/FreeRTOS/include -Ilibs/FreeRTOS
+//          tools/bench/heap_pool_bench.c -o heap_pool_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// FreeRTOS Includes, the heap is built into this file so its pools can be checked directly
+#include "portable/MemMang/heap_pool.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_MAX_BLOCKS                256
+#define BENCH_MAX_ITERATIONS            10000000L
+
+// Requests are up to this many bytes under the size of the object they stand in for
+#define BENCH_SIZE_SPREAD               16
+
+// Operations take too little time for the clock, they are timed in cycles where the host can count
+// them
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_TIME_UNIT                 "cycles"
+#else
+#define BENCH_TIME_UNIT                 "ns"
+#endif
+
+/* ****************************   Structures   **************************** */
+
+// A free block of the first fit heap, kept on a list in address order
+typedef struct benchFreeBlock
+{
+    struct benchFreeBlock *p_next;
+    size_t num_bytes;                   // Including this header
+}benchFreeBlock_t;
+
+typedef struct
+{
+    void *p_block;
+    size_t num_bytes;
+    uint8_t fill;
+}benchSlot_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static int benchCheck(const int num_blocks, const long iterations);
+static int benchTime(const int num_blocks, const long iterations);
+static void benchRun(const char *p_name, void *(*p_malloc)(size_t), void (*p_free)(void *), const int num_blocks,
+                     const long iterations);
+static size_t benchRequestSize(void);
+static bool benchStatsAddUp(const int num_live);
+static void *benchFirstFitMalloc(size_t num_bytes);
+static void benchFirstFitFree(void *p_block);
+static void benchFirstFitInsert(benchFreeBlock_t *p_block);
+static int benchCompareTimes(const void *p_a, const void *p_b);
+static uint64_t benchTimestamp(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static benchSlot_t slots[BENCH_MAX_BLOCKS];
+static uint32_t op_times[BENCH_MAX_ITERATIONS];
+
+// Object sizes the requests are drawn from, weighted towards the small kernel objects
+static const size_t object_sizes[] = { sizeof(StaticTimer_t), sizeof(StaticTimer_t), sizeof(StaticQueue_t) + 64U,
+                                       sizeof(StaticQueue_t) + 64U, sizeof(StaticStreamBuffer_t) + 128U,
+                                       sizeof(StaticTask_t), sizeof(StaticTask_t),
+                                       configMINIMAL_STACK_SIZE * sizeof(StackType_t),
+                                       configMINIMAL_STACK_SIZE * 2U * sizeof(StackType_t) };
+
+// The first fit heap, the list starts at a dummy block and ends at a marker in the last bytes
+static uint8_t first_fit_heap[configTOTAL_HEAP_SIZE] __attribute__((aligned(portBYTE_ALIGNMENT)));
+static benchFreeBlock_t first_fit_start;
+static benchFreeBlock_t *p_first_fit_end = NULL;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if(argc != 4)
+    {
+        fprintf(stderr, "usage: %s check|bench <blocks> <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    int num_blocks = atoi(argv[2]);
+    long iterations = atol(argv[3]);
+    if((num_blocks < 1) || (num_blocks > BENCH_MAX_BLOCKS) || (iterations < 1) || (iterations > BENCH_MAX_ITERATIONS))
+    {
+        fprintf(stderr, "blocks must be 1 to %d, iterations 1 to %ld\n", BENCH_MAX_BLOCKS, BENCH_MAX_ITERATIONS);
+        return 2;
+    }
+
+    return (strcmp(argv[1], "check") == 0) ? benchCheck(num_blocks, iterations) : benchTime(num_blocks, iterations);
+}
+
+// Kernel functions the heap calls
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+static int benchCheck(const int num_blocks, const long iterations)
+{
+    long num_wrong = 0;
+    long num_failed = 0;
+    int num_live = 0;
+
+    srand(1);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        benchSlot_t *p_slot = &slots[rand() % num_blocks];
+
+        if(p_slot->p_block != NULL)
+        {
+            // Every byte must still hold what was written when the block was allocated
+            const uint8_t *p_byte = p_slot->p_block;
+            for(size_t idx = 0; idx < p_slot->num_bytes; idx++)
+            {
+                if(p_byte[idx] != p_slot->fill)
+                {
+                    if(num_wrong++ < 5)
+                    {
+                        printf("block %p corrupted at byte %zu\n", p_slot->p_block, idx);
+                    }
+                    break;
+                }
+            }
+
+            vPortFree(p_slot->p_block);
+            p_slot->p_block = NULL;
+            num_live--;
+        }
+        else
+        {
+            p_slot->num_bytes = benchRequestSize();
+            p_slot->p_block = pvPortMalloc(p_slot->num_bytes);
+            if(p_slot->p_block == NULL)
+            {
+                num_failed++;
+                continue;
+            }
+
+            if(((uintptr_t)p_slot->p_block & portBYTE_ALIGNMENT_MASK) != 0)
+            {
+                if(num_wrong++ < 5)
+                {
+                    printf("block %p is not aligned\n", p_slot->p_block);
+                }
+            }
+
+            p_slot->fill = (uint8_t)(iter | 1);
+            memset(p_slot->p_block, p_slot->fill, p_slot->num_bytes);
+            num_live++;
+        }
+
+        if(!benchStatsAddUp(num_live))
+        {
+            if(num_wrong++ < 5)
+            {
+                printf("pool statistics don't add up after %ld operations\n", iter + 1);
+            }
+        }
+    }
+
+    printf("%d blocks, %ld operations, %ld failed allocations, %ld wrong\n", num_blocks, iterations, num_failed,
+           num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchTime(const int num_blocks, const long iterations)
+{
+    // What reading the time adds to every operation timed
+    uint64_t start = benchTimestamp();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        (void)benchTimestamp();
+    }
+    printf("%d blocks, timing overhead %.1f " BENCH_TIME_UNIT "\n", num_blocks,
+           (double)(benchTimestamp() - start) / iterations);
+
+    benchRun("pool", pvPortMalloc, vPortFree, num_blocks, iterations);
+    benchRun("first fit", benchFirstFitMalloc, benchFirstFitFree, num_blocks, iterations);
+    return 0;
+}
+
+// Both heaps are given the same sequence of requests
+static void benchRun(const char *p_name, void *(*p_malloc)(size_t), void (*p_free)(void *), const int num_blocks,
+                     const long iterations)
+{
+    long num_failed = 0;
+    uint64_t total = 0;
+
+    memset(slots, 0, sizeof(slots));
+    srand(2);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        benchSlot_t *p_slot = &slots[rand() % num_blocks];
+        size_t num_bytes = benchRequestSize();
+
+        bool allocating = (p_slot->p_block == NULL);
+
+        uint64_t op_start = benchTimestamp();
+        if(allocating)
+        {
+            p_slot->p_block = p_malloc(num_bytes);
+        }
+        else
+        {
+            p_free(p_slot->p_block);
+            p_slot->p_block = NULL;
+        }
+        uint64_t op_end = benchTimestamp();
+
+        if(allocating && (p_slot->p_block == NULL))
+        {
+            num_failed++;
+        }
+
+        op_times[iter] = (uint32_t)(op_end - op_start);
+        total += op_end - op_start;
+    }
+
+    for(int idx = 0; idx < num_blocks; idx++)
+    {
+        p_free(slots[idx].p_block);
+        slots[idx].p_block = NULL;
+    }
+
+    qsort(op_times, iterations, sizeof(op_times[0]), benchCompareTimes);
+    printf("%-10s %7.1f " BENCH_TIME_UNIT " average, %6lu 99.9%%, %ld failed allocations\n", p_name,
+           (double)total / iterations, (unsigned long)op_times[(iterations * 999) / 1000], num_failed);
+}
+
+static size_t benchRequestSize(void)
+{
+    size_t num_bytes = object_sizes[rand() % (sizeof(object_sizes) / sizeof(object_sizes[0]))];
+    return num_bytes - (rand() % BENCH_SIZE_SPREAD);
+}
+
+// Every block is either free in its pool or held by a slot, and the heap's totals agree
+static bool benchStatsAddUp(const int num_live)
+{
+    size_t free_bytes = 0;
+    long num_allocated = 0;
+
+    for(UBaseType_t pool = 0; pool < uxPortGetHeapPoolCount(); pool++)
+    {
+        HeapPoolStats_t stats;
+        xPortGetHeapPoolStats(pool, &stats);
+
+        if((stats.uxBlocksFree > stats.uxNumBlocks) || (stats.uxMinimumEverBlocksFree > stats.uxBlocksFree) ||
+           ((stats.ulAllocations - stats.ulFrees) != (stats.uxNumBlocks - stats.uxBlocksFree)))
+        {
+            return false;
+        }
+
+        free_bytes += stats.uxBlocksFree * stats.xBlockSize;
+        num_allocated += (long)(stats.uxNumBlocks - stats.uxBlocksFree);
+    }
+
+    return (num_allocated == num_live) && (free_bytes == xPortGetFreeHeapSize()) &&
+           (xPortGetMinimumEverFreeHeapSize() <= free_bytes);
+}
+
+// Takes the first free block big enough, splitting off what is left over if it is worth keeping
+static void *benchFirstFitMalloc(size_t num_bytes)
+{
+    if(p_first_fit_end == NULL)
+    {
+        benchFreeBlock_t *p_first = (benchFreeBlock_t *)first_fit_heap;
+        p_first_fit_end = (benchFreeBlock_t *)&first_fit_heap[configTOTAL_HEAP_SIZE - sizeof(benchFreeBlock_t)];
+        p_first_fit_end->p_next = NULL;
+        p_first_fit_end->num_bytes = 0;
+        p_first->p_next = p_first_fit_end;
+        p_first->num_bytes = (uint8_t *)p_first_fit_end - first_fit_heap;
+        first_fit_start.p_next = p_first;
+        first_fit_start.num_bytes = 0;
+    }
+
+    if(num_bytes == 0)
+    {
+        return NULL;
+    }
+
+    num_bytes = (num_bytes + sizeof(benchFreeBlock_t) + portBYTE_ALIGNMENT_MASK) & ~(size_t)portBYTE_ALIGNMENT_MASK;
+
+    benchFreeBlock_t *p_prev = &first_fit_start;
+    benchFreeBlock_t *p_block = first_fit_start.p_next;
+    while((p_block->num_bytes < num_bytes) && (p_block->p_next != NULL))
+    {
+        p_prev = p_block;
+        p_block = p_block->p_next;
+    }
+
+    if(p_block == p_first_fit_end)
+    {
+        return NULL;
+    }
+
+    p_prev->p_next = p_block->p_next;
+    if((p_block->num_bytes - num_bytes) > (2 * sizeof(benchFreeBlock_t)))
+    {
+        benchFreeBlock_t *p_rest = (benchFreeBlock_t *)((uint8_t *)p_block + num_bytes);
+        p_rest->num_bytes = p_block->num_bytes - num_bytes;
+        p_block->num_bytes = num_bytes;
+        benchFirstFitInsert(p_rest);
+    }
+
+    return (uint8_t *)p_block + sizeof(benchFreeBlock_t);
+}
+
+static void benchFirstFitFree(void *p_block)
+{
+    if(p_block != NULL)
+    {
+        benchFirstFitInsert((benchFreeBlock_t *)((uint8_t *)p_block - sizeof(benchFreeBlock_t)));
+    }
+}
+
+// Puts a block back on the list in address order, merging it with the free blocks either side
+static void benchFirstFitInsert(benchFreeBlock_t *p_block)
+{
+    benchFreeBlock_t *p_prev = &first_fit_start;
+    while(p_prev->p_next < p_block)
+    {
+        p_prev = p_prev->p_next;
+    }
+
+    if(((uint8_t *)p_prev + p_prev->num_bytes) == (uint8_t *)p_block)
+    {
+        p_prev->num_bytes += p_block->num_bytes;
+        p_block = p_prev;
+    }
+
+    if((((uint8_t *)p_block + p_block->num_bytes) == (uint8_t *)p_prev->p_next) && (p_prev->p_next != p_first_fit_end))
+    {
+        p_block->num_bytes += p_prev->p_next->num_bytes;
+        p_block->p_next = p_prev->p_next->p_next;
+    }
+    else
+    {
+        p_block->p_next = p_prev->p_next;
+    }
+
+    if(p_prev != p_block)
+    {
+        p_prev->p_next = p_block;
+    }
+}
+
+static int benchCompareTimes(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+static uint64_t benchTimestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + now.tv_nsec;
+#endif
+}
@@ -0,0 +1,839 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  msg_handler_bench.c
+//
+//  Message Handler Benchmark
+//
+//  Runs the message handler task's ways of waiting for and picking its next message on the host,
+//  with src/spsc_channel.c and the kernel's task, queue and stream buffer modules, against a mixed
+//  load of messages from serial port 1, serial port 2 and the modem. The three ways are copies of
+//  the loop in src/message_handler.c as it has been:
+//
+//      drain     notifications at an index per source, the serial channels are emptied before the
+//                modem message buffer
+//      set       a counting semaphore per source in a queue set, one message per wake, the last
+//                message the modem semaphore counted also drains the buffer
+//      ordered   every message stamped as it arrives, one notification shared by the sources and
+//                the oldest head of any source handled first, as the task does now
+//
+//  The load runs on a virtual clock in us. Serial port 1 sends half the messages in bursts of
+//  BENCH_BURST_LENGTH, serial port 2 a fifth and the modem the rest, each message taking the task
+//  BENCH_SERVICE_US to handle. Messages arrive, as interrupts would, while the task handles
+//  others. A source holds BENCH_ITEMS_PER_SOURCE messages and drops any more.
+//
+//  check <iterations>           Runs each way at random loads and fails if a message is lost or
+//                               handled twice, or if the ordered way handles a message while one
+//                               that arrived before it is waiting.
+//  bench <load %> <messages>    Reports for each way how long each source's messages waited to be
+//                               handled, in virtual us, how many were handled ahead of a message
+//                               that arrived first, the kernel calls made to wait per wake, and the
+//                               cost to the task per message and to the producers per message,
+//                               in cycles on x86 hosts and ns elsewhere.
+//
+//  Build from the root of the repository:
+//      gcc -O2 -Itools/bench -Ilibs/FreeRTOS/include -Ilibs/FreeRTOS -Iinc -Isrc
+//          tools/bench/msg_handler_bench.c -o msg_handler_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// The queue set the task used to wait on is one of the ways timed
+#define configUSE_QUEUE_SETS            1
+
+// FreeRTOS Includes, the kernel modules are built into this file so the task's notification state
+// can be looked at directly
+#include "tasks.c"
+#include "list.c"
+#include "queue.c"
+#include "timers.c"
+#include "stream_buffer.c"
+#include "semphr.h"
+#include "message_buffer.h"
+
+// Project Includes, the channel is built into this file
+#include "message_handler.h"
+#include "spsc_channel.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_NUM_SERIAL_PORTS          2
+#define BENCH_SOURCE_MODEM              BENCH_NUM_SERIAL_PORTS
+#define BENCH_NUM_SOURCES               (BENCH_NUM_SERIAL_PORTS + 1)
+
+// Messages each source holds, as the message handler's defaults
+#define BENCH_ITEMS_PER_SOURCE          5
+
+// Modem messages are stored behind their length, as in the message handler
+#define BENCH_MODEM_MSG_BYTES           (sizeof(benchStampedMsg_t) + sizeof(size_t))
+
+// Time the task takes to handle a message, and how serial port 1's bursts are spaced
+#define BENCH_SERVICE_US                50
+#define BENCH_BURST_LENGTH              4
+#define BENCH_BURST_GAP_US              10
+
+// Notification indexes, as the message handler uses them in each way
+#define BENCH_NOTIFY_SERIAL_MSG_RX      1
+#define BENCH_NOTIFY_MODEM_MSG_RX       2
+#define BENCH_NOTIFY_WAKE               1
+#define BENCH_NOTIFY_BIT(index)         ((UBaseType_t)1 << (index))
+
+#define BENCH_MAX_MESSAGES              1000000
+#define BENCH_CHECK_MESSAGES            2000
+
+// More than the sources can hold, the modem buffer holds more short messages than long ones
+#define BENCH_MAX_WAITING               64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_TIME_UNIT                 "cycles"
+#else
+#define BENCH_TIME_UNIT                 "ns"
+#endif
+
+typedef enum
+{
+    E_WAY_DRAIN = 0,
+    E_WAY_SET,
+    E_WAY_ORDERED,
+    E_NUM_WAYS
+}benchWay_t;
+
+/* ****************************   Structures   **************************** */
+
+// A message as the sources hold it, the ordered way stamps it with its arrival. The first bytes of
+// the data are the message's index in the load.
+typedef struct
+{
+    uint32_t arrival;
+    msgData_t data;
+}benchStampedMsg_t;
+
+typedef struct
+{
+    uint64_t time;                  // Virtual time it arrives
+    uint8_t source;
+    uint8_t length;                 // Bytes of data the modem sends
+    bool waiting;                   // Held by its source and not yet handled
+}benchMsg_t;
+
+typedef struct
+{
+    uint32_t num_handled;
+    uint32_t num_dropped;
+    uint64_t total_wait;
+    uint64_t max_wait;
+    uint32_t num_out_of_order;      // Handled while a message that arrived before it was waiting
+}benchSourceStats_t;
+
+typedef struct
+{
+    benchSourceStats_t sources[BENCH_NUM_SOURCES];
+    uint32_t num_wakes;
+    uint32_t num_wait_calls;
+    uint64_t task_time;
+    uint64_t producer_time[BENCH_NUM_SOURCES];
+    bool failed;
+}benchStats_t;
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void benchTask(void *pvParameters);
+static void benchGenerateLoad(const int load_percent, const uint32_t num_msgs);
+static void benchRun(const benchWay_t way, benchStats_t *p_stats);
+static bool benchDrainPass(void);
+static bool benchSetPass(void);
+static bool benchOrderedPass(void);
+static bool benchOrderedHandleOldest(void);
+static bool benchArrivedBefore(const uint32_t arrival, const uint32_t other_arrival);
+static bool benchWaitForArrival(const bool would_block);
+static void benchDeliver(const uint64_t up_to);
+static void benchProduce(const uint32_t idx);
+static void benchHandle(const msgData_t *p_data);
+static int benchCheck(const long iterations);
+static int benchTime(const int load_percent, const uint32_t num_msgs);
+static uint64_t benchTimestamp(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static const char *way_names[E_NUM_WAYS] = {"drain", "set", "ordered"};
+static const char *source_names[BENCH_NUM_SOURCES] = {"Serial 1", "Serial 2", "Modem"};
+
+static benchMsg_t msgs[BENCH_MAX_MESSAGES];
+static uint32_t num_msgs_loaded = 0;
+
+// Run in progress
+static benchWay_t run_way;
+static benchStats_t *p_run_stats;
+static uint64_t clock_us = 0;
+static uint32_t next_msg = 0;
+static uint32_t waiting[BENCH_MAX_WAITING];
+static int num_waiting = 0;
+static uint64_t excluded_time = 0;
+
+static TaskHandle_t handler_task = NULL;
+static spscChannel_t serial_channels[BENCH_NUM_SERIAL_PORTS];
+static benchStampedMsg_t serial_storage[BENCH_NUM_SERIAL_PORTS][SPSC_CHANNEL_NUM_SLOTS(BENCH_ITEMS_PER_SOURCE)];
+static MessageBufferHandle_t modem_mb = NULL;
+static _Atomic uint32_t msg_arrivals;
+
+// The set way's semaphores
+static SemaphoreHandle_t serial_sems[BENCH_NUM_SERIAL_PORTS];
+static SemaphoreHandle_t modem_sem = NULL;
+static QueueSetHandle_t msg_set = NULL;
+
+// Modem messages as the modem task builds them and as the task takes them out
+static benchStampedMsg_t modem_msg_out;
+static benchStampedMsg_t modem_msg_in;
+static size_t modem_msg_in_len = 0;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    xTaskCreate(benchTask, "handler", configMINIMAL_STACK_SIZE, NULL, 1, &handler_task);
+    xNextTaskUnblockTime = portMAX_DELAY;
+
+    if((argc == 3) && (strcmp(argv[1], "check") == 0))
+    {
+        return benchCheck(atol(argv[2]));
+    }
+
+    if((argc == 4) && (strcmp(argv[1], "bench") == 0))
+    {
+        int load_percent = atoi(argv[2]);
+        long num_msgs = atol(argv[3]);
+        if((load_percent < 1) || (num_msgs < 1) || (num_msgs > BENCH_MAX_MESSAGES))
+        {
+            fprintf(stderr, "load must be at least 1%%, messages 1 to %d\n", BENCH_MAX_MESSAGES);
+            return 2;
+        }
+
+        return benchTime(load_percent, (uint32_t)num_msgs);
+    }
+
+    fprintf(stderr, "usage: %s check <iterations> | bench <load %%> <messages>\n", argv[0]);
+    return 2;
+}
+
+// Port and application functions the kernel calls
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+static void benchTask(void *pvParameters)
+{
+}
+
+// Messages arrive from each source at random, spaced evenly on average, serial port 1's in bursts.
+// The load is the share of the task's time the messages would take to handle.
+static void benchGenerateLoad(const int load_percent, const uint32_t num_msgs)
+{
+    // Mean time between messages of all sources, and each source's share of them
+    double mean_gap = (100.0 * BENCH_SERVICE_US) / load_percent;
+    const double shares[BENCH_NUM_SOURCES] = {0.5, 0.2, 0.3};
+    uint64_t next_time[BENCH_NUM_SOURCES];
+    uint64_t mean_source_gap[BENCH_NUM_SOURCES];
+    int burst_left = 0;
+
+    for(int source = 0; source < BENCH_NUM_SOURCES; source++)
+    {
+        mean_source_gap[source] = (uint64_t)(mean_gap / shares[source]);
+        if(source == 0)
+        {
+            mean_source_gap[source] *= BENCH_BURST_LENGTH;
+        }
+        next_time[source] = (uint64_t)rand() % ((2 * mean_source_gap[source]) + 1);
+    }
+
+    for(uint32_t idx = 0; idx < num_msgs; idx++)
+    {
+        int source = 0;
+        for(int other = 1; other < BENCH_NUM_SOURCES; other++)
+        {
+            if(next_time[other] < next_time[source])
+            {
+                source = other;
+            }
+        }
+
+        msgs[idx].time = next_time[source];
+        msgs[idx].source = (uint8_t)source;
+        msgs[idx].length = (uint8_t)(sizeof(uint32_t) + ((uint32_t)rand() % (MSG_DATA_MAX_SIZE - sizeof(uint32_t) + 1)));
+
+        if((source == 0) && (++burst_left < BENCH_BURST_LENGTH))
+        {
+            next_time[source] += BENCH_BURST_GAP_US;
+        }
+        else
+        {
+            burst_left = (source == 0) ? 0 : burst_left;
+            next_time[source] += 1 + ((uint64_t)rand() % (2 * mean_source_gap[source]));
+        }
+    }
+
+    num_msgs_loaded = num_msgs;
+}
+
+// Runs the loaded messages through one way of handling them, until every one is handled or dropped
+static void benchRun(const benchWay_t way, benchStats_t *p_stats)
+{
+    memset(p_stats, 0, sizeof(*p_stats));
+    for(uint32_t idx = 0; idx < num_msgs_loaded; idx++)
+    {
+        msgs[idx].waiting = false;
+    }
+
+    run_way = way;
+    p_run_stats = p_stats;
+    clock_us = 0;
+    next_msg = 0;
+    num_waiting = 0;
+    excluded_time = 0;
+    modem_msg_in_len = 0;
+    atomic_store(&msg_arrivals, 0);
+
+    // Objects are made anew for each run, the host heap is not short
+    UBaseType_t notify_index = (way == E_WAY_ORDERED) ? BENCH_NOTIFY_WAKE : BENCH_NOTIFY_SERIAL_MSG_RX;
+    for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+    {
+        spscChannelInit(&serial_channels[port], serial_storage[port], sizeof(benchStampedMsg_t),
+                        SPSC_CHANNEL_NUM_SLOTS(BENCH_ITEMS_PER_SOURCE), handler_task, notify_index);
+    }
+
+    // A message buffer keeps one byte of its storage free
+    modem_mb = xMessageBufferCreate((BENCH_ITEMS_PER_SOURCE * BENCH_MODEM_MSG_BYTES) + 1);
+
+    if(way == E_WAY_SET)
+    {
+        msg_set = xQueueCreateSet(BENCH_ITEMS_PER_SOURCE * BENCH_NUM_SOURCES);
+        for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+        {
+            serial_sems[port] = xSemaphoreCreateCounting(BENCH_ITEMS_PER_SOURCE, 0);
+            xQueueAddToSet(serial_sems[port], msg_set);
+        }
+
+        modem_sem = xSemaphoreCreateCounting(BENCH_ITEMS_PER_SOURCE, 0);
+        xQueueAddToSet(modem_sem, msg_set);
+    }
+
+    for(int idx = 0; idx < configTASK_NOTIFICATION_ARRAY_ENTRIES; idx++)
+    {
+        ulTaskNotifyValueClearIndexed(handler_task, idx, UINT32_MAX);
+        xTaskNotifyStateClearIndexed(handler_task, idx);
+    }
+
+    bool running = true;
+    uint64_t start = benchTimestamp();
+    while(running)
+    {
+        switch(way)
+        {
+            case E_WAY_DRAIN:
+                running = benchDrainPass();
+                break;
+
+            case E_WAY_SET:
+                running = benchSetPass();
+                break;
+
+            default:
+                running = benchOrderedPass();
+                break;
+        }
+    }
+    p_stats->task_time = benchTimestamp() - start - excluded_time;
+
+    if(way == E_WAY_SET)
+    {
+        for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+        {
+            xQueueRemoveFromSet(serial_sems[port], msg_set);
+            vSemaphoreDelete(serial_sems[port]);
+        }
+
+        xQueueRemoveFromSet(modem_sem, msg_set);
+        vSemaphoreDelete(modem_sem);
+        vQueueDelete(msg_set);
+    }
+    vMessageBufferDelete(modem_mb);
+
+    for(uint32_t idx = 0; idx < num_msgs_loaded; idx++)
+    {
+        if(msgs[idx].waiting)
+        {
+            p_stats->failed = true;
+        }
+    }
+}
+
+// The task as it was before the queue set, the serial channels notify it only when it is about to
+// block, and it empties them before the modem buffer
+static bool benchDrainPass(void)
+{
+    bool serial_idle = spscChannelPrepareToWait(&serial_channels[0]) &&
+                       spscChannelPrepareToWait(&serial_channels[1]);
+    bool nothing_pending = (pxCurrentTCB->ucNotifyState[BENCH_NOTIFY_SERIAL_MSG_RX] != taskNOTIFICATION_RECEIVED) &&
+                           (pxCurrentTCB->ucNotifyState[BENCH_NOTIFY_MODEM_MSG_RX] != taskNOTIFICATION_RECEIVED);
+    if(!benchWaitForArrival(serial_idle && nothing_pending))
+    {
+        return false;
+    }
+
+    UBaseType_t pending = uxTaskNotifyWaitAny(BENCH_NOTIFY_BIT(BENCH_NOTIFY_SERIAL_MSG_RX) |
+                                              BENCH_NOTIFY_BIT(BENCH_NOTIFY_MODEM_MSG_RX), 0);
+    p_run_stats->num_wakes++;
+    p_run_stats->num_wait_calls++;
+
+    if((pending & BENCH_NOTIFY_BIT(BENCH_NOTIFY_SERIAL_MSG_RX)) != 0)
+    {
+        ulTaskNotifyTakeIndexed(BENCH_NOTIFY_SERIAL_MSG_RX, pdTRUE, 0);
+        p_run_stats->num_wait_calls++;
+    }
+
+    for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+    {
+        benchStampedMsg_t *p_msg;
+        while((p_msg = spscChannelReadSlot(&serial_channels[port])) != NULL)
+        {
+            benchHandle(&p_msg->data);
+            spscChannelConsume(&serial_channels[port]);
+        }
+    }
+
+    if((pending & BENCH_NOTIFY_BIT(BENCH_NOTIFY_MODEM_MSG_RX)) != 0)
+    {
+        ulTaskNotifyTakeIndexed(BENCH_NOTIFY_MODEM_MSG_RX, pdTRUE, 0);
+        p_run_stats->num_wait_calls++;
+
+        while(xMessageBufferReceive(modem_mb, modem_msg_in.data.msg, sizeof(modem_msg_in.data.msg), 0) > 0)
+        {
+            benchHandle(&modem_msg_in.data);
+        }
+    }
+
+    return true;
+}
+
+// The task as it was with the queue set, one message per wake from the member the set hands back
+static bool benchSetPass(void)
+{
+    if(!benchWaitForArrival(uxQueueMessagesWaiting(msg_set) == 0))
+    {
+        return false;
+    }
+
+    QueueSetMemberHandle_t source = xQueueSelectFromSet(msg_set, 0);
+    p_run_stats->num_wakes++;
+    p_run_stats->num_wait_calls += 2;
+    if(xSemaphoreTake(source, 0) != pdTRUE)
+    {
+        return true;
+    }
+
+    if(source == modem_sem)
+    {
+        do
+        {
+            if(xMessageBufferReceive(modem_mb, modem_msg_in.data.msg, sizeof(modem_msg_in.data.msg), 0) == 0)
+            {
+                break;
+            }
+
+            benchHandle(&modem_msg_in.data);
+        }while(uxSemaphoreGetCount(modem_sem) == 0);
+    }
+    else
+    {
+        for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+        {
+            if(source == serial_sems[port])
+            {
+                benchStampedMsg_t *p_msg = spscChannelReadSlot(&serial_channels[port]);
+                benchHandle(&p_msg->data);
+                spscChannelConsume(&serial_channels[port]);
+            }
+        }
+    }
+
+    return true;
+}
+
+// The task as it is now, see msgHandlerTask()
+static bool benchOrderedPass(void)
+{
+    if(!benchOrderedHandleOldest() && spscChannelPrepareToWait(&serial_channels[0]) &&
+       spscChannelPrepareToWait(&serial_channels[1]))
+    {
+        if(!benchWaitForArrival(pxCurrentTCB->ulNotifiedValue[BENCH_NOTIFY_WAKE] == 0))
+        {
+            return false;
+        }
+
+        ulTaskNotifyTakeIndexed(BENCH_NOTIFY_WAKE, pdTRUE, 0);
+        p_run_stats->num_wakes++;
+        p_run_stats->num_wait_calls++;
+    }
+
+    return true;
+}
+
+// See msgHandleOldestMsg()
+static bool benchOrderedHandleOldest(void)
+{
+    if(modem_msg_in_len == 0)
+    {
+        size_t num_bytes = xMessageBufferReceive(modem_mb, &modem_msg_in, sizeof(modem_msg_in), 0);
+        if(num_bytes > offsetof(benchStampedMsg_t, data.msg))
+        {
+            modem_msg_in_len = num_bytes - offsetof(benchStampedMsg_t, data.msg);
+        }
+    }
+
+    benchStampedMsg_t *p_oldest = NULL;
+    int oldest_port = -1;
+    for(int port = 0; port < BENCH_NUM_SERIAL_PORTS; port++)
+    {
+        benchStampedMsg_t *p_serial = spscChannelReadSlot(&serial_channels[port]);
+        if((p_serial != NULL) && ((p_oldest == NULL) || benchArrivedBefore(p_serial->arrival, p_oldest->arrival)))
+        {
+            p_oldest = p_serial;
+            oldest_port = port;
+        }
+    }
+
+    if((modem_msg_in_len > 0) &&
+       ((p_oldest == NULL) || benchArrivedBefore(modem_msg_in.arrival, p_oldest->arrival)))
+    {
+        if(modem_msg_in_len < sizeof(modem_msg_in.data.msg))
+        {
+            modem_msg_in.data.msg[modem_msg_in_len] = '\0';
+        }
+
+        benchHandle(&modem_msg_in.data);
+        modem_msg_in_len = 0;
+        return true;
+    }
+
+    if(p_oldest != NULL)
+    {
+        benchHandle(&p_oldest->data);
+        spscChannelConsume(&serial_channels[oldest_port]);
+        return true;
+    }
+
+    return false;
+}
+
+static bool benchArrivedBefore(const uint32_t arrival, const uint32_t other_arrival)
+{
+    return (int32_t)(arrival - other_arrival) < 0;
+}
+
+// Stands in for the task blocking, if it would, by moving the clock on to the next message and
+// handing it over. Returns false once every message has been.
+static bool benchWaitForArrival(const bool would_block)
+{
+    if(!would_block)
+    {
+        return true;
+    }
+
+    if(next_msg == num_msgs_loaded)
+    {
+        return false;
+    }
+
+    uint64_t start = benchTimestamp();
+    clock_us = msgs[next_msg].time;
+    benchDeliver(clock_us);
+    excluded_time += benchTimestamp() - start;
+    return true;
+}
+
+// Hands over every message that has arrived by the given time, as their interrupts and the modem
+// task would have while the task was busy
+static void benchDeliver(const uint64_t up_to)
+{
+    while((next_msg < num_msgs_loaded) && (msgs[next_msg].time <= up_to))
+    {
+        benchProduce(next_msg++);
+    }
+}
+
+// A receive interrupt finishing a message, or the modem task sending one, in the way being run
+static void benchProduce(const uint32_t idx)
+{
+    benchMsg_t *p_msg = &msgs[idx];
+    bool sent = false;
+
+    uint64_t start = benchTimestamp();
+    if(p_msg->source < BENCH_NUM_SERIAL_PORTS)
+    {
+        spscChannel_t *p_chan = &serial_channels[p_msg->source];
+        benchStampedMsg_t *p_slot = spscChannelWriteSlot(p_chan);
+        if(p_slot != NULL)
+        {
+            memcpy(p_slot->data.msg, &idx, sizeof(idx));
+            if(run_way == E_WAY_ORDERED)
+            {
+                p_slot->arrival = atomic_fetch_add_explicit(&msg_arrivals, 1, memory_order_relaxed);
+            }
+
+            BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+            spscChannelPublishFromISR(p_chan, &xHigherPriorityTaskWoken);
+            if(run_way == E_WAY_SET)
+            {
+                xSemaphoreGiveFromISR(serial_sems[p_msg->source], &xHigherPriorityTaskWoken);
+            }
+            sent = true;
+        }
+    }
+    else
+    {
+        size_t num_bytes = offsetof(benchStampedMsg_t, data.msg) + p_msg->length;
+        modem_msg_out.arrival = atomic_fetch_add_explicit(&msg_arrivals, 1, memory_order_relaxed);
+        memcpy(modem_msg_out.data.msg, &idx, sizeof(idx));
+
+        // Only the ordered way keeps the stamp, the others send the data alone
+        const uint8_t *p_send = (const uint8_t *)&modem_msg_out;
+        if(run_way != E_WAY_ORDERED)
+        {
+            p_send += offsetof(benchStampedMsg_t, data.msg);
+            num_bytes -= offsetof(benchStampedMsg_t, data.msg);
+        }
+
+        if(xMessageBufferSend(modem_mb, p_send, num_bytes, 0) == num_bytes)
+        {
+            if(run_way == E_WAY_DRAIN)
+            {
+                xTaskNotifyGiveIndexed(handler_task, BENCH_NOTIFY_MODEM_MSG_RX);
+            }
+            else if(run_way == E_WAY_SET)
+            {
+                xSemaphoreGive(modem_sem);
+            }
+            else
+            {
+                xTaskNotifyGiveIndexed(handler_task, BENCH_NOTIFY_WAKE);
+            }
+            sent = true;
+        }
+    }
+    p_run_stats->producer_time[p_msg->source] += benchTimestamp() - start;
+
+    if(sent)
+    {
+        p_msg->waiting = true;
+        waiting[num_waiting++] = idx;
+    }
+    else
+    {
+        p_run_stats->sources[p_msg->source].num_dropped++;
+    }
+}
+
+// The task handling a message, which takes it BENCH_SERVICE_US while more messages arrive
+static void benchHandle(const msgData_t *p_data)
+{
+    uint64_t start = benchTimestamp();
+
+    uint32_t idx;
+    memcpy(&idx, p_data->msg, sizeof(idx));
+    if((idx >= num_msgs_loaded) || !msgs[idx].waiting)
+    {
+        p_run_stats->failed = true;
+        excluded_time += benchTimestamp() - start;
+        return;
+    }
+
+    benchMsg_t *p_msg = &msgs[idx];
+    benchSourceStats_t *p_source = &p_run_stats->sources[p_msg->source];
+    bool out_of_order = false;
+    for(int pos = 0; pos < num_waiting; pos++)
+    {
+        if(waiting[pos] == idx)
+        {
+            waiting[pos--] = waiting[--num_waiting];
+        }
+        else if(msgs[waiting[pos]].time < p_msg->time)
+        {
+            out_of_order = true;
+        }
+    }
+
+    p_msg->waiting = false;
+    p_source->num_handled++;
+    p_source->num_out_of_order += out_of_order ? 1 : 0;
+
+    uint64_t wait = clock_us - p_msg->time;
+    p_source->total_wait += wait;
+    if(wait > p_source->max_wait)
+    {
+        p_source->max_wait = wait;
+    }
+
+    clock_us += BENCH_SERVICE_US;
+    benchDeliver(clock_us);
+    excluded_time += benchTimestamp() - start;
+}
+
+static int benchCheck(const long iterations)
+{
+    long num_wrong = 0;
+    benchStats_t stats;
+
+    srand(1);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        int load_percent = 10 + (rand() % 140);
+        benchGenerateLoad(load_percent, BENCH_CHECK_MESSAGES);
+
+        for(int way = 0; way < E_NUM_WAYS; way++)
+        {
+            benchRun((benchWay_t)way, &stats);
+
+            uint32_t num_accounted = 0;
+            uint32_t num_out_of_order = 0;
+            for(int source = 0; source < BENCH_NUM_SOURCES; source++)
+            {
+                num_accounted += stats.sources[source].num_handled + stats.sources[source].num_dropped;
+                num_out_of_order += stats.sources[source].num_out_of_order;
+            }
+
+            if(stats.failed || (num_accounted != num_msgs_loaded) ||
+               ((way == E_WAY_ORDERED) && (num_out_of_order != 0)))
+            {
+                if(num_wrong++ < 5)
+                {
+                    printf("%s at %d%% load: %u of %u messages accounted for, %u out of order%s\n",
+                           way_names[way], load_percent, num_accounted, num_msgs_loaded, num_out_of_order,
+                           stats.failed ? ", lost or handled twice" : "");
+                }
+            }
+        }
+    }
+
+    printf("%ld iterations, %ld wrong\n", iterations, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchTime(const int load_percent, const uint32_t num_msgs)
+{
+    benchStats_t stats;
+
+    srand(1);
+    benchGenerateLoad(load_percent, num_msgs);
+    printf("%u messages at %d%% load, %d us each\n", num_msgs, load_percent, BENCH_SERVICE_US);
+
+    for(int way = 0; way < E_NUM_WAYS; way++)
+    {
+        benchRun((benchWay_t)way, &stats);
+
+        printf("\n%s: %.2f wait calls per wake\n", way_names[way],
+               (double)stats.num_wait_calls / (stats.num_wakes ? stats.num_wakes : 1));
+        printf("  %-9s %8s %8s %10s %8s %12s %14s\n", "source", "handled", "dropped", "mean us", "max us",
+               "out of order", "producer " BENCH_TIME_UNIT);
+
+        uint32_t total_handled = 0;
+        for(int source = 0; source < BENCH_NUM_SOURCES; source++)
+        {
+            benchSourceStats_t *p_source = &stats.sources[source];
+            uint32_t num_sent = p_source->num_handled + p_source->num_dropped;
+            total_handled += p_source->num_handled;
+            printf("  %-9s %8u %8u %10.1f %8lu %12u %14.1f\n", source_names[source], p_source->num_handled,
+                   p_source->num_dropped, (double)p_source->total_wait / (p_source->num_handled ? p_source->num_handled : 1),
+                   (unsigned long)p_source->max_wait, p_source->num_out_of_order,
+                   (double)stats.producer_time[source] / (num_sent ? num_sent : 1));
+        }
+
+        printf("  task " BENCH_TIME_UNIT " per message %.1f\n",
+               (double)stats.task_time / (total_handled ? total_handled : 1));
+    }
+
+    return 0;
+}
+
+static uint64_t benchTimestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + now.tv_nsec;
+#endif
+}
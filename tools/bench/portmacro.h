@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  portmacro.h
+//
+//  Host Benchmark Port
+//
+//  Just enough of a port for the host benchmarks in tools/bench to compile the kernel sources.
+//  Nothing runs concurrently on the host, so critical sections and yields do nothing and no task
+//  is ever switched to.
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define portCHAR                                char
+#define portFLOAT                               float
+#define portDOUBLE                              double
+#define portLONG                                long
+#define portSHORT                               short
+#define portSTACK_TYPE                          uint32_t
+#define portBASE_TYPE                           long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define portMAX_DELAY                           ((TickType_t)0xffffffffUL)
+#define portTICK_TYPE_IS_ATOMIC                 1
+#define portSTACK_GROWTH                        (-1)
+#define portTICK_PERIOD_MS                      ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT                      8
+#define portPOINTER_SIZE_TYPE                   uintptr_t
+
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+
+#define portYIELD()
+#define portYIELD_WITHIN_API()
+#define portYIELD_FROM_ISR(x)                   (void)(x)
+#define portEND_SWITCHING_ISR(x)                (void)(x)
+#define portENTER_CRITICAL()                    vPortEnterCritical()
+#define portEXIT_CRITICAL()                     vPortExitCritical()
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+#define portSET_INTERRUPT_MASK_FROM_ISR()       0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)    (void)(x)
+#define portNOP()
+#define portMEMORY_BARRIER()
+
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters)    void vFunction(void *pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters)          void vFunction(void *pvParameters)
+
+#define portRECORD_READY_PRIORITY(uxPriority, uxReadyPriorities)    (uxReadyPriorities) |= (1UL << (uxPriority))
+#define portRESET_READY_PRIORITY(uxPriority, uxReadyPriorities)     (uxReadyPriorities) &= ~(1UL << (uxPriority))
+#define portGET_HIGHEST_PRIORITY(uxTopPriority, uxReadyPriorities)  \
+    uxTopPriority = (31UL - (uint32_t)__builtin_clz((uxReadyPriorities)))
+
+#endif /* PORTMACRO_H */
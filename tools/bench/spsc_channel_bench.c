@@ -0,0 +1,471 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  spsc_channel_bench.c
+//
+//  SPSC Channel Benchmark
+//
+//  Runs src/spsc_channel.c on the host, with the kernel's task and queue modules and without ever
+//  switching to a task, to compare a receive interrupt handing a finished message to its task
+//  through the channel with handing it over by xQueueSendFromISR(), as the serial ports did before
+//  the channel. The consumer task is blocked by placing it where its own wait would, with it
+//  posing as the running task.
+//
+//  check <iterations>           Publishes, drops, reads and waits at random and fails if the items
+//                               read differ from those published, if the channel is found full or
+//                               empty when it isn't, or if the task is notified other than once
+//                               for each time it said it was about to block.
+//  bench <iterations>           Times the interrupt that ends a message, from entry to exit, with
+//                               the task running and with it blocked waiting for the message: the
+//                               average and 99.9th percentile, in cycles on x86 hosts and ns
+//                               elsewhere.
+//
+//  Build from the root of the repository:
+//      gcc -O2 -Itools/bench -Ilibs/FreeRTOS/include -Ilibs/FreeRTOS -Iinc -Isrc
+//          tools/bench/spsc_channel_bench.c -o spsc_channel_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// FreeRTOS Includes, the kernel modules are built into this file so their private functions and
+// data can be used directly
+#include "tasks.c"
+#include "list.c"
+#include "queue.c"
+#include "timers.c"
+
+// Project Includes, the channel is built into this file
+#include "message_handler.h"
+#include "spsc_channel.c"
+
+/* ***************************   Definitions   **************************** */
+
+// Messages the channel and the queue hold, as the serial ports' defaults
+#define BENCH_NUM_ITEMS                 5
+
+#define BENCH_NOTIFY_INDEX              1
+
+#define BENCH_MAX_ITERATIONS            10000000
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BENCH_TIME_UNIT                 "cycles"
+#else
+#define BENCH_TIME_UNIT                 "ns"
+#endif
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void benchTask(void *pvParameters);
+static void benchCreateTasks(void);
+static void benchBlockOnChannel(void);
+static void benchBlockOnQueue(void);
+static bool benchConsumerNotified(void);
+static void benchChannelIsr(const char last_byte);
+static void benchQueueIsr(const char last_byte);
+static int benchCheck(const long iterations);
+static int benchTime(const long iterations);
+static void benchReport(const char *p_name, uint32_t *p_times, const long iterations);
+static int benchCompareTimes(const void *p_a, const void *p_b);
+static uint64_t benchTimestamp(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static spscChannel_t channel;
+static msgData_t channel_storage[SPSC_CHANNEL_NUM_SLOTS(BENCH_NUM_ITEMS)];
+static QueueHandle_t queue = NULL;
+
+static TCB_t *consumer_task;
+
+// Stands in as the running task while the consumer is blocked
+static TCB_t *idle_task;
+
+// Where a receive interrupt using the queue builds its message before sending it
+static msgData_t isr_msg;
+
+static uint32_t *p_isr_times;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if(argc != 3)
+    {
+        fprintf(stderr, "usage: %s check|bench <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    long iterations = atol(argv[2]);
+    if((iterations < 1) || (iterations > BENCH_MAX_ITERATIONS))
+    {
+        fprintf(stderr, "iterations must be 1 to %d\n", BENCH_MAX_ITERATIONS);
+        return 2;
+    }
+
+    benchCreateTasks();
+    return (strcmp(argv[1], "check") == 0) ? benchCheck(iterations) : benchTime(iterations);
+}
+
+// Port and application functions the kernel calls
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
+
+StackType_t *pxPortInitialiseStack(StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters)
+{
+    return pxTopOfStack;
+}
+
+BaseType_t xPortStartScheduler(void)
+{
+    return pdFALSE;
+}
+
+void vPortEndScheduler(void)
+{
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+static void benchTask(void *pvParameters)
+{
+}
+
+static void benchCreateTasks(void)
+{
+    TaskHandle_t handle;
+
+    xTaskCreate(benchTask, "idle", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, &handle);
+    idle_task = handle;
+    xTaskCreate(benchTask, "consumer", configMINIMAL_STACK_SIZE, NULL, 2, &handle);
+    consumer_task = handle;
+
+    spscChannelInit(&channel, channel_storage, sizeof(msgData_t), SPSC_CHANNEL_NUM_SLOTS(BENCH_NUM_ITEMS),
+                    consumer_task, BENCH_NOTIFY_INDEX);
+    queue = xQueueCreate(BENCH_NUM_ITEMS, sizeof(msgData_t));
+
+    pxCurrentTCB = consumer_task;
+    xNextTaskUnblockTime = portMAX_DELAY;
+}
+
+// Blocks the consumer as its task does on an empty channel, the first half of
+// ulTaskNotifyTakeIndexed() with nothing pending
+static void benchBlockOnChannel(void)
+{
+    pxCurrentTCB = consumer_task;
+    bool can_block = spscChannelPrepareToWait(&channel);
+    assert(can_block);
+
+    consumer_task->ucNotifyState[BENCH_NOTIFY_INDEX] = taskWAITING_NOTIFICATION;
+    prvAddCurrentTaskToDelayedList(portMAX_DELAY, pdTRUE);
+    pxCurrentTCB = idle_task;
+}
+
+// Blocks the consumer as xQueueReceive() does on an empty queue
+static void benchBlockOnQueue(void)
+{
+    Queue_t *pxQueue = (Queue_t *)queue;
+
+    pxCurrentTCB = consumer_task;
+    vTaskPlaceOnEventList(&(pxQueue->xTasksWaitingToReceive), portMAX_DELAY);
+    pxCurrentTCB = idle_task;
+}
+
+// Takes the consumer's notification as its wait would, returns whether there was one
+static bool benchConsumerNotified(void)
+{
+    bool notified = (consumer_task->ulNotifiedValue[BENCH_NOTIFY_INDEX] != 0);
+    consumer_task->ulNotifiedValue[BENCH_NOTIFY_INDEX] = 0;
+    consumer_task->ucNotifyState[BENCH_NOTIFY_INDEX] = taskNOT_WAITING_NOTIFICATION;
+    pxCurrentTCB = consumer_task;
+    return notified;
+}
+
+// The receive interrupt for the last byte of a message, see UART_Receive() in message_handler.c
+static void benchChannelIsr(const char last_byte)
+{
+    msgData_t *p_data = spscChannelWriteSlot(&channel);
+    if(p_data == NULL)
+    {
+        spscChannelDropFromISR(&channel);
+        return;
+    }
+
+    p_data->msg[MSG_DATA_MAX_SIZE - 1] = last_byte;
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    spscChannelPublishFromISR(&channel, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+// The same interrupt as it was with the message built in a buffer of its own and then queued
+static void benchQueueIsr(const char last_byte)
+{
+    isr_msg.msg[MSG_DATA_MAX_SIZE - 1] = last_byte;
+
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xQueueSendFromISR(queue, &isr_msg, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+static int benchCheck(const long iterations)
+{
+    long num_wrong = 0;
+    uint32_t next_sent = 0;
+    uint32_t next_read = 0;
+    uint32_t num_dropped = 0;
+    bool blocked = false;
+
+    srand(1);
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        uint32_t num_items = next_sent - next_read;
+        bool wrong = false;
+
+        switch(rand() % 4)
+        {
+            case 0:
+            case 1:
+            {
+                // An interrupt finishes a message
+                msgData_t *p_slot = spscChannelWriteSlot(&channel);
+                if((p_slot == NULL) != (num_items == BENCH_NUM_ITEMS))
+                {
+                    wrong = true;
+                }
+
+                if(p_slot == NULL)
+                {
+                    spscChannelDropFromISR(&channel);
+                    num_dropped++;
+                    break;
+                }
+
+                memcpy(p_slot->msg, &next_sent, sizeof(next_sent));
+                next_sent++;
+
+                BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+                spscChannelPublishFromISR(&channel, &xHigherPriorityTaskWoken);
+
+                // Only the item that ends a wait notifies the task, and it makes the task ready
+                bool notified = (consumer_task->ucNotifyState[BENCH_NOTIFY_INDEX] == taskNOTIFICATION_RECEIVED);
+                if((notified != blocked) || (notified != (xHigherPriorityTaskWoken == pdTRUE)))
+                {
+                    wrong = true;
+                }
+
+                if(blocked)
+                {
+                    benchConsumerNotified();
+                    blocked = false;
+                }
+                break;
+            }
+
+            case 2:
+            {
+                // The task reads a message, it can only be running
+                if(blocked)
+                {
+                    break;
+                }
+
+                msgData_t *p_slot = spscChannelReadSlot(&channel);
+                if((p_slot == NULL) != (num_items == 0))
+                {
+                    wrong = true;
+                }
+
+                if(p_slot != NULL)
+                {
+                    uint32_t value;
+                    memcpy(&value, p_slot->msg, sizeof(value));
+                    wrong |= (value != next_read);
+                    spscChannelConsume(&channel);
+                    next_read++;
+                }
+                break;
+            }
+
+            default:
+                // The task waits, it only blocks on an empty channel
+                if(blocked)
+                {
+                    break;
+                }
+
+                if(num_items == 0)
+                {
+                    benchBlockOnChannel();
+                    blocked = true;
+                }
+                else if(spscChannelPrepareToWait(&channel))
+                {
+                    wrong = true;
+                }
+                break;
+        }
+
+        if(wrong && (num_wrong++ < 5))
+        {
+            printf("wrong at iteration %ld, %u items held\n", iter, num_items);
+        }
+    }
+
+    if(channel.num_dropped != num_dropped)
+    {
+        printf("%u drops counted, %u made\n", channel.num_dropped, num_dropped);
+        num_wrong++;
+    }
+
+    printf("%ld iterations, %u items, %u dropped, %ld wrong\n", iterations, next_sent, num_dropped, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchTime(const long iterations)
+{
+    p_isr_times = malloc(iterations * sizeof(uint32_t));
+    assert(p_isr_times != NULL);
+
+    // The task is running and takes each message before the next
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        uint64_t start = benchTimestamp();
+        benchChannelIsr('\n');
+        p_isr_times[iter] = (uint32_t)(benchTimestamp() - start);
+
+        spscChannelReadSlot(&channel);
+        spscChannelConsume(&channel);
+    }
+    benchReport("channel, task running", p_isr_times, iterations);
+
+    msgData_t msg;
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        uint64_t start = benchTimestamp();
+        benchQueueIsr('\n');
+        p_isr_times[iter] = (uint32_t)(benchTimestamp() - start);
+
+        xQueueReceive(queue, &msg, 0);
+    }
+    benchReport("queue, task running", p_isr_times, iterations);
+
+    // The task is blocked on the empty channel or queue, and the message readies it
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        benchBlockOnChannel();
+
+        uint64_t start = benchTimestamp();
+        benchChannelIsr('\n');
+        p_isr_times[iter] = (uint32_t)(benchTimestamp() - start);
+
+        benchConsumerNotified();
+        spscChannelReadSlot(&channel);
+        spscChannelConsume(&channel);
+    }
+    benchReport("channel, task blocked", p_isr_times, iterations);
+
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        benchBlockOnQueue();
+
+        uint64_t start = benchTimestamp();
+        benchQueueIsr('\n');
+        p_isr_times[iter] = (uint32_t)(benchTimestamp() - start);
+
+        pxCurrentTCB = consumer_task;
+        xQueueReceive(queue, &msg, 0);
+    }
+    benchReport("queue, task blocked", p_isr_times, iterations);
+
+    free(p_isr_times);
+    return 0;
+}
+
+static void benchReport(const char *p_name, uint32_t *p_times, const long iterations)
+{
+    uint64_t total = 0;
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        total += p_times[iter];
+    }
+
+    qsort(p_times, iterations, sizeof(p_times[0]), benchCompareTimes);
+    printf("%-22s %7.1f " BENCH_TIME_UNIT " average, %6lu 99.9%%\n", p_name, (double)total / iterations,
+           (unsigned long)p_times[(iterations * 999) / 1000]);
+}
+
+static int benchCompareTimes(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+    return (a > b) - (a < b);
+}
+
+static uint64_t benchTimestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000U) + now.tv_nsec;
+#endif
+}
@@ -0,0 +1,323 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+//  timer_wheel_bench.c
+//
+//  Software Timer Benchmark
+//
+//  Runs libs/FreeRTOS/timers.c on the host against a stand in tick count and timer queue, to
+//  compare the sorted timer lists with the timer wheel (configUSE_TIMER_WHEEL).
+//
+//  check <timers> <iterations>  Drives timers through random resets, period changes and stops
+//                               and fails if any callback runs at the wrong tick.
+//  bench <timers> <iterations>  Times resetting a random timer while <timers> are running, the
+//                               cost that grows with the number of timers on the sorted lists.
+//
+//  Build from the root of the repository, once with each setting of the wheel:
+//      gcc -O2 -DconfigUSE_TIMER_WHEEL=1 -Itools/bench -Ilibs/FreeRTOS/include -Ilibs/FreeRTOS
+//          tools/bench/timer_wheel_bench.c libs/FreeRTOS/list.c -o timer_wheel_bench
+//
+// The MIT License (MIT)
+//
+// Copyright (c) 2020, Thomas Bresson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+
+/* ***************************    Includes     **************************** */
+
+// Standard Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+// FreeRTOS Includes, the timer module is built into this file so its private functions can be
+// driven directly
+#include "timers.c"
+
+/* ***************************   Definitions   **************************** */
+
+#define BENCH_MAX_TIMERS                1000
+#define BENCH_QUEUE_LEN                 4096
+
+/* ****************************   Structures   **************************** */
+
+/* ***********************   Function Prototypes   ************************ */
+
+static void benchTimerCallback(TimerHandle_t timer);
+static void benchServiceTimers(void);
+static int benchCheck(const int num_timers, const long iterations);
+static int benchReset(const int num_timers, const long iterations);
+static double benchSeconds(void);
+
+/* ***********************   File Scope Variables   *********************** */
+
+static TickType_t tick_count;
+
+// Stand in for the timer command queue, and what the timer task last asked to block for
+static DaemonTaskMessage_t commands[BENCH_QUEUE_LEN];
+static unsigned int command_head;
+static unsigned int command_tail;
+static bool timer_task_blocked;
+static TickType_t block_ticks;
+static BaseType_t block_indefinitely;
+
+static TimerHandle_t timers[BENCH_MAX_TIMERS];
+static TickType_t timer_due[BENCH_MAX_TIMERS];
+static bool timer_active[BENCH_MAX_TIMERS];
+static long num_fired;
+static long num_wrong;
+
+/* *************************   Public  Functions   ************************ */
+
+int main(int argc, char **argv)
+{
+    if(argc != 4)
+    {
+        fprintf(stderr, "usage: %s check|bench <timers> <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    int num_timers = atoi(argv[2]);
+    long iterations = atol(argv[3]);
+    if((num_timers < 1) || (num_timers > BENCH_MAX_TIMERS))
+    {
+        fprintf(stderr, "timers must be 1 to %d\n", BENCH_MAX_TIMERS);
+        return 2;
+    }
+
+    printf("timer wheel %d: ", configUSE_TIMER_WHEEL);
+    return (strcmp(argv[1], "check") == 0) ? benchCheck(num_timers, iterations) : benchReset(num_timers, iterations);
+}
+
+// Kernel functions the timer module calls
+TickType_t xTaskGetTickCount(void)
+{
+    return tick_count;
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+    return pdTRUE;
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return taskSCHEDULER_RUNNING;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char * const pcName, const configSTACK_DEPTH_TYPE usStackDepth,
+                       void * const pvParameters, UBaseType_t uxPriority, TaskHandle_t * const pxCreatedTask)
+{
+    return pdPASS;
+}
+
+QueueHandle_t xQueueGenericCreate(const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType)
+{
+    return (QueueHandle_t)commands;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void * const pvItemToQueue, TickType_t xTicksToWait,
+                             const BaseType_t xCopyPosition)
+{
+    commands[command_tail++ % BENCH_QUEUE_LEN] = *(const DaemonTaskMessage_t *)pvItemToQueue;
+    return pdPASS;
+}
+
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void * const pvItemToQueue,
+                                    BaseType_t * const pxHigherPriorityTaskWoken, const BaseType_t xCopyPosition)
+{
+    return xQueueGenericSend(xQueue, pvItemToQueue, 0, xCopyPosition);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void * const pvBuffer, TickType_t xTicksToWait)
+{
+    if(command_head == command_tail)
+    {
+        return pdFAIL;
+    }
+
+    *(DaemonTaskMessage_t *)pvBuffer = commands[command_head++ % BENCH_QUEUE_LEN];
+    return pdPASS;
+}
+
+void vQueueWaitForMessageRestricted(QueueHandle_t xQueue, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely)
+{
+    timer_task_blocked = true;
+    block_ticks = xTicksToWait;
+    block_indefinitely = xWaitIndefinitely;
+}
+
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+void *pvPortMalloc(size_t xSize)
+{
+    return malloc(xSize);
+}
+
+void vPortFree(void *pv)
+{
+    free(pv);
+}
+
+void benchAssertFailed(const char *p_file, int line)
+{
+    printf("assert failed %s:%d\n", p_file, line);
+    exit(1);
+}
+
+/* *************************   Private Functions   ************************ */
+
+// Checks every expiry lands on its tick, and that a callback never runs for a stopped timer
+static void benchTimerCallback(TimerHandle_t timer)
+{
+    int idx = (int)(intptr_t)pvTimerGetTimerID(timer);
+    if(!timer_active[idx] || (timer_due[idx] != tick_count))
+    {
+        if(num_wrong++ < 5)
+        {
+            printf("timer %d fired at %u, due %u, active %d\n", idx, (unsigned)tick_count, (unsigned)timer_due[idx],
+                   timer_active[idx]);
+        }
+    }
+    num_fired++;
+
+    if(xTimerIsTimerActive(timer))
+    {
+        timer_due[idx] += xTimerGetPeriod(timer);
+    }
+    else
+    {
+        timer_active[idx] = false;
+    }
+}
+
+// One pass of the timer task's loop, without the blocking
+static void benchServiceTimers(void)
+{
+    BaseType_t list_empty;
+
+    timer_task_blocked = false;
+    TickType_t next_expire = prvGetNextExpireTime(&list_empty);
+    prvProcessTimerOrBlockTask(next_expire, list_empty);
+    prvProcessReceivedCommands();
+}
+
+static int benchCheck(const int num_timers, const long iterations)
+{
+    // Start just short of the tick count wrapping, so both sides of it are covered
+    srand(1);
+    tick_count = 0xFFFF0000U;
+    for(int idx = 0; idx < num_timers; idx++)
+    {
+        timers[idx] = xTimerCreate("bench", 1 + (rand() % 5000), rand() & 1, (void *)(intptr_t)idx,
+                                   benchTimerCallback);
+    }
+
+    long num_commands = 0;
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        if((rand() % 4) == 0)
+        {
+            int idx = rand() % num_timers;
+            int op = rand() % 4;
+            if(op == 3)
+            {
+                xTimerStop(timers[idx], 0);
+                timer_active[idx] = false;
+            }
+            else if(op == 2)
+            {
+                TickType_t period = 1 + (rand() % 70000);
+                xTimerChangePeriod(timers[idx], period, 0);
+                timer_active[idx] = true;
+                timer_due[idx] = tick_count + period;
+            }
+            else
+            {
+                xTimerReset(timers[idx], 0);
+                timer_active[idx] = true;
+                timer_due[idx] = tick_count + xTimerGetPeriod(timers[idx]);
+            }
+            num_commands++;
+            prvProcessReceivedCommands();
+        }
+
+        benchServiceTimers();
+
+        // Time only moves on while the timer task is blocked, and never past its next expiry
+        if(timer_task_blocked && (command_head == command_tail))
+        {
+            TickType_t ticks = 1 + (rand() % 40);
+            if(!block_indefinitely && (ticks > block_ticks))
+            {
+                ticks = block_ticks;
+            }
+            tick_count += ticks;
+        }
+    }
+
+    printf("%d timers, %ld commands, %ld fired, %ld wrong\n", num_timers, num_commands, num_fired, num_wrong);
+    return (num_wrong == 0) ? 0 : 1;
+}
+
+static int benchReset(const int num_timers, const long iterations)
+{
+    // Periods long enough that nothing expires while resetting
+    srand(2);
+    tick_count = 1000;
+    for(int idx = 0; idx < num_timers; idx++)
+    {
+        timers[idx] = xTimerCreate("bench", 100000 + (rand() % 100000), pdFALSE, (void *)(intptr_t)idx,
+                                   benchTimerCallback);
+        xTimerStart(timers[idx], 0);
+        prvProcessReceivedCommands();
+    }
+
+    double start = benchSeconds();
+    for(long iter = 0; iter < iterations; iter++)
+    {
+        xTimerReset(timers[rand() % num_timers], 0);
+        prvProcessReceivedCommands();
+    }
+    double end = benchSeconds();
+
+    printf("%d timers, reset and process %.1f ns\n", num_timers, (end - start) * 1e9 / iterations);
+    return 0;
+}
+
+static double benchSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + (now.tv_nsec * 1e-9);
+}
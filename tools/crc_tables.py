@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+##############################################################################
+#
+#  crc_tables.py
+#
+#  CRC Lookup Table Generator
+#
+#  Writes src/crc_tables.h, the slice-by-8 lookup tables used by src/crc.c. The tables are
+#  constant so they live in flash rather than being built into RAM at start up. Run again after
+#  changing a polynomial in crc.c.
+#
+#  Usage: crc_tables.py [output]
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2020, Thomas Bresson
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+##############################################################################
+
+import sys
+
+# Must match the definitions in src/crc.c
+CRC16_POLY = 0x1021
+CRC32_POLY_REFLECTED = 0xEDB88320
+
+# Most slices crc.c can be built for, the first CRC_SLICE_BY of them are compiled in
+MAX_SLICES = 8
+
+VALUES_PER_LINE = 8
+
+
+def build_tables():
+    crc16 = [[0] * 256 for _ in range(MAX_SLICES)]
+    crc32 = [[0] * 256 for _ in range(MAX_SLICES)]
+
+    for value in range(256):
+        c16 = value << 8
+        c32 = value
+        for _ in range(8):
+            c16 = ((c16 << 1) ^ CRC16_POLY) if (c16 & 0x8000) else (c16 << 1)
+            c16 &= 0xFFFF
+            c32 = ((c32 >> 1) ^ CRC32_POLY_REFLECTED) if (c32 & 1) else (c32 >> 1)
+        crc16[0][value] = c16
+        crc32[0][value] = c32
+
+    # Table k holds the CRC of each byte value followed by k zero bytes
+    for value in range(256):
+        for k in range(1, MAX_SLICES):
+            prev16 = crc16[k - 1][value]
+            prev32 = crc32[k - 1][value]
+            crc16[k][value] = ((prev16 << 8) & 0xFFFF) ^ crc16[0][prev16 >> 8]
+            crc32[k][value] = (prev32 >> 8) ^ crc32[0][prev32 & 0xFF]
+
+    return crc16, crc32
+
+
+def write_table(out, ctype, name, tables, digits):
+    out.write("static const %s %s[CRC_SLICE_BY][256] =\n{\n" % (ctype, name))
+    for k, table in enumerate(tables):
+        if k == 4:
+            out.write("#if (CRC_SLICE_BY == 8)\n")
+        out.write("    {\n")
+        for start in range(0, 256, VALUES_PER_LINE):
+            row = ", ".join("0x%0*X" % (digits, v) for v in table[start:start + VALUES_PER_LINE])
+            out.write("        %s,\n" % row)
+        out.write("    },\n")
+    out.write("#endif\n};\n")
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "src/crc_tables.h"
+    crc16, crc32 = build_tables()
+
+    with open(path, "w", newline="\n") as out:
+        out.write("// Generated by tools/crc_tables.py, do not edit\n")
+        out.write("//\n")
+        out.write("// Table k holds the CRC of each byte value followed by k zero bytes, so CRC_SLICE_BY bytes can\n")
+        out.write("// be folded in with independent lookups instead of a chain of dependent ones\n\n")
+        out.write("#ifndef CRC_TABLES_H\n#define CRC_TABLES_H\n\n")
+        write_table(out, "uint16_t", "crc16_table", crc16, 4)
+        out.write("\n")
+        write_table(out, "uint32_t", "crc32_table", crc32, 8)
+        out.write("\n#endif /* CRC_TABLES_H */\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+##############################################################################
+#
+#  mem_report.py
+#
+#  Static Memory Report
+#
+#  Every task, queue and timer is created in static storage, so the RAM the application needs is
+#  known once it is linked. This reads the GNU ld map file, linked with -Wl,-Map=<file> and built
+#  with -fdata-sections -ffunction-sections so each variable has its own section, and reports the
+#  RAM and flash used by each module and the largest variables. Task stacks, kernel object buffers
+#  and the queue tuner's arena all show up by name.
+#
+#  Run after the link as part of the build. Given a RAM limit it exits with an error when the
+#  image no longer fits, so growth is caught at build time rather than on the device.
+#
+#  Usage: mem_report.py <map file> [--ram-limit <bytes>] [--top <count>]
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2020, Thomas Bresson
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+##############################################################################
+
+import argparse
+import os
+import re
+import sys
+
+# Output sections the input sections are counted under, .data takes RAM and its initial values
+# take flash
+RAM_SECTIONS = (".data", ".bss", "COMMON")
+FLASH_SECTIONS = (".text", ".rodata", ".data")
+
+# An input section, either on one line or with its address, size and object on the next
+SECTION_RE = re.compile(r"^ (\.\S+|COMMON)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+))?\s*$")
+PLACEMENT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)\s*$")
+
+
+class Section:
+    def __init__(self, name, size, obj):
+        self.name = name
+        self.size = size
+        self.obj = obj
+
+    def kind(self):
+        for prefix in (".data", ".bss", ".text", ".rodata", "COMMON"):
+            if self.name == prefix or self.name.startswith(prefix + "."):
+                return prefix
+        return None
+
+    def symbol(self):
+        # Only known when each variable has its own section
+        kind = self.kind()
+        return self.name[len(kind) + 1:] if self.name != kind else None
+
+    def module(self):
+        # Objects pulled out of an archive are shown as the archive
+        obj = self.obj.split("(")[0]
+        return os.path.splitext(os.path.basename(obj))[0]
+
+
+def parse_map(lines):
+    sections = []
+    in_map = False
+    pending = None
+    for line in lines:
+        line = line.rstrip("\n")
+        if line.startswith("Linker script and memory map"):
+            in_map = True
+            continue
+        if not in_map:
+            continue
+
+        if pending is not None:
+            match = PLACEMENT_RE.match(line)
+            if match:
+                sections.append(Section(pending, int(match.group(2), 16), match.group(3)))
+            pending = None
+            continue
+
+        match = SECTION_RE.match(line)
+        if not match:
+            continue
+        if match.group(2) is None:
+            pending = match.group(1)
+        else:
+            sections.append(Section(match.group(1), int(match.group(3), 16), match.group(4)))
+
+    # Discarded and empty sections take no memory
+    return [section for section in sections if section.size > 0 and section.kind() is not None]
+
+
+def print_modules(sections):
+    ram = {}
+    flash = {}
+    for section in sections:
+        module = section.module()
+        if section.kind() in RAM_SECTIONS:
+            ram[module] = ram.get(module, 0) + section.size
+        if section.kind() in FLASH_SECTIONS:
+            flash[module] = flash.get(module, 0) + section.size
+
+    modules = sorted(set(ram) | set(flash), key=lambda module: (-ram.get(module, 0), module))
+    print("%-24s %8s %8s" % ("Module", "RAM", "Flash"))
+    for module in modules:
+        print("%-24s %8u %8u" % (module, ram.get(module, 0), flash.get(module, 0)))
+    print("%-24s %8u %8u" % ("Total", sum(ram.values()), sum(flash.values())))
+
+    return sum(ram.values())
+
+
+def print_variables(sections, count):
+    variables = [section for section in sections
+                 if section.kind() in RAM_SECTIONS and section.symbol() is not None]
+    variables.sort(key=lambda section: -section.size)
+
+    print("%-40s %-20s %8s" % ("Variable", "Module", "Bytes"))
+    for section in variables[:count]:
+        print("%-40s %-20s %8u" % (section.symbol(), section.module(), section.size))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Report static memory use from a linker map file")
+    parser.add_argument("map", help="map file written by the linker")
+    parser.add_argument("--ram-limit", type=int, help="fail when more RAM than this is used")
+    parser.add_argument("--top", type=int, default=20, help="number of variables to list")
+    args = parser.parse_args()
+
+    with open(args.map, errors="replace") as map_file:
+        sections = parse_map(map_file)
+
+    if not sections:
+        sys.exit("No input sections found, is this a GNU ld map file?")
+
+    total_ram = print_modules(sections)
+    print()
+    print_variables(sections, args.top)
+
+    if (args.ram_limit is not None) and (total_ram > args.ram_limit):
+        sys.exit("RAM use of %u bytes is over the limit of %u" % (total_ram, args.ram_limit))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+##############################################################################
+#
+#  stack_report.py
+#
+#  Task Stack Sizing Report
+#
+#  Works out the deepest each task's stack can get from the call graph the compiler writes when
+#  the firmware is built with -fcallgraph-info=su, one .ci file per source file, and recommends a
+#  stack size for each task. The depth of a task is the largest frame total down any path from its
+#  entry function, plus the context the kernel and the core save on the task's stack.
+#
+#  The call graph can't see everything. Functions calling themselves, frames sized at run time,
+#  calls through function pointers and functions with no .ci file, the C library included, are
+#  listed so their depth can be checked by hand. Library functions are given a depth with --extern.
+#
+#  With --capture the report also shows the deepest each stack has actually been, from serial
+#  output captured after sending "#STACK <port>", see rtStatsStackReport() in
+#  src/run_time_stats.c.
+#
+#  Usage: stack_report.py <ci file or directory> ... [--capture <capture>] [--extern <fn>=<bytes>]
+#                         [--margin <percent>]
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2020, Thomas Bresson
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+##############################################################################
+
+import argparse
+import os
+import re
+import sys
+
+# Each task by the name it is created with, as cut to configMAX_TASK_NAME_LEN, its entry function
+# and the functions it calls through function pointers
+TASKS = [
+    ("Modem Tas", "modemTask", []),
+    ("Message H", "msgHandlerTask", []),
+    ("Coroutine", "coroTask", ["eepromStreamExport", "eepromStreamImport"]),
+    ("IDLE", "prvIdleTask", []),
+    ("Tmr Svc", "prvTimerTask", ["rtStatsExtendCallback", "queueTunerTimerCallback"]),
+]
+
+# Saved on a task's stack when it is switched out on a Cortex-M4F using the FPU. The core stacks
+# 26 words, r0-r3, r12, lr, pc, xpsr and s0-s15 with the fpscr, and PendSV another 25, r4-r11,
+# lr and s16-s31. Interrupts run on the main stack so only ever add the core's part of this.
+CONTEXT_BYTES = 51 * 4
+
+# Callee placeholder the compiler uses for a call through a function pointer
+INDIRECT_CALL = "__indirect_call"
+
+NODE_RE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME_RE = re.compile(r'(\d+) bytes \(([a-z,]+)\)')
+SSTATS_RE = re.compile(r'^(.{10}) +(\d+)/(\d+) words$')
+
+
+class Function:
+    def __init__(self, name):
+        self.name = name
+        self.frame = None           # Bytes, None when no .ci file defines the function
+        self.dynamic = False        # Part of the frame is sized at run time
+        self.callees = set()
+
+
+def parse_ci(lines, functions):
+    for line in lines:
+        match = NODE_RE.match(line)
+        if match:
+            function = functions.setdefault(match.group(1), Function(match.group(1)))
+            frame = FRAME_RE.search(match.group(2).replace("\\n", " "))
+            if frame:
+                # Static functions of the same name in two files are merged, the larger frame wins
+                function.frame = max(function.frame or 0, int(frame.group(1)))
+                function.dynamic |= frame.group(2) != "static"
+            continue
+
+        match = EDGE_RE.match(line)
+        if match:
+            functions.setdefault(match.group(1), Function(match.group(1))).callees.add(match.group(2))
+            functions.setdefault(match.group(2), Function(match.group(2)))
+
+
+def find_ci_files(paths):
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, name) for name in names if name.endswith(".ci")]
+        else:
+            files.append(path)
+    return sorted(files)
+
+
+# Static functions are titled "<file>:<function>" in the call graph
+def resolve(functions, name):
+    if name in functions:
+        return name
+    matches = [title for title in functions if title.endswith(":" + name)]
+    return matches[0] if len(matches) == 1 else None
+
+
+def parse_capture(lines):
+    # Only the last #STACK report in the capture is used
+    measured = None
+    for line in lines:
+        line = line.rstrip("\r\n")
+        if line.startswith("SSTATS"):
+            measured = {}
+            continue
+
+        match = SSTATS_RE.match(line)
+        if match and (measured is not None):
+            measured[match.group(1).strip()] = (int(match.group(2)), int(match.group(3)))
+    return measured or {}
+
+
+class StackWalk:
+    def __init__(self, functions, externs, indirect):
+        self.functions = functions
+        self.externs = externs
+        self.indirect = indirect
+        self.depths = {}
+        self.recursive = set()
+        self.dynamic = set()
+        self.unknown = set()
+        self.indirect_calls = set()
+
+    # Deepest the stack gets below a call to a function, including its own frame
+    def depth(self, name, path=()):
+        if name in path:
+            self.recursive.add(name)
+            return 0
+        if name in self.depths:
+            return self.depths[name]
+
+        if name == INDIRECT_CALL:
+            self.indirect_calls.update(caller for caller in path[-1:])
+            return max([self.depth(callback, path) for callback in self.indirect] + [0])
+
+        function = self.functions.get(name)
+        if (function is None) or (function.frame is None):
+            if name in self.externs:
+                return self.externs[name]
+            self.unknown.add(name)
+            return 0
+
+        if function.dynamic:
+            self.dynamic.add(name)
+
+        path = path + (name,)
+        deepest = function.frame + max([self.depth(callee, path) for callee in function.callees] + [0])
+
+        # A depth found part way round a loop of calls is only a lower bound, so isn't kept
+        if not self.recursive.intersection(path):
+            self.depths[name] = deepest
+        return deepest
+
+
+def print_report(functions, externs, measured, margin):
+    print("%-10s %-22s %8s %8s %10s %12s" % ("Task", "Entry", "Static", "+Context", "Recommend", "Measured"))
+
+    for task, entry, callbacks in TASKS:
+        title = resolve(functions, entry)
+        if title is None:
+            print("%-10s %-22s not found" % (task, entry))
+            continue
+
+        callbacks = [resolve(functions, callback) or callback for callback in callbacks]
+        walk = StackWalk(functions, externs, callbacks)
+        static_bytes = walk.depth(title)
+        total_bytes = static_bytes + CONTEXT_BYTES
+        recommend_words = (total_bytes * (100 + margin) + 399) // 400
+
+        used = ""
+        if task in measured:
+            used = "%u/%u" % measured[task]
+        print("%-10s %-22s %8u %8u %10u %12s" % (task, entry, static_bytes, total_bytes, recommend_words, used))
+
+        for label, names in (("recursive", walk.recursive), ("dynamic frame", walk.dynamic),
+                             ("calls through pointer", walk.indirect_calls), ("no call graph", walk.unknown)):
+            if names:
+                print("%-10s   %s: %s" % ("", label, " ".join(sorted(names))))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Recommend task stack sizes from the compiler's call graph")
+    parser.add_argument("ci", nargs="+", help=".ci files written by -fcallgraph-info=su, or directories of them")
+    parser.add_argument("--capture", help="serial output holding a #STACK report")
+    parser.add_argument("--extern", action="append", default=[], metavar="FN=BYTES",
+                        help="stack used by a function with no call graph, such as a library function")
+    parser.add_argument("--margin", type=int, default=25, help="percent added to the static depth")
+    args = parser.parse_args()
+
+    functions = {}
+    for path in find_ci_files(args.ci):
+        with open(path, errors="replace") as ci_file:
+            parse_ci(ci_file, functions)
+
+    if not functions:
+        sys.exit("No call graph found, was the firmware built with -fcallgraph-info=su?")
+
+    externs = {}
+    for extern in args.extern:
+        name, _, size = extern.partition("=")
+        externs[name] = int(size)
+
+    measured = {}
+    if args.capture:
+        with open(args.capture, errors="replace") as capture:
+            measured = parse_capture(capture)
+
+    print_report(functions, externs, measured, args.margin)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,392 @@
+#!/usr/bin/env python3
+##############################################################################
+#
+#  trace_decode.py
+#
+#  Trace Recorder Decoder
+#
+#  Turns a trace recorder dump, captured from a serial port after sending "#TRACE <port>", back
+#  into a timeline and per-object wait times. The dump format is described with traceRecDump() in
+#  src/trace_recorder.c, the event numbers with traceRecEventType_t in inc/trace_recorder.h.
+#
+#  A wait starts when a task blocks on a queue, stream buffer or notification and ends when the
+#  task is next switched in. It is split into the time spent blocked, up to the task being made
+#  ready, and the time spent ready, waiting for the CPU.
+#
+#  With --latency each item sent to a queue or semaphore is matched with its receive, oldest first,
+#  to show how long items waited and how many items of the other queues overtook them, sent later
+#  but received first. Naming queues, e.g. --latency "Modem TX", limits the report to them.
+#
+#  Usage: trace_decode.py <capture> [--timeline] [--stats] [--latency [<queue> ...]]
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2020, Thomas Bresson
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+##############################################################################
+
+import argparse
+import sys
+import zlib
+
+# Object classes, traceRecClass_t
+CLASS_TASK = 0
+CLASS_QUEUE = 1
+CLASS_STREAM = 2
+CLASS_ISR = 3
+CLASS_STAGE = 4
+
+CLASS_NAMES = {CLASS_TASK: "task", CLASS_QUEUE: "queue", CLASS_STREAM: "stream",
+               CLASS_ISR: "isr", CLASS_STAGE: "stage"}
+
+# Event types in traceRecEventType_t order, each with the class of its object
+EVENTS = [
+    ("NONE", None),
+    ("TASK_CREATE", CLASS_TASK),
+    ("TASK_SWITCHED_IN", CLASS_TASK),
+    ("TASK_READY", CLASS_TASK),
+    ("TASK_NOTIFY", CLASS_TASK),
+    ("TASK_NOTIFY_FROM_ISR", CLASS_TASK),
+    ("TASK_NOTIFY_BLOCK", CLASS_TASK),
+    ("QUEUE_SEND", CLASS_QUEUE),
+    ("QUEUE_SEND_FAILED", CLASS_QUEUE),
+    ("QUEUE_SEND_FROM_ISR", CLASS_QUEUE),
+    ("QUEUE_SEND_FROM_ISR_FAILED", CLASS_QUEUE),
+    ("QUEUE_RECEIVE", CLASS_QUEUE),
+    ("QUEUE_RECEIVE_FAILED", CLASS_QUEUE),
+    ("QUEUE_RECEIVE_FROM_ISR", CLASS_QUEUE),
+    ("QUEUE_RECEIVE_FROM_ISR_FAILED", CLASS_QUEUE),
+    ("QUEUE_BLOCK_SEND", CLASS_QUEUE),
+    ("QUEUE_BLOCK_RECEIVE", CLASS_QUEUE),
+    ("STREAM_SEND", CLASS_STREAM),
+    ("STREAM_SEND_FROM_ISR", CLASS_STREAM),
+    ("STREAM_RECEIVE", CLASS_STREAM),
+    ("STREAM_RECEIVE_FROM_ISR", CLASS_STREAM),
+    ("STREAM_BLOCK_SEND", CLASS_STREAM),
+    ("STREAM_BLOCK_RECEIVE", CLASS_STREAM),
+    ("ISR_ENTER", CLASS_ISR),
+    ("ISR_EXIT", CLASS_ISR),
+    ("STAGE", CLASS_STAGE),
+]
+
+EVT = {name: number for number, (name, _) in enumerate(EVENTS)}
+
+# Blocking events and the direction of the wait they start
+BLOCKING = {
+    EVT["QUEUE_BLOCK_SEND"]: "send",
+    EVT["QUEUE_BLOCK_RECEIVE"]: "receive",
+    EVT["STREAM_BLOCK_SEND"]: "send",
+    EVT["STREAM_BLOCK_RECEIVE"]: "receive",
+    EVT["TASK_NOTIFY_BLOCK"]: "notify",
+}
+
+# Events that put an item in a queue, or give a semaphore, and take it out again
+SENDS = (EVT["QUEUE_SEND"], EVT["QUEUE_SEND_FROM_ISR"])
+RECEIVES = (EVT["QUEUE_RECEIVE"], EVT["QUEUE_RECEIVE_FROM_ISR"])
+
+# Events that end a wait without the task getting what it waited for
+TIMEOUTS = {
+    EVT["QUEUE_SEND_FAILED"]: "send",
+    EVT["QUEUE_RECEIVE_FAILED"]: "receive",
+}
+
+
+class Dump:
+    def __init__(self):
+        self.counter_hz = 0
+        self.num_lost = 0
+        self.symbols = {}
+        self.records = []
+        self.crc_ok = False
+
+
+class Event:
+    def __init__(self, time, event_type, obj, value):
+        self.time = time
+        self.type = event_type
+        self.obj = obj
+        self.value = value
+
+
+class WaitStats:
+    def __init__(self):
+        self.num_waits = 0
+        self.num_timeouts = 0
+        self.blocked = []
+        self.ready = []
+
+
+def parse_dump(lines):
+    """Returns the last complete dump in a capture, other output around it is skipped."""
+    dump = None
+    current = None
+    crc = 0
+    for raw_line in lines:
+        line = raw_line.rstrip("\r\n")
+        fields = line.split()
+        if not fields:
+            continue
+
+        if fields[0] == "TRACE" and len(fields) == 4:
+            current = Dump()
+            current.counter_hz = int(fields[1])
+            current.num_lost = int(fields[3])
+            crc = 0
+        elif current is None:
+            continue
+        elif fields[0] == "SYM" and len(fields) >= 4:
+            current.symbols[(int(fields[1]), int(fields[2]))] = line.split(None, 3)[3]
+        elif fields[0] == "EVT":
+            for word in fields[1:]:
+                current.records.append((int(word[:8], 16), int(word[8:], 16)))
+        elif fields[0] == "END" and len(fields) == 2:
+            current.crc_ok = (crc == int(fields[1], 16))
+            dump = current
+            current = None
+            continue
+        else:
+            continue
+
+        crc = zlib.crc32((line + "\n").encode(), crc)
+
+    return dump
+
+
+def unwrap(dump):
+    """Turns the wrapping 32 bit timestamps into times in microseconds from the first event.
+    Writers interrupted between claiming a slot and reading the counter can leave neighbouring
+    events slightly out of order, so steps back of less than half the counter range are kept and
+    the events sorted afterwards."""
+    events = []
+    ticks = 0
+    prev = None
+    for timestamp, header in dump.records:
+        event_type = header & 0xFF
+        if event_type == 0 or event_type >= len(EVENTS):
+            continue
+
+        if prev is not None:
+            step = (timestamp - prev) & 0xFFFFFFFF
+            if step >= 0x80000000:
+                step -= 0x100000000
+            ticks += step
+        prev = timestamp
+
+        events.append(Event(ticks * 1e6 / dump.counter_hz, event_type, (header >> 8) & 0xFF, header >> 16))
+
+    events.sort(key=lambda event: event.time)
+    return events
+
+
+def object_name(dump, obj_class, obj):
+    name = dump.symbols.get((obj_class, obj))
+    if name is None:
+        return "%s %u" % (CLASS_NAMES[obj_class], obj)
+    return name
+
+
+def print_timeline(dump, events):
+    running = None
+    isr_stack = []
+    for event in events:
+        name, obj_class = EVENTS[event.type]
+
+        if event.type == EVT["TASK_SWITCHED_IN"]:
+            running = event.obj
+        elif event.type == EVT["ISR_ENTER"]:
+            isr_stack.append(event.obj)
+
+        if isr_stack:
+            context = object_name(dump, CLASS_ISR, isr_stack[-1])
+        elif running is not None:
+            context = object_name(dump, CLASS_TASK, running)
+        else:
+            context = "-"
+
+        print("%14.3f  %-12s %-26s %-12s %u" % (event.time, context, name,
+                                                 object_name(dump, obj_class, event.obj), event.value))
+
+        if event.type == EVT["ISR_EXIT"] and isr_stack:
+            isr_stack.pop()
+
+
+def wait_stats(dump, events):
+    """Matches each task's blocking event with it being made ready and switched in again. The wait
+    is closed by the task's next operation, which also shows whether it timed out."""
+    stats = {}
+    waiting = {}
+    running = None
+    isr_depth = 0
+
+    def close(wait, timed_out):
+        entry = stats.setdefault(wait["key"], WaitStats())
+        entry.num_waits += 1
+        entry.num_timeouts += 1 if timed_out else 0
+        entry.blocked.append(wait["ready"] - wait["start"])
+        entry.ready.append(wait["switched"] - wait["ready"])
+
+    for event in events:
+        if event.type == EVT["ISR_ENTER"]:
+            isr_depth += 1
+            continue
+        if event.type == EVT["ISR_EXIT"]:
+            isr_depth = max(isr_depth - 1, 0)
+            continue
+
+        if event.type == EVT["TASK_READY"]:
+            wait = waiting.get(event.obj)
+            if wait is not None and wait["ready"] is None:
+                wait["ready"] = event.time
+            continue
+
+        if event.type == EVT["TASK_SWITCHED_IN"]:
+            running = event.obj
+            wait = waiting.get(running)
+            if wait is not None and wait["ready"] is not None and wait["switched"] is None:
+                wait["switched"] = event.time
+            continue
+
+        # Everything else is an operation by the running task, unless made from an interrupt
+        if running is None or isr_depth > 0:
+            continue
+
+        wait = waiting.get(running)
+        if event.type in BLOCKING:
+            key = (EVENTS[event.type][1], event.obj, BLOCKING[event.type])
+            if wait is not None and wait["key"] == key:
+                # Woken to find the item already taken and blocked again, still the same wait
+                wait["ready"] = None
+                wait["switched"] = None
+                continue
+            if wait is not None and wait["switched"] is not None:
+                close(wait, False)
+            waiting[running] = {"key": key, "start": event.time, "ready": None, "switched": None}
+        elif wait is not None and wait["switched"] is not None:
+            timed_out = (event.type in TIMEOUTS) and (wait["key"] == (CLASS_QUEUE, event.obj, TIMEOUTS[event.type]))
+            close(wait, timed_out)
+            del waiting[running]
+
+    for wait in waiting.values():
+        if wait["switched"] is not None:
+            close(wait, False)
+
+    return stats
+
+
+def print_stats(dump, events):
+    stats = wait_stats(dump, events)
+
+    print("%-12s %-8s %6s %8s %12s %12s %12s %12s" % ("Object", "Wait", "Waits", "Timeouts",
+                                                      "Blocked us", "Max us", "Ready us", "Max us"))
+    for (obj_class, obj, direction), entry in sorted(stats.items()):
+        if direction == "notify":
+            name = object_name(dump, CLASS_TASK, obj)
+        else:
+            name = object_name(dump, obj_class, obj)
+        print("%-12s %-8s %6u %8u %12.1f %12.1f %12.1f %12.1f" % (
+            name, direction, entry.num_waits, entry.num_timeouts,
+            sum(entry.blocked) / len(entry.blocked), max(entry.blocked),
+            sum(entry.ready) / len(entry.ready), max(entry.ready)))
+
+
+def item_latencies(dump, events, names):
+    """Pairs each send to a queue with the receive that took the item out, oldest first. A receive
+    with nothing sent in the capture, such as taking a mutex or an item sent before the oldest
+    event, is skipped."""
+    items = []
+    pending = {}
+    for event in events:
+        if (event.type not in SENDS) and (event.type not in RECEIVES):
+            continue
+        if names and (object_name(dump, CLASS_QUEUE, event.obj) not in names):
+            continue
+
+        if event.type in SENDS:
+            pending.setdefault(event.obj, []).append(event.time)
+        elif pending.get(event.obj):
+            items.append((event.obj, pending[event.obj].pop(0), event.time))
+
+    return items
+
+
+def print_latency(dump, events, names):
+    items = item_latencies(dump, events, names)
+    if not items:
+        print("No items sent and received in the capture")
+        return
+
+    # An item is overtaken by each item of another queue that was sent after it but received first
+    stats = {}
+    for obj, sent, received in items:
+        overtaken = sum(1 for other, other_sent, other_received in items
+                        if (other != obj) and (other_sent > sent) and (other_received < received))
+        entry = stats.setdefault(obj, {"latency": [], "overtaken": []})
+        entry["latency"].append(received - sent)
+        entry["overtaken"].append(overtaken)
+
+    print("%-12s %6s %12s %12s %10s %10s" % ("Queue", "Items", "Latency us", "Max us", "Overtaken", "Max"))
+    for obj, entry in sorted(stats.items()):
+        print("%-12s %6u %12.1f %12.1f %10u %10u" % (
+            object_name(dump, CLASS_QUEUE, obj), len(entry["latency"]),
+            sum(entry["latency"]) / len(entry["latency"]), max(entry["latency"]),
+            sum(entry["overtaken"]), max(entry["overtaken"])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a trace recorder dump")
+    parser.add_argument("capture", help="serial output holding a #TRACE dump, - for stdin")
+    parser.add_argument("--timeline", action="store_true", help="print every event")
+    parser.add_argument("--stats", action="store_true", help="print wait times per object")
+    parser.add_argument("--latency", nargs="*", metavar="QUEUE",
+                        help="print how long items waited in each queue, or only the queues named")
+    args = parser.parse_args()
+
+    if args.capture == "-":
+        dump = parse_dump(sys.stdin)
+    else:
+        with open(args.capture, errors="replace") as capture:
+            dump = parse_dump(capture)
+
+    if dump is None:
+        sys.exit("No complete trace dump found")
+
+    if not dump.crc_ok:
+        print("Warning: CRC mismatch, the capture is corrupt", file=sys.stderr)
+
+    events = unwrap(dump)
+    print("%u events over %.3f ms, %u older events overwritten" % (
+        len(events), (events[-1].time - events[0].time) / 1000 if events else 0, dump.num_lost))
+
+    # Both unless one was asked for
+    show_all = not args.timeline and not args.stats and (args.latency is None)
+    if args.timeline or show_all:
+        print()
+        print_timeline(dump, events)
+    if args.stats or show_all:
+        print()
+        print_stats(dump, events)
+    if args.latency is not None:
+        print()
+        print_latency(dump, events, args.latency)
+
+
+if __name__ == "__main__":
+    main()